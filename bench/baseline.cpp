@@ -0,0 +1,163 @@
+#include "baseline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "topology.hpp"
+
+namespace prime8_bench {
+
+namespace {
+
+std::string trim(std::string s) {
+  const size_t b = s.find_first_not_of(" \t\r\n");
+  const size_t e = s.find_last_not_of(" \t\r\n");
+  return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+std::string git_commit() {
+  if (const char* env = std::getenv("PRIME8_GIT_COMMIT")) return env;
+#if defined(PRIME8_SOURCE_DIR)
+  if (std::FILE* p = ::popen("git -C '" PRIME8_SOURCE_DIR "' describe --always --dirty 2>/dev/null",
+                             "r")) {
+    char buf[128] = {};
+    const bool got = std::fgets(buf, sizeof(buf), p) != nullptr;
+    ::pclose(p);
+    if (got && !trim(buf).empty()) return trim(buf);
+  }
+#endif
+  return "unknown";
+}
+
+std::string compiler() {
+#if defined(__clang__)
+  std::string c = "clang " __clang_version__;
+#elif defined(__GNUC__)
+  std::string c = "gcc " __VERSION__;
+#else
+  std::string c = "unknown";
+#endif
+#if defined(PRIME8_BUILD_TYPE)
+  c += " (" PRIME8_BUILD_TYPE ")";
+#endif
+  return trim(c);
+}
+
+std::vector<std::string> split_tabs(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream ss(line);
+  std::string f;
+  while (std::getline(ss, f, '\t')) fields.push_back(f);
+  return fields;
+}
+
+} // namespace
+
+const BuildInfo& build_info() {
+  static const BuildInfo info{git_commit(), compiler(), neon_parallel::cpu_model()};
+  return info;
+}
+
+// === File format ===
+
+bool write_baseline(const std::string& path, const Baseline& b) {
+  std::FILE* f = std::fopen(path.c_str(), "w");
+  if (!f) return false;
+  std::fprintf(f, "# prime8_bench baseline; compare with: prime8_bench --compare %s\n",
+               path.c_str());
+  std::fprintf(f, "format\t1\n");
+  std::fprintf(f, "commit\t%s\ncompiler\t%s\ncpu\t%s\ndate\t%s\n", b.build.commit.c_str(),
+               b.build.compiler.c_str(), b.build.cpu.c_str(), b.date.c_str());
+  std::fprintf(f, "warmup\t%d\nreps\t%d\nmin_sample_ms\t%g\npool\t%d\nthreads\t%u\nseed\t%llu\n",
+               b.warmup, b.reps, b.min_sample_ms, b.pool ? 1 : 0, b.threads,
+               static_cast<unsigned long long>(b.seed));
+  std::fprintf(f, "# sample\tkernel\tdataset\tn\tns per call...\n");
+  for (const BaselineRow& r : b.rows) {
+    std::fprintf(f, "sample\t%s\t%s\t%zu", r.kernel.c_str(), r.dataset.c_str(), r.n);
+    for (double ns : r.ns) std::fprintf(f, "\t%.1f", ns);
+    std::fprintf(f, "\n");
+  }
+  return std::fclose(f) == 0;
+}
+
+bool read_baseline(const std::string& path, Baseline& b, std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  b = Baseline{};
+  std::string line;
+  int format = 0;
+  for (int lineno = 1; std::getline(in, line); ++lineno) {
+    if (line.empty() || line[0] == '#') continue;
+    const std::vector<std::string> f = split_tabs(line);
+    const std::string& key = f[0];
+    const bool bad = key == "sample" ? f.size() < 5 : f.size() != 2;
+    if (bad) {
+      error = path + ":" + std::to_string(lineno) + ": malformed line";
+      return false;
+    }
+    if (key == "format") format = std::atoi(f[1].c_str());
+    else if (key == "commit") b.build.commit = f[1];
+    else if (key == "compiler") b.build.compiler = f[1];
+    else if (key == "cpu") b.build.cpu = f[1];
+    else if (key == "date") b.date = f[1];
+    else if (key == "warmup") b.warmup = std::atoi(f[1].c_str());
+    else if (key == "reps") b.reps = std::atoi(f[1].c_str());
+    else if (key == "min_sample_ms") b.min_sample_ms = std::strtod(f[1].c_str(), nullptr);
+    else if (key == "pool") b.pool = f[1] == "1";
+    else if (key == "threads") b.threads = static_cast<unsigned>(std::strtoul(f[1].c_str(), nullptr, 10));
+    else if (key == "seed") b.seed = std::strtoull(f[1].c_str(), nullptr, 10);
+    else if (key == "sample") {
+      BaselineRow r{f[1], f[2], std::strtoull(f[3].c_str(), nullptr, 10), {}};
+      for (size_t i = 4; i < f.size(); ++i) r.ns.push_back(std::strtod(f[i].c_str(), nullptr));
+      b.rows.push_back(std::move(r));
+    }
+    // Unknown keys are skipped so later versions can add fields.
+  }
+  if (format != 1) {
+    error = path + ": not a prime8_bench baseline (format " + std::to_string(format) + ")";
+    return false;
+  }
+  return true;
+}
+
+// === Statistics ===
+
+double mann_whitney_slower(const std::vector<double>& base, const std::vector<double>& current) {
+  const size_t n1 = base.size(), n2 = current.size(), n = n1 + n2;
+  if (!n1 || !n2) return 1.0;
+
+  // Rank the pooled samples, giving tied values their average rank.
+  std::vector<std::pair<double, bool>> pooled;  // (value, from current)
+  pooled.reserve(n);
+  for (double x : base) pooled.emplace_back(x, false);
+  for (double x : current) pooled.emplace_back(x, true);
+  std::sort(pooled.begin(), pooled.end());
+
+  double rank_sum = 0, tie_term = 0;
+  for (size_t i = 0; i < n;) {
+    size_t j = i;
+    while (j < n && pooled[j].first == pooled[i].first) ++j;
+    const double t = double(j - i);
+    const double rank = (i + 1 + j) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      if (pooled[k].second) rank_sum += rank;
+    }
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  const double u = rank_sum - double(n2) * (n2 + 1) / 2;
+  const double mean = double(n1) * n2 / 2;
+  const double var = double(n1) * n2 / 12 * ((n + 1) - tie_term / (double(n) * (n - 1)));
+  if (var <= 0) return 1.0;
+  const double z = (u - mean - 0.5) / std::sqrt(var);  // continuity-corrected
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+} // namespace prime8_bench
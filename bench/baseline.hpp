@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Stored prime8_bench results and the test used to compare a new run
+// against them.
+//
+// A baseline is a tab-separated text file: `key<TAB>value` header lines
+// (where and how it was measured) followed by one `sample` line per
+// kernel/dataset/size carrying every per-call time in nanoseconds, so the
+// comparison works on the raw distributions rather than on two medians.
+namespace prime8_bench {
+
+// Where a result came from: `git describe` of the source tree (or
+// $PRIME8_GIT_COMMIT), the compiler that built the bench, and the CPU model.
+struct BuildInfo {
+  std::string commit;
+  std::string compiler;
+  std::string cpu;
+};
+
+const BuildInfo& build_info();
+
+struct BaselineRow {
+  std::string kernel;
+  std::string dataset;
+  size_t n = 0;
+  std::vector<double> ns;   // per-call time of every sample
+};
+
+struct Baseline {
+  BuildInfo build;
+  std::string date;         // UTC, ISO 8601
+  int warmup = 2;
+  int reps = 15;
+  double min_sample_ms = 2.0;
+  bool pool = false;
+  unsigned threads = 1;
+  uint64_t seed = 42;
+  std::vector<BaselineRow> rows;
+};
+
+bool write_baseline(const std::string& path, const Baseline& b);
+
+// False with a message in `error` if the file is missing or malformed.
+bool read_baseline(const std::string& path, Baseline& b, std::string& error);
+
+// One-sided Mann-Whitney U test that `current` tends to be larger (slower)
+// than `base`. Returns the p-value from the normal approximation with tie
+// correction; fine from about 8 samples a side.
+double mann_whitney_slower(const std::vector<double>& base, const std::vector<double>& current);
+
+} // namespace prime8_bench
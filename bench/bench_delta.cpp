@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "delta.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+// Wheel-30 filtering of a sorted candidate list, from raw u64s versus the
+// neon_delta encoding:
+//   raw            filter_stream_u64_wheel_bitmap over the u64 array
+//   decode+filter  neon_delta::decode into a scratch array, then the raw kernel
+//   fused          neon_delta::filter_wheel_bitmap (never materialises values)
+// "read" is the input bytes each pass streams. On a bandwidth-bound machine
+// the fused pass should track the raw one per number while reading w/64 of
+// the bytes; where the kernel is compute-bound (e.g. an emulated NEON build)
+// the byte savings do not show up in the time.
+//
+//   ./build/bench_delta [N] [reps]
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace {
+
+template <class Fn>
+double best_ms(int reps, Fn&& fn) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    const auto t0 = bench_clock::now();
+    fn();
+    best = std::min(best,
+                    std::chrono::duration<double, std::milli>(bench_clock::now() - t0).count());
+  }
+  return best;
+}
+
+bool run(const char* name, const neon_mem::vector<uint64_t>& values, int reps) {
+  const size_t n = values.size();
+  neon_mem::vector<uint8_t> enc(neon_delta::encoded_bound(n));
+  enc.resize(neon_delta::encode(values.data(), n, enc.data()));
+  neon_delta::View view;
+  if (const char* err = neon_delta::open(enc.data(), enc.size(), view)) {
+    std::printf("%s: %s\n", name, err);
+    return false;
+  }
+
+  const size_t bytes = (n + 7) / 8;
+  neon_mem::vector<uint8_t> want(bytes + 8, 0), got(bytes + 8, 0);
+  neon_mem::vector<uint64_t> scratch(n, 0);
+  const auto raw = neon_wheel::filter_stream_u64_wheel_bitmap;
+
+  struct Row {
+    const char* name;
+    double ms;
+    size_t read;
+  } rows[] = {
+    {"raw", best_ms(reps, [&] { raw(values.data(), want.data(), n); }), n * 8},
+    {"raw (pool)",
+     best_ms(reps,
+             [&] { neon_parallel::parallel_filter_stream(raw, true, values.data(), want.data(), n); }),
+     n * 8},
+    {"decode+filter",
+     best_ms(reps, [&] {
+       neon_delta::decode(view, scratch.data());
+       raw(scratch.data(), got.data(), n);
+     }),
+     enc.size()},
+    {"fused", best_ms(reps, [&] { neon_delta::filter_wheel_bitmap(view, got.data()); }),
+     enc.size()},
+    {"fused (pool)",
+     best_ms(reps, [&] { neon_delta::parallel_filter_wheel_bitmap(view, got.data()); }),
+     enc.size()},
+  };
+
+  if (n % 8) want[bytes - 1] &= uint8_t((1u << (n % 8)) - 1);
+  const bool ok = std::memcmp(want.data(), got.data(), bytes) == 0;
+
+  std::printf("\n%s: %zu numbers, %.2f bits/value (%.1f MiB raw, %.1f MiB encoded)\n", name, n,
+              enc.size() * 8.0 / n, n * 8.0 / (1 << 20), enc.size() / double(1 << 20));
+  std::printf("%-16s %10s %10s %12s %10s\n", "method", "ms", "Mnum/s", "read MiB", "GB/s");
+  for (const Row& r : rows) {
+    std::printf("%-16s %10.2f %10.1f %12.1f %10.2f\n", r.name, r.ms, n / 1e3 / r.ms,
+                r.read / double(1 << 20), r.read / 1e6 / r.ms);
+  }
+  if (!ok) std::puts("MISMATCH");
+  return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 26;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+  std::printf("Delta-encoded input, best of %d, %u pool threads\n", reps,
+              neon_parallel::thread_count());
+
+  // Consecutive wheel-30 candidates: gaps of at most 6 (3-bit packing).
+  neon_mem::vector<uint64_t> values(n);
+  neon_data::generate(*neon_data::find("wheel30"), values.data(), n, 40);
+  bool ok = run("wheel-30 candidates", values, reps);
+
+  // Sorted uniform 32-bit values: gaps around 2^32 / n.
+  neon_data::generate(*neon_data::find("uniform32"), values.data(), n, 40);
+  std::sort(values.begin(), values.end());
+  ok = run("sorted random", values, reps) && ok;
+  return ok ? 0 : 1;
+}
@@ -1,166 +0,0 @@
-#include "../src/simd_fast.hpp"
-#include <iostream>
-#include <vector>
-#include <chrono>
-#include <random>
-#include <iomanip>
-#include <cmath>
-
-using namespace std::chrono;
-
-// Naive scalar for baseline
-void filter_scalar_naive(const uint64_t* numbers, uint8_t* out, size_t count) {
-    for (size_t i = 0; i < count; i++) {
-        uint64_t n = numbers[i];
-        if (n <= 1) { out[i] = 0; continue; }
-        if (n <= 3) { out[i] = 1; continue; }
-        if (n % 2 == 0 || n % 3 == 0) { out[i] = 0; continue; }
-
-        bool is_prime = true;
-        uint64_t limit = std::sqrt(n);
-        for (uint64_t d = 5; d <= limit; d += 6) {
-            if (n % d == 0 || n % (d + 2) == 0) {
-                is_prime = false;
-                break;
-            }
-        }
-        out[i] = is_prime ? 1 : 0;
-    }
-}
-
-template<typename Func>
-double benchmark_throughput(Func func, const std::vector<uint64_t>& numbers,
-                           std::vector<uint8_t>& output, int iterations) {
-    // Warmup
-    for (int i = 0; i < 5; i++) {
-        func(numbers.data(), output.data(), numbers.size());
-    }
-
-    // Benchmark
-    auto start = high_resolution_clock::now();
-    for (int i = 0; i < iterations; i++) {
-        func(numbers.data(), output.data(), numbers.size());
-    }
-    auto end = high_resolution_clock::now();
-
-    auto duration = duration_cast<microseconds>(end - start).count();
-    return (double(numbers.size() * iterations) / duration) * 1e6 / 1e9;
-}
-
-int main() {
-    std::cout << "\n";
-    std::cout << "================================================================================\n";
-    std::cout << "             FINAL COMPREHENSIVE SIMD PRIME FILTER BENCHMARK\n";
-    std::cout << "                    Apple Silicon M-Series Performance\n";
-    std::cout << "================================================================================\n\n";
-
-    std::mt19937_64 rng(42);
-    std::uniform_int_distribution<uint64_t> dist32(1, 0xffffffffu);
-
-    // Test with 65536 numbers for stable results
-    const size_t size = 65536;
-    std::cout << "DATASET: " << size << " random 32-bit integers\n";
-    std::cout << "--------------------------------------------------------------------------------\n";
-
-    // Generate test data
-    std::vector<uint64_t> numbers(size);
-    for (auto& n : numbers) n = dist32(rng);
-
-    // Buffers
-    std::vector<uint8_t> output(size);
-    std::vector<uint8_t> bitmap((size + 7) / 8);
-
-    // Results table
-    std::cout << std::left << std::setw(35) << "Implementation"
-              << std::right << std::setw(12) << "Throughput"
-              << std::setw(10) << "Speedup"
-              << std::setw(12) << "ns/number\n";
-    std::cout << std::string(69, '-') << "\n";
-
-    // 1. Baseline: Scalar naive
-    double baseline = benchmark_throughput(filter_scalar_naive, numbers, output, 5);
-    std::cout << std::left << std::setw(35) << "C++ Scalar (naive modulo)"
-              << std::right << std::fixed << std::setprecision(4)
-              << std::setw(10) << baseline << " Gn/s"
-              << std::setw(9) << "1.0x"
-              << std::setw(11) << std::setprecision(1) << 1000.0/baseline << " ns\n";
-
-    // 2. SIMD Ultra Barrett-16
-    double ultra = benchmark_throughput(neon_ultra::filter_stream_u64_barrett16_ultra,
-                                       numbers, output, 100);
-    std::cout << std::left << std::setw(35) << "SIMD Ultra Barrett-16"
-              << std::right << std::fixed << std::setprecision(4)
-              << std::setw(10) << ultra << " Gn/s"
-              << std::setw(9) << std::setprecision(1) << ultra/baseline << "x"
-              << std::setw(11) << 1000.0/ultra << " ns\n";
-
-    // 3. SIMD Wheel-30 (FASTEST)
-    double wheel30 = benchmark_throughput(neon_wheel::filter_stream_u64_wheel_bitmap,
-                                         numbers, bitmap, 1000);
-    std::cout << std::left << std::setw(35) << "SIMD Wheel-30 + Bitmap [FASTEST]"
-              << std::right << std::fixed << std::setprecision(4)
-              << std::setw(10) << wheel30 << " Gn/s"
-              << std::setw(9) << std::setprecision(1) << wheel30/baseline << "x"
-              << std::setw(11) << 1000.0/wheel30 << " ns\n";
-
-    // 4. SIMD Wheel-210 Efficient
-    double wheel210 = benchmark_throughput(neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
-                                          numbers, bitmap, 1000);
-    std::cout << std::left << std::setw(35) << "SIMD Wheel-210 (efficient)"
-              << std::right << std::fixed << std::setprecision(4)
-              << std::setw(10) << wheel210 << " Gn/s"
-              << std::setw(9) << std::setprecision(1) << wheel210/baseline << "x"
-              << std::setw(11) << 1000.0/wheel210 << " ns\n";
-
-    std::cout << "\n";
-    std::cout << "================================================================================\n";
-    std::cout << "EXTERNAL LIBRARY COMPARISON (from separate benchmarks)\n";
-    std::cout << "--------------------------------------------------------------------------------\n";
-    std::cout << std::left << std::setw(35) << "Library/Implementation"
-              << std::right << std::setw(12) << "Throughput"
-              << std::setw(12) << "vs SIMD\n";
-    std::cout << std::string(59, '-') << "\n";
-
-    // From our Python benchmarks
-    std::cout << std::left << std::setw(35) << "gmpy2 (GMP) - full primality"
-              << std::right << std::setw(10) << "0.005" << " Gn/s"
-              << std::setw(10) << wheel30/0.005 << "x slower\n";
-
-    std::cout << std::left << std::setw(35) << "NumPy vectorized"
-              << std::right << std::setw(10) << "0.023" << " Gn/s"
-              << std::setw(10) << wheel30/0.023 << "x slower\n";
-
-    std::cout << std::left << std::setw(35) << "Pure Python"
-              << std::right << std::setw(10) << "0.00003" << " Gn/s"
-              << std::setw(10) << int(wheel30/0.00003) << "x slower\n";
-
-    std::cout << "\n";
-    std::cout << "================================================================================\n";
-    std::cout << "KEY PERFORMANCE METRICS\n";
-    std::cout << "--------------------------------------------------------------------------------\n";
-
-    std::cout << "Peak Single-Core Throughput:  " << std::fixed << std::setprecision(3)
-              << wheel30 << " billion numbers/second\n";
-    std::cout << "Latency per Number:           " << std::setprecision(2)
-              << 1000.0/wheel30 << " nanoseconds\n";
-    std::cout << "Speedup vs C++ Scalar:        " << std::setprecision(0)
-              << wheel30/baseline << "x\n";
-    std::cout << "Speedup vs GMP:               " << wheel30/0.005 << "x\n";
-    std::cout << "Speedup vs NumPy:             " << wheel30/0.023 << "x\n";
-    std::cout << "Speedup vs Python:            " << int(wheel30/0.00003) << "x\n";
-
-    std::cout << "\n";
-    std::cout << "OPTIMIZATION IMPACT:\n";
-    std::cout << "  Wheel-30 prefilter:  73.3% elimination before Barrett\n";
-    std::cout << "  Wheel-210 overhead:  Too high (" << std::setprecision(1)
-              << (1 - wheel210/wheel30)*100 << "% slower than Wheel-30)\n";
-    std::cout << "  Optimal choice:      Wheel-30 for Apple Silicon NEON\n";
-
-    std::cout << "\n";
-    std::cout << "================================================================================\n";
-    std::cout << "CONCLUSION: SIMD Wheel-30 achieves " << std::setprecision(2) << wheel30
-              << " Gnum/s - Production Ready!\n";
-    std::cout << "================================================================================\n\n";
-
-    return 0;
-}
\ No newline at end of file
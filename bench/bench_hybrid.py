@@ -6,14 +6,34 @@ Shows both speed (SIMD) and correctness (GMP) in one system
 
 import numpy as np
 import time
+import struct
 import subprocess
 import os
+import sys
 from pathlib import Path
 
 import gmpy2
 
+sys.path.insert(0, str(Path(__file__).resolve().parent.parent / "python"))
+try:
+    import prime8  # in-process kernels through libprime8's C ABI
+except OSError:
+    prime8 = None
+
+# Wire format shared with bench/hybrid_driver.cpp (little-endian).
+REQUEST = struct.Struct("<IBBHQ")     # magic, mode, output, reserved, count
+RESPONSE = struct.Struct("<IIQQ")     # magic, status, survivors, payload_bytes
+REQUEST_MAGIC = 0x51384550
+RESPONSE_MAGIC = 0x52384550
+MODES = {"wheel30": 0, "wheel210": 1, "barrett16": 2, "sieve": 3, "prime": 4}
+OUTPUTS = {"bitmap": 0, "survivors": 1, "count": 2}
+
+
 def ensure_wheel30_driver():
-    """Compile the wheel bitmap driver executable if it is missing."""
+    """Return the driver built by CMake, compiling it by hand if it is missing."""
+    built = Path("build") / "hybrid_driver"
+    if built.exists():
+        return str(built)
     bench_dir = Path("bench")
     bench_dir.mkdir(parents=True, exist_ok=True)
     driver_path = bench_dir / "hybrid_driver"
@@ -31,41 +51,76 @@ def ensure_wheel30_driver():
         "src",
         "bench/hybrid_driver.cpp",
         "build/libprime8.a",
+        "-lpthread",
         "-o",
         str(driver_path),
     ]
     subprocess.run(cmd, check=True)
     return str(driver_path)
 
-def run_driver(driver_path, mode, numbers):
-    """Invoke the C++ driver and return surviving candidates."""
-    result = subprocess.run(
-        [driver_path, mode, str(len(numbers))],
-        input=numbers.tobytes(),
-        stdout=subprocess.PIPE,
-        check=True,
-    )
-    candidates = []
-    for line in result.stdout.splitlines():
-        line = line.strip()
-        if line:
-            candidates.append(int(line))
-    return candidates
-
-
-def benchmark_hybrid_pipeline(numbers, driver=None, mode=None):
+
+class HybridDriver:
+    """One long-lived hybrid_driver co-process serving framed requests."""
+
+    def __init__(self, driver_path):
+        self.proc = subprocess.Popen(
+            [driver_path], stdin=subprocess.PIPE, stdout=subprocess.PIPE
+        )
+
+    def request(self, mode, numbers, output="survivors"):
+        """Filter numbers; returns a u64 array, a bitmap array or an int count."""
+        numbers = np.ascontiguousarray(numbers, dtype="<u8")
+        self.proc.stdin.write(
+            REQUEST.pack(REQUEST_MAGIC, MODES[mode], OUTPUTS[output], 0, len(numbers))
+        )
+        self.proc.stdin.write(memoryview(numbers).cast("B"))
+        self.proc.stdin.flush()
+
+        header = self.proc.stdout.read(RESPONSE.size)
+        if len(header) != RESPONSE.size:
+            raise RuntimeError("hybrid_driver exited mid-request")
+        magic, status, survivors, nbytes = RESPONSE.unpack(header)
+        if magic != RESPONSE_MAGIC or status != 0:
+            raise RuntimeError(f"hybrid_driver error: magic={magic:#x} status={status}")
+        payload = self.proc.stdout.read(nbytes)
+        if output == "count":
+            return survivors
+        if output == "bitmap":
+            return np.frombuffer(payload, dtype=np.uint8)
+        return np.frombuffer(payload, dtype="<u8")
+
+    def close(self):
+        if self.proc.poll() is None:
+            self.proc.stdin.close()
+            self.proc.wait()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        self.close()
+
+
+def run_driver(driver, mode, numbers):
+    """Surviving candidates from the co-process, as a u64 array."""
+    return driver.request(mode, numbers, "survivors")
+
+
+def benchmark_hybrid_pipeline(numbers, driver=None, mode=None, prefilter=None):
     """
     Hybrid pipeline:
-    1. SIMD prefilter (fast, eliminates 99% of composites)
+    1. SIMD prefilter (fast, eliminates 99% of composites), either through the
+       driver co-process or an in-process prefilter(numbers) -> candidates
     2. GMP confirmation on survivors (accurate, handles the 1%)
     """
     size = len(numbers)
-    bitmap_size = (size + 7) // 8
+    if driver and mode:
+        prefilter = lambda nums: run_driver(driver, mode, nums)
 
     # Stage 1: SIMD prefilter (if available)
-    if driver and mode:
+    if prefilter:
         start_simd = time.perf_counter()
-        candidates = run_driver(driver, mode, numbers)
+        candidates = prefilter(numbers)
         end_simd = time.perf_counter()
         simd_time = end_simd - start_simd
     else:
@@ -85,7 +140,22 @@ def benchmark_hybrid_pipeline(numbers, driver=None, mode=None):
         'total_time': simd_time + gmp_time,
         'candidates': len(candidates),
         'primes': len(confirmed_primes),
-        'reduction': 100.0 * (1 - len(candidates)/size) if driver and mode else 0
+        'reduction': 100.0 * (1 - len(candidates)/size) if prefilter else 0
+    }
+
+
+def benchmark_inprocess_exact(numbers):
+    """prime8.confirm: fused wheel filter + Miller-Rabin, no GMP at all."""
+    start = time.perf_counter()
+    _, primes = prime8.confirm(numbers)
+    elapsed = time.perf_counter() - start
+    return {
+        'simd_time': elapsed,
+        'gmp_time': 0.0,
+        'total_time': elapsed,
+        'candidates': primes,
+        'primes': primes,
+        'reduction': 100.0 * (1 - primes/len(numbers)),
     }
 
 def main():
@@ -96,7 +166,8 @@ def main():
 
     # Try to compile and load SIMD library
     try:
-        driver30 = ensure_wheel30_driver()
+        driver_path = ensure_wheel30_driver()
+        driver30 = HybridDriver(driver_path)
     except Exception as exc:
         print(f"WARNING: Could not build wheel-30 driver ({exc}); using Python fallback")
         driver30 = None
@@ -129,6 +200,17 @@ def main():
             )
             print(f"Done. Found {results['wheel30_gmp']['primes']} primes")
 
+        if prime8 is not None:
+            print("Running in-process Wheel-30 + GMP...", end=" ", flush=True)
+            results['inproc_gmp'] = benchmark_hybrid_pipeline(
+                numbers, prefilter=lambda nums: prime8.compact(nums, "wheel30")
+            )
+            print(f"Done. Found {results['inproc_gmp']['primes']} primes")
+
+            print("Running in-process exact (prime8)...", end=" ", flush=True)
+            results['inproc_exact'] = benchmark_inprocess_exact(numbers)
+            print(f"Done. Found {results['inproc_exact']['primes']} primes")
+
         # Print results table
         print("\n" + "="*70)
         print("PIPELINE COMPARISON")
@@ -142,6 +224,8 @@ def main():
             pipeline_name = {
                 'gmp_only': 'GMP Only',
                 'wheel30_gmp': 'SIMD Wheel-30 + GMP',
+                'inproc_gmp': 'ctypes Wheel-30 + GMP',
+                'inproc_exact': 'ctypes exact (no GMP)',
             }.get(name, name)
 
             speedup = baseline / res['total_time']
@@ -159,11 +243,31 @@ def main():
                   f"({100*w30['candidates']/size:.1f}%)")
             print(f"  Confirmed:      {w30['primes']:>8,} primes")
 
+            # What the co-process saves: a fresh process per dataset pays
+            # exec + dynamic loading on every call.
+            start = time.perf_counter()
+            with HybridDriver(driver_path) as once:
+                run_driver(once, "wheel30", numbers)
+            spawn_time = time.perf_counter() - start
+            start = time.perf_counter()
+            run_driver(driver30, "wheel30", numbers)
+            warm_time = time.perf_counter() - start
+            print(f"  Spawn per call: {spawn_time*1000:>8.2f} ms   "
+                  f"co-process: {warm_time*1000:.2f} ms")
+            if 'inproc_gmp' in results:
+                print(f"  In-process:     {results['inproc_gmp']['simd_time']*1000:>8.2f} ms "
+                      "(ctypes, zero-copy)")
+
         # Throughput comparison
         print("\nTHROUGHPUT:")
         print(f"  GMP only:        {size/results['gmp_only']['total_time']/1e9:.4f} Gnum/s")
         if has_simd and 'wheel30_gmp' in results:
             print(f"  Wheel-30 + GMP:  {size/results['wheel30_gmp']['total_time']/1e9:.4f} Gnum/s")
+        if 'inproc_exact' in results:
+            print(f"  ctypes exact:    {size/results['inproc_exact']['total_time']/1e9:.4f} Gnum/s")
+
+    if has_simd:
+        driver30.close()
 
     print("\n" + "="*70)
     print("KEY INSIGHTS:")
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+// Survivor compaction three ways on the wheel-30 kernel:
+//   bitmap+list  full bitmap, then a ctz walk into a second array
+//   left_pack    full bitmap, then the vqtbl2q left-pack into a second array
+//   inplace      neon_inplace::filter_inplace (tile bitmap on the stack)
+// "extra" is the memory each needs on top of the input.
+//
+//   ./build/bench_inplace [N] [reps]
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace {
+
+template <class Fn>
+double best_ms(int reps, Fn&& fn) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    const auto t0 = bench_clock::now();
+    fn();
+    best = std::min(best,
+                    std::chrono::duration<double, std::milli>(bench_clock::now() - t0).count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 25;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 5;
+  const auto fn = neon_wheel::filter_stream_u64_wheel_bitmap;
+
+  neon_mem::vector<uint64_t> input(n), work(n), list(n, 0);
+  neon_mem::vector<uint8_t> bitmap((n + 7) / 8, 0);
+  neon_data::generate(*neon_data::find("uniform32"), input.data(), n, 39);
+
+  size_t kept[4] = {};
+  auto ctz_walk = [&] {
+    fn(input.data(), bitmap.data(), n);
+    size_t k = 0;
+    for (size_t w = 0; w * 64 < n; ++w) {
+      uint64_t word = 0;
+      std::memcpy(&word, bitmap.data() + w * 8, std::min<size_t>(8, bitmap.size() - w * 8));
+      while (word) {
+        list[k++] = input[w * 64 + __builtin_ctzll(word)];
+        word &= word - 1;
+      }
+    }
+    kept[0] = k;
+  };
+  auto pack = [&] {
+    fn(input.data(), bitmap.data(), n);
+    kept[1] = neon_inplace::left_pack(input.data(), bitmap.data(), n, list.data());
+  };
+  // The in-place runs reload their input each rep; the copy is timed separately
+  // and subtracted.
+  auto reload = [&] { std::memcpy(work.data(), input.data(), n * sizeof(uint64_t)); };
+  const double copy_ms = best_ms(reps, reload);
+  auto inplace = [&] {
+    reload();
+    kept[2] = neon_inplace::filter_inplace(fn, work.data(), n);
+  };
+  auto inplace_pool = [&] {
+    reload();
+    kept[3] = neon_parallel::parallel_filter_inplace(fn, work.data(), n);
+  };
+
+  struct Row {
+    const char* name;
+    double ms;
+    size_t extra;
+  } rows[] = {
+    {"bitmap+list", best_ms(reps, ctz_walk), bitmap.size() + n * 8},
+    {"left_pack", best_ms(reps, pack), bitmap.size() + n * 8},
+    {"inplace", best_ms(reps, inplace) - copy_ms, neon_inplace::kInplaceTile / 8},
+    {"inplace (pool)", best_ms(reps, inplace_pool) - copy_ms,
+     neon_inplace::kInplaceTile / 8 * neon_parallel::thread_count()},
+  };
+
+  std::printf("Compaction of %zu numbers (%.1f MiB), best of %d, %u pool threads\n", n,
+              n * 8.0 / (1 << 20), reps, neon_parallel::thread_count());
+  std::printf("%-16s %10s %10s %14s %10s\n", "method", "ms", "Mnum/s", "extra bytes", "kept");
+  for (size_t i = 0; i < 4; ++i) {
+    std::printf("%-16s %10.2f %10.1f %14zu %10zu\n", rows[i].name, rows[i].ms,
+                n / 1e3 / rows[i].ms, rows[i].extra, kept[i]);
+  }
+  const bool ok = kept[0] == kept[1] && kept[1] == kept[2] && kept[2] == kept[3];
+  if (!ok) std::puts("MISMATCH");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+// Cached vs non-temporal output for the stream kernels on inputs far larger
+// than the LLC (default 2^27 numbers = 1 GiB). Byte-output kernels write
+// another 128 MiB, bitmaps 16 MiB.
+//
+//   ./build/bench_nontemporal [N] [reps]
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Kernel {
+  const char* name;
+  neon_stream::StreamKernel fn;
+  bool bitmap;
+};
+
+const Kernel kKernels[] = {
+  {"barrett16 (bytes)", neon_fast::filter_stream_u64_barrett16, false},
+  {"barrett16-bitmap", neon_fast::filter_stream_u64_barrett16_bitmap, true},
+  {"wheel-bitmap", neon_wheel::filter_stream_u64_wheel_bitmap, true},
+  {"wheel210eff-bitmap", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+   true},
+};
+
+template <class Fn>
+double best_ms(int reps, Fn&& fn) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    const auto t0 = bench_clock::now();
+    fn();
+    best = std::min(best,
+                    std::chrono::duration<double, std::milli>(bench_clock::now() - t0).count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : size_t(1) << 27;
+  const int reps = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  uint64_t* numbers = neon_parallel::alloc_numbers_first_touch(n);
+  uint8_t* cached = neon_parallel::alloc_output_first_touch(n, false);
+  uint8_t* streamed = neon_parallel::alloc_output_first_touch(n, false);
+  if (!numbers || !cached || !streamed) {
+    std::fprintf(stderr, "cannot allocate %zu numbers\n", n);
+    return 1;
+  }
+  neon_data::generate(*neon_data::find("uniform32"), numbers, n, 37);
+
+  const unsigned threads = neon_parallel::thread_count();
+  std::printf("Output policy on %zu numbers (%.2f GiB input), best of %d, %u pool threads\n", n,
+              n * 8.0 / (1u << 30), reps, threads);
+  std::printf("%-20s %-9s %12s %12s %10s %10s %8s\n", "kernel", "mode", "cached ms", "nt ms",
+              "cached GB/s", "nt GB/s", "gain");
+
+  const auto cached_policy = neon_stream::OutputPolicy::Cached;
+  const auto nt_policy = neon_stream::OutputPolicy::NonTemporal;
+  bool ok = true;
+  for (const Kernel& k : kKernels) {
+    const size_t out_bytes = k.bitmap ? (n + 7) / 8 : n;
+    for (int pooled = 0; pooled < (threads > 1 ? 2 : 1); ++pooled) {
+      auto run = [&](uint8_t* out, neon_stream::OutputPolicy policy) {
+        if (pooled) {
+          neon_parallel::parallel_filter_stream(k.fn, k.bitmap, numbers, out, n, policy);
+        } else {
+          neon_stream::filter_stream(k.fn, k.bitmap, numbers, out, n, policy);
+        }
+      };
+      const double tc = best_ms(reps, [&] { run(cached, cached_policy); });
+      const double tn = best_ms(reps, [&] { run(streamed, nt_policy); });
+      if (std::memcmp(cached, streamed, out_bytes) != 0) {
+        std::printf("%s: outputs differ\n", k.name);
+        ok = false;
+      }
+      const double gb = (n * 8.0 + out_bytes) / 1e9;
+      std::printf("%-20s %-9s %12.1f %12.1f %10.2f %10.2f %7.1f%%\n", k.name,
+                  pooled ? "parallel" : "serial", tc, tn, gb / (tc / 1e3), gb / (tn / 1e3),
+                  (tc / tn - 1.0) * 100.0);
+    }
+  }
+
+  neon_parallel::free_first_touch(numbers);
+  neon_parallel::free_first_touch(cached);
+  neon_parallel::free_first_touch(streamed);
+  return ok ? 0 : 1;
+}
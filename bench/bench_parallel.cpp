@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+namespace {
+
+constexpr uint64_t kFnvBasis = 0xcbf29ce484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+uint64_t hash_bytes(const uint8_t* data, size_t size) {
+  uint64_t h = kFnvBasis;
+  for (size_t i = 0; i < size; ++i) {
+    h ^= data[i];
+    h *= kFnvPrime;
+  }
+  return h;
+}
+
+using StreamKernel = void (*)(const uint64_t*, uint8_t*, size_t);
+
+// Best of `reps` runs; the first call also warms the pool and page tables.
+double time_best(StreamKernel fn, const uint64_t* numbers, uint8_t* out, size_t n,
+                 int reps) {
+  double best = 1e300;
+  for (int r = 0; r < reps; ++r) {
+    auto t0 = bench_clock::now();
+    fn(numbers, out, n);
+    auto t1 = bench_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+  return best;
+}
+
+// 1, 2, 3, 4, 8, 16, ... and always the maximum itself.
+std::vector<unsigned> thread_steps(unsigned max_threads) {
+  std::vector<unsigned> steps;
+  for (unsigned t = 1; t < max_threads; t = (t < 4 ? t + 1 : t * 2)) steps.push_back(t);
+  steps.push_back(max_threads);
+  return steps;
+}
+
+// Per-slot throughput of the last parallel call: a slot on a slower core or a
+// remote node shows up as fewer chunks or a lower Gnum/s.
+void print_worker_stats() {
+  std::printf("  %-5s %5s %5s %9s %8s %7s %10s %10s\n",
+              "slot", "cpu", "node", "capacity", "chunks", "steals", "busy_ms", "Gnum/s");
+  for (const auto& w : neon_parallel::last_run_stats()) {
+    const double nums = static_cast<double>(w.chunks) * neon_parallel::kParallelChunk;
+    const double rate = w.busy_ms > 0 ? (nums / 1e9) / (w.busy_ms / 1000.0) : 0.0;
+    std::printf("  %-5u %5u %5u %9u %8zu %7zu %10.3f %10.3f\n", w.slot, w.cpu, w.node,
+                w.capacity, w.chunks, w.steals, w.busy_ms, rate);
+  }
+}
+
+// Strong scaling: fixed problem size, growing thread count. Each thread count
+// gets fresh first-touch buffers so pages sit on the node of the slot that
+// filters them.
+void scaling_curve(const char* label, StreamKernel serial, StreamKernel parallel,
+                   bool bitmap, const neon_mem::vector<uint64_t>& numbers,
+                   unsigned max_threads, int reps) {
+  const size_t n = numbers.size();
+  neon_mem::vector<uint8_t> ref(bitmap ? (n + 7) / 8 : n, 0);
+
+  const double serial_ms = time_best(serial, numbers.data(), ref.data(), n, reps);
+  const uint64_t ref_hash = hash_bytes(ref.data(), ref.size());
+
+  std::printf("\n=== Strong scaling: %s (n=%zu) ===\n", label, n);
+  std::printf("%-8s %10s %10s %8s %8s %s\n",
+              "threads", "time_ms", "Gnum/s", "speedup", "effic", "hash");
+  std::printf("%-8s %10.3f %10.3f %8.2f %8s %016llx\n", "serial", serial_ms,
+              (n / 1e9) / (serial_ms / 1000.0), 1.0, "-",
+              static_cast<unsigned long long>(ref_hash));
+
+  for (unsigned t : thread_steps(max_threads)) {
+    neon_parallel::set_thread_count(t);
+    uint64_t* in = neon_parallel::alloc_numbers_first_touch(n);
+    uint8_t* out = neon_parallel::alloc_output_first_touch(n, bitmap);
+    std::memcpy(in, numbers.data(), n * sizeof(uint64_t));
+    const double ms = time_best(parallel, in, out, n, reps);
+    const uint64_t h = hash_bytes(out, ref.size());
+    const double speedup = serial_ms / ms;
+    std::printf("%-8u %10.3f %10.3f %8.2f %7.0f%% %016llx%s\n", t, ms,
+                (n / 1e9) / (ms / 1000.0), speedup, 100.0 * speedup / t,
+                static_cast<unsigned long long>(h), h == ref_hash ? "" : "  MISMATCH");
+    if (t == max_threads && t > 1) print_worker_stats();
+    neon_parallel::free_first_touch(in);
+    neon_parallel::free_first_touch(out);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  size_t N = 100'000'000;
+  unsigned max_threads = std::thread::hardware_concurrency();
+  int reps = 5;
+  if (argc > 1) N = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) max_threads = static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10));
+  if (argc > 3) reps = std::atoi(argv[3]);
+  if (max_threads == 0) max_threads = 1;
+
+  neon_mem::vector<uint64_t> numbers(N);
+  neon_data::generate(*neon_data::find("uniform32"), numbers.data(), N, 42);
+
+  const auto topo = neon_parallel::read_topology();
+  std::printf("Dataset size: %zu numbers, chunk=%zu, max threads=%u, reps=%d\n",
+              N, neon_parallel::kParallelChunk, max_threads, reps);
+  std::printf("Topology: %zu CPUs on %u node(s), pinning %s (PRIME8_PIN=1 to enable)\n",
+              topo.cpus.size(), topo.nodes,
+              neon_parallel::default_pool().pinned() ? "on" : "off");
+
+  scaling_curve("barrett16 bytes", neon_fast::filter_stream_u64_barrett16,
+                neon_parallel::parallel_filter_stream_u64_barrett16, false,
+                numbers, max_threads, reps);
+  scaling_curve("barrett16 bitmap", neon_fast::filter_stream_u64_barrett16_bitmap,
+                neon_parallel::parallel_filter_stream_u64_barrett16_bitmap, true,
+                numbers, max_threads, reps);
+  scaling_curve("wheel-30 bitmap", neon_wheel::filter_stream_u64_wheel_bitmap,
+                neon_parallel::parallel_filter_stream_u64_wheel_bitmap, true,
+                numbers, max_threads, reps);
+  return 0;
+}
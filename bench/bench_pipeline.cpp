@@ -1,63 +1,15 @@
-#include "src/simd_fast.hpp"
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "simd_fast.hpp"
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <random>
 #include <iomanip>
 #include <cstring>
 
 using namespace std::chrono;
 
-// Deterministic Miller-Rabin for 32-bit numbers
-// Using witnesses that work for all 32-bit integers
-bool miller_rabin_32(uint32_t n) {
-    if (n < 2) return false;
-    if (n == 2 || n == 3) return true;
-    if ((n & 1) == 0) return false;
-
-    // Write n-1 as d * 2^r
-    uint32_t d = n - 1;
-    int r = 0;
-    while ((d & 1) == 0) {
-        d >>= 1;
-        r++;
-    }
-
-    // Witnesses for deterministic 32-bit test
-    const uint32_t witnesses[] = {2, 7, 61};
-
-    for (uint32_t a : witnesses) {
-        if (a >= n) continue;
-
-        // Compute a^d mod n
-        uint64_t x = 1;
-        uint64_t base = a;
-        uint32_t exp = d;
-
-        while (exp > 0) {
-            if (exp & 1) {
-                x = (x * base) % n;
-            }
-            base = (base * base) % n;
-            exp >>= 1;
-        }
-
-        if (x == 1 || x == n - 1) continue;
-
-        bool composite = true;
-        for (int i = 0; i < r - 1; i++) {
-            x = (x * x) % n;
-            if (x == n - 1) {
-                composite = false;
-                break;
-            }
-        }
-
-        if (composite) return false;
-    }
-
-    return true;
-}
+using neon_mr::miller_rabin_32;
 
 struct PipelineStats {
     size_t total_numbers;
@@ -71,7 +23,7 @@ struct PipelineStats {
 };
 
 // Pipeline A: Miller-Rabin only (no prefilter)
-PipelineStats pipeline_mr_only(const std::vector<uint64_t>& numbers) {
+PipelineStats pipeline_mr_only(const neon_mem::vector<uint64_t>& numbers) {
     PipelineStats stats{};
     stats.total_numbers = numbers.size();
 
@@ -94,13 +46,13 @@ PipelineStats pipeline_mr_only(const std::vector<uint64_t>& numbers) {
 }
 
 // Pipeline B: SIMD Prefilter + Miller-Rabin on survivors
-PipelineStats pipeline_simd_mr(const std::vector<uint64_t>& numbers) {
+PipelineStats pipeline_simd_mr(const neon_mem::vector<uint64_t>& numbers) {
     PipelineStats stats{};
     stats.total_numbers = numbers.size();
 
     // Allocate bitmap
     size_t bitmap_size = (numbers.size() + 7) / 8;
-    std::vector<uint8_t> bitmap(bitmap_size, 0);
+    neon_mem::vector<uint8_t> bitmap(bitmap_size, 0);
 
     // Stage 1: SIMD prefilter
     auto filter_start = high_resolution_clock::now();
@@ -109,7 +61,7 @@ PipelineStats pipeline_simd_mr(const std::vector<uint64_t>& numbers) {
     stats.ms_filter = duration<double, std::milli>(filter_end - filter_start).count();
 
     // Collect survivors
-    std::vector<uint32_t> survivors;
+    neon_mem::vector<uint32_t> survivors;
     survivors.reserve(numbers.size() / 4); // Expect ~26.7% survival
 
     for (size_t i = 0; i < numbers.size(); i++) {
@@ -138,10 +90,23 @@ PipelineStats pipeline_simd_mr(const std::vector<uint64_t>& numbers) {
     return stats;
 }
 
+// Pipeline C: fused tiles (filter + compact + MR while the tile is in L1)
+PipelineStats pipeline_fused(const neon_mem::vector<uint64_t>& numbers) {
+    PipelineStats stats{};
+    stats.total_numbers = numbers.size();
+
+    auto start = high_resolution_clock::now();
+    stats.confirmed_primes = neon_fused::fused_prime_count(numbers.data(), numbers.size());
+    auto end = high_resolution_clock::now();
+    stats.ms_total = duration<double, std::milli>(end - start).count();
+
+    return stats;
+}
+
 // Verify correctness: no false negatives
-bool verify_no_false_negatives(const std::vector<uint64_t>& numbers) {
+bool verify_no_false_negatives(const neon_mem::vector<uint64_t>& numbers) {
     size_t bitmap_size = (numbers.size() + 7) / 8;
-    std::vector<uint8_t> bitmap(bitmap_size, 0);
+    neon_mem::vector<uint8_t> bitmap(bitmap_size, 0);
 
     neon_wheel::filter_stream_u64_wheel_bitmap(numbers.data(), bitmap.data(), numbers.size());
 
@@ -161,7 +126,7 @@ bool verify_no_false_negatives(const std::vector<uint64_t>& numbers) {
 
 void print_stats(const std::string& name, const PipelineStats& s) {
     double throughput_total = s.total_numbers / s.ms_total / 1000.0; // Million/sec
-    double throughput_mr = s.mr_calls / s.ms_mr / 1000.0;
+    double throughput_mr = s.ms_mr > 0 ? s.mr_calls / s.ms_mr / 1000.0 : 0.0;
     double survival_rate = 100.0 * s.survivors / s.total_numbers;
     double prime_rate = 100.0 * s.confirmed_primes / s.total_numbers;
 
@@ -178,7 +143,9 @@ void print_stats(const std::string& name, const PipelineStats& s) {
                   << s.survivors << "/" << s.total_numbers << ")\n";
     }
 
-    std::cout << "  MR calls:        " << s.mr_calls << "\n";
+    if (s.mr_calls > 0) {
+        std::cout << "  MR calls:        " << s.mr_calls << "\n";
+    }
     std::cout << "  Confirmed primes: " << s.confirmed_primes
               << " (" << prime_rate << "%)\n";
 }
@@ -190,35 +157,16 @@ int main() {
     std::cout << "================================================================================\n\n";
 
     // Test different datasets
-    std::vector<std::pair<std::string, std::vector<uint64_t>>> datasets;
-
-    // 1. Random 32-bit
-    {
-        std::mt19937_64 rng(42);
-        std::uniform_int_distribution<uint64_t> dist(1, 0xFFFFFFFF);
-        std::vector<uint64_t> random_data(1000000);
-        for (auto& n : random_data) n = dist(rng);
-        datasets.push_back({"Random 32-bit (1M)", std::move(random_data)});
-    }
-
-    // 2. Sequential
-    {
-        std::vector<uint64_t> seq_data(100000);
-        for (size_t i = 0; i < seq_data.size(); i++) {
-            seq_data[i] = 1000000 + i;
-        }
-        datasets.push_back({"Sequential (100K)", std::move(seq_data)});
-    }
-
-    // 3. Composite-heavy (even numbers)
-    {
-        std::vector<uint64_t> comp_data(1000000);
-        for (size_t i = 0; i < comp_data.size(); i++) {
-            comp_data[i] = (i + 1) * 2; // All even except mixed with some odds
-            if (i % 10 == 0) comp_data[i] = (i + 1) * 2 + 1; // 10% odd
-        }
-        datasets.push_back({"Composite-heavy (1M)", std::move(comp_data)});
-    }
+    std::vector<std::pair<std::string, neon_mem::vector<uint64_t>>> datasets;
+    auto add = [&](const char* label, const char* name, size_t n) {
+        neon_mem::vector<uint64_t> data(n);
+        neon_data::generate(*neon_data::find(name), data.data(), n, 42);
+        datasets.push_back({label, std::move(data)});
+    };
+    add("Random 32-bit (1M)", "uniform32", 1000000);
+    add("Sequential (100K)", "dense", 100000);
+    add("Composite-heavy (1M)", "composite80", 1000000);
+    add("Semiprimes (1M)", "semiprimes", 1000000);
 
     // Run benchmarks for each dataset
     for (const auto& [name, data] : datasets) {
@@ -237,6 +185,7 @@ int main() {
         for (int i = 0; i < 3; i++) {
             pipeline_mr_only(data);
             pipeline_simd_mr(data);
+            pipeline_fused(data);
         }
 
         // Benchmark A: MR only
@@ -249,9 +198,21 @@ int main() {
         auto stats_b = pipeline_simd_mr(data);
         print_stats("Pipeline B (SIMD+MR)", stats_b);
 
+        std::cout << "\n";
+
+        // Benchmark C: fused tiles
+        auto stats_c = pipeline_fused(data);
+        print_stats("Pipeline C (fused tiles)", stats_c);
+        if (stats_c.confirmed_primes != stats_b.confirmed_primes) {
+            std::cout << "  MISMATCH: fused found " << stats_c.confirmed_primes
+                      << " primes, two-pass found " << stats_b.confirmed_primes << "\n";
+        }
+
         // Calculate speedup
         std::cout << "\nSPEEDUP: " << std::fixed << std::setprecision(2)
                   << stats_a.ms_total / stats_b.ms_total << "x faster end-to-end\n";
+        std::cout << "FUSED vs two-pass: " << std::fixed << std::setprecision(2)
+                  << stats_b.ms_total / stats_c.ms_total << "x\n";
         std::cout << "MR calls reduced by: " << std::setprecision(1)
                   << (1.0 - double(stats_b.mr_calls) / stats_a.mr_calls) * 100 << "%\n";
 
@@ -1,4 +1,6 @@
-#include "src/simd_fast.hpp"
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "simd_fast.hpp"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -10,58 +12,16 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <algorithm>
+#include <cstdint>
 
 using namespace std::chrono;
 
-// Deterministic Miller-Rabin for 32-bit numbers
-bool miller_rabin_32(uint32_t n) {
-    if (n < 2) return false;
-    if (n == 2 || n == 3) return true;
-    if ((n & 1) == 0) return false;
-
-    uint32_t d = n - 1;
-    int r = 0;
-    while ((d & 1) == 0) {
-        d >>= 1;
-        r++;
-    }
-
-    const uint32_t witnesses[] = {2, 7, 61};
-    for (uint32_t a : witnesses) {
-        if (a >= n) continue;
-
-        uint64_t x = 1;
-        uint64_t base = a;
-        uint32_t exp = d;
-
-        while (exp > 0) {
-            if (exp & 1) {
-                x = (x * base) % n;
-            }
-            base = (base * base) % n;
-            exp >>= 1;
-        }
-
-        if (x == 1 || x == n - 1) continue;
-
-        bool composite = true;
-        for (int i = 0; i < r - 1; i++) {
-            x = (x * x) % n;
-            if (x == n - 1) {
-                composite = false;
-                break;
-            }
-        }
-
-        if (composite) return false;
-    }
-
-    return true;
-}
+using neon_mr::miller_rabin_32;
 
 // Convert bitmap to index list for better cache behavior
-std::vector<uint32_t> bitmap_to_indices(const uint8_t* bitmap, const uint64_t* numbers, size_t count) {
-    std::vector<uint32_t> survivors;
+neon_mem::vector<uint32_t> bitmap_to_indices(const uint8_t* bitmap, const uint64_t* numbers, size_t count) {
+    neon_mem::vector<uint32_t> survivors;
     survivors.reserve(count / 4); // Expect ~26.7% survival worst case
 
     for (size_t i = 0; i < count; i++) {
@@ -75,49 +35,6 @@ std::vector<uint32_t> bitmap_to_indices(const uint8_t* bitmap, const uint64_t* n
     return survivors;
 }
 
-// Adaptive filter - samples first to determine optimal depth
-struct AdaptiveConfig {
-    int prime_depth;  // How many primes to check (3-16)
-    bool use_wheel;   // Whether to use wheel-30
-};
-
-AdaptiveConfig determine_config(const uint64_t* numbers, size_t sample_size = 1000) {
-    // Quick sample to estimate composite density
-    size_t even_count = 0;
-    size_t small_composite = 0;
-
-    for (size_t i = 0; i < sample_size && i < 1000; i++) {
-        uint32_t n = numbers[i];
-        if (n <= 0xFFFFFFFF) {
-            if (n % 2 == 0) even_count++;
-            if (n % 3 == 0 || n % 5 == 0) small_composite++;
-        }
-    }
-
-    double even_ratio = (double)even_count / sample_size;
-    double composite_ratio = (double)small_composite / sample_size;
-
-    AdaptiveConfig config;
-
-    // Heavy composite (>80% even) -> minimal filtering
-    if (even_ratio > 0.8) {
-        config.prime_depth = 5;   // Just check 2,3,5,7,11
-        config.use_wheel = false; // Skip wheel overhead
-    }
-    // Moderate composite -> standard filtering
-    else if (composite_ratio > 0.5) {
-        config.prime_depth = 8;   // Check up to prime #8
-        config.use_wheel = true;
-    }
-    // Random/prime-heavy -> aggressive filtering
-    else {
-        config.prime_depth = 16;  // Check all 16 primes
-        config.use_wheel = true;
-    }
-
-    return config;
-}
-
 // Block sieving implementation for cache efficiency
 void block_sieve(const uint64_t* numbers, uint8_t* bitmap, size_t count,
                  const uint32_t* primes, int prime_count) {
@@ -144,7 +61,7 @@ void block_sieve(const uint64_t* numbers, uint8_t* bitmap, size_t count,
 
 // Producer-consumer threading model
 struct WorkItem {
-    std::vector<uint32_t> numbers;
+    neon_mem::vector<uint32_t> numbers;
     size_t batch_id;
 };
 
@@ -160,19 +77,23 @@ public:
     void producer(const uint64_t* numbers, size_t count) {
         const size_t BATCH_SIZE = 65536;
         size_t batch_id = 0;
+        // One bitmap's worth of scratch, rewound per batch instead of reallocated.
+        neon_mem::Arena scratch((BATCH_SIZE + 7) / 8);
 
         for (size_t i = 0; i < count; i += BATCH_SIZE) {
             size_t batch_end = std::min(i + BATCH_SIZE, count);
 
             // Run SIMD filter on this batch
             size_t batch_size = batch_end - i;
-            std::vector<uint8_t> bitmap((batch_size + 7) / 8);
+            scratch.reset();
+            uint8_t* bitmap = scratch.alloc<uint8_t>((batch_size + 7) / 8);
+            std::memset(bitmap, 0, (batch_size + 7) / 8);
             neon_wheel::filter_stream_u64_wheel_bitmap(
-                numbers + i, bitmap.data(), batch_size);
+                numbers + i, bitmap, batch_size);
 
             // Convert bitmap to index list
             WorkItem item;
-            item.numbers = bitmap_to_indices(bitmap.data(), numbers + i, batch_size);
+            item.numbers = bitmap_to_indices(bitmap, numbers + i, batch_size);
             item.batch_id = batch_id++;
 
             // Queue work for consumers
@@ -239,91 +160,70 @@ public:
 
 struct PipelineStats {
     size_t total_numbers;
-    size_t filtered_out;
     size_t survivors;
-    size_t mr_calls;
     size_t confirmed_primes;
-    double ms_filter;
-    double ms_mr;
     double ms_total;
-    AdaptiveConfig config;
+    neon_adaptive::AdaptiveStats engine;
 };
 
-// Adaptive pipeline with all optimizations
-PipelineStats pipeline_adaptive(const std::vector<uint64_t>& numbers) {
+const char* depth_name(neon_adaptive::Depth d) {
+    switch (d) {
+        case neon_adaptive::Depth::Wheel:  return "wheel-only";
+        case neon_adaptive::Depth::Wheel8: return "wheel+8";
+        default:                           return "full-16";
+    }
+}
+
+// Adaptive pipeline: the library engine re-probes all three filter depths
+// through the stream and keeps the cheapest one per confirmed prime.
+PipelineStats pipeline_adaptive(neon_adaptive::AdaptiveEngine& engine,
+                                const neon_mem::vector<uint64_t>& numbers) {
     PipelineStats stats{};
     stats.total_numbers = numbers.size();
+    engine.reset_stats();
 
     auto start = high_resolution_clock::now();
-
-    // Step 1: Determine optimal configuration
-    stats.config = determine_config(numbers.data());
-
-    // Step 2: SIMD filter with adaptive depth
-    auto filter_start = high_resolution_clock::now();
-
-    size_t bitmap_size = (numbers.size() + 7) / 8;
-    std::vector<uint8_t> bitmap(bitmap_size, 0xFF); // Start with all set
-
-    if (stats.config.use_wheel) {
-        neon_wheel::filter_stream_u64_wheel_bitmap(
-            numbers.data(), bitmap.data(), numbers.size());
-    } else {
-        // Simple divisibility check for composite-heavy
-        for (size_t i = 0; i < numbers.size(); i++) {
-            if (numbers[i] <= 0xFFFFFFFF) {
-                uint32_t n = numbers[i];
-                if (n % 2 == 0 && n != 2) {
-                    bitmap[i/8] &= ~(1 << (i%8));
-                }
-            }
-        }
-    }
-
-    auto filter_end = high_resolution_clock::now();
-    stats.ms_filter = duration<double, std::milli>(filter_end - filter_start).count();
-
-    // Step 3: Convert bitmap to index list (better cache behavior)
-    std::vector<uint32_t> survivors = bitmap_to_indices(
-        bitmap.data(), numbers.data(), numbers.size());
-    stats.survivors = survivors.size();
-    stats.filtered_out = numbers.size() - survivors.size();
-
-    // Step 4: Miller-Rabin on compacted survivors
-    auto mr_start = high_resolution_clock::now();
-
-    for (uint32_t n : survivors) {
-        stats.mr_calls++;
-        if (miller_rabin_32(n)) {
-            stats.confirmed_primes++;
-        }
-    }
-
-    auto mr_end = high_resolution_clock::now();
-    stats.ms_mr = duration<double, std::milli>(mr_end - mr_start).count();
-
+    stats.confirmed_primes = engine.prime_count(numbers.data(), numbers.size());
     auto end = high_resolution_clock::now();
-    stats.ms_total = duration<double, std::milli>(end - start).count();
 
+    stats.ms_total = duration<double, std::milli>(end - start).count();
+    stats.engine = engine.stats();
+    stats.survivors = stats.engine.survivors;
     return stats;
 }
 
+// Fixed-depth reference: same tile engine shape, depth pinned.
+PipelineStats pipeline_fixed(neon_adaptive::Depth depth, const neon_mem::vector<uint64_t>& numbers) {
+    neon_adaptive::AdaptiveOptions opts;
+    opts.initial = depth;
+    opts.resample_tiles = 0;  // never probe
+    neon_adaptive::AdaptiveEngine engine(opts);
+    return pipeline_adaptive(engine, numbers);
+}
+
 void print_stats(const std::string& name, const PipelineStats& s) {
     double throughput_total = s.total_numbers / s.ms_total / 1000.0;
     double survival_rate = 100.0 * s.survivors / s.total_numbers;
     double prime_rate = 100.0 * s.confirmed_primes / s.total_numbers;
+    const auto& e = s.engine;
 
     std::cout << name << ":\n";
-    std::cout << "  Config:          depth=" << s.config.prime_depth
-              << ", wheel=" << (s.config.use_wheel ? "yes" : "no") << "\n";
+    std::cout << "  Tiles by depth:  wheel=" << e.tiles[0] << " wheel+8=" << e.tiles[1]
+              << " full-16=" << e.tiles[2] << " (probes=" << e.probes
+              << ", switches=" << e.switches << ", final=" << depth_name(e.depth) << ")\n";
     std::cout << "  Total time:      " << std::fixed << std::setprecision(3)
               << s.ms_total << " ms (" << throughput_total << " M/s)\n";
-    std::cout << "  Filter time:     " << s.ms_filter << " ms\n";
-    std::cout << "  MR time:         " << s.ms_mr << " ms\n";
+    std::cout << "  ns/prime:        " << s.ms_total * 1e6 / std::max<size_t>(1, s.confirmed_primes) << "\n";
     std::cout << "  Survival rate:   " << survival_rate << "%\n";
-    std::cout << "  MR calls:        " << s.mr_calls << "\n";
     std::cout << "  Confirmed primes: " << s.confirmed_primes
               << " (" << prime_rate << "%)\n";
+    if (e.probes) {
+        std::cout << "  Last probe:      survival " << std::setprecision(1)
+                  << 100 * e.survival[0] << "/" << 100 * e.survival[1] << "/" << 100 * e.survival[2]
+                  << "%, filter ns/num " << std::setprecision(2)
+                  << e.filter_ns[0] << "/" << e.filter_ns[1] << "/" << e.filter_ns[2]
+                  << ", MR ns/call " << e.mr_ns << "\n";
+    }
 }
 
 int main() {
@@ -332,30 +232,36 @@ int main() {
     std::cout << "         ADAPTIVE PIPELINE WITH OPTIMIZATIONS\n";
     std::cout << "================================================================================\n\n";
 
-    std::vector<std::pair<std::string, std::vector<uint64_t>>> datasets;
+    std::vector<std::pair<std::string, neon_mem::vector<uint64_t>>> datasets;
+    auto add = [&](const char* label, const char* name, size_t n) {
+        neon_mem::vector<uint64_t> data(n);
+        neon_data::generate(*neon_data::find(name), data.data(), n, 42);
+        datasets.push_back({label, std::move(data)});
+    };
 
-    // 1. Random 32-bit
-    {
-        std::mt19937_64 rng(42);
-        std::uniform_int_distribution<uint64_t> dist(1, 0xFFFFFFFF);
-        std::vector<uint64_t> random_data(1000000);
-        for (auto& n : random_data) n = dist(rng);
-        datasets.push_back({"Random 32-bit (1M)", std::move(random_data)});
-    }
+    // 1-2. Library distributions
+    add("Random 32-bit (1M)", "uniform32", 1000000);
+    add("Composite-heavy (1M)", "composite80", 1000000);
 
-    // 2. Composite-heavy
+    // 3. Drifting: 64K-number segments alternating even-heavy, random and
+    //    odd-only, so the best depth changes mid-stream.
     {
-        std::vector<uint64_t> comp_data(1000000);
-        for (size_t i = 0; i < comp_data.size(); i++) {
-            comp_data[i] = (i + 1) * 2;
-            if (i % 10 == 0) comp_data[i] = (i + 1) * 2 + 1;
+        std::mt19937_64 rng(7);
+        neon_mem::vector<uint64_t> drift(1 << 20);
+        for (size_t i = 0; i < drift.size(); i++) {
+            const uint64_t r = rng() & 0xFFFFFFFF;
+            switch ((i >> 16) % 3) {
+                case 0:  drift[i] = (i % 10) ? (r & ~1ull) : r; break;
+                case 1:  drift[i] = r; break;
+                default: drift[i] = r | 1; break;
+            }
         }
-        datasets.push_back({"Composite-heavy (1M)", std::move(comp_data)});
+        datasets.push_back({"Drifting segments (1M)", std::move(drift)});
     }
 
-    // 3. Prime-rich (odd numbers)
+    // 4. Prime-rich (odd numbers)
     {
-        std::vector<uint64_t> prime_rich(100000);
+        neon_mem::vector<uint64_t> prime_rich(100000);
         for (size_t i = 0; i < prime_rich.size(); i++) {
             prime_rich[i] = i * 2 + 1;
         }
@@ -367,13 +273,19 @@ int main() {
         std::cout << "DATASET: " << name << "\n";
         std::cout << std::string(70, '-') << "\n";
 
-        // Warm up
+        // Warm up (the engine keeps its learned costs across runs)
+        neon_adaptive::AdaptiveEngine engine;
         for (int i = 0; i < 3; i++) {
-            pipeline_adaptive(data);
+            pipeline_adaptive(engine, data);
         }
 
-        // Benchmark adaptive pipeline
-        auto stats = pipeline_adaptive(data);
+        // Fixed depths for reference, then the adaptive engine
+        for (auto d : {neon_adaptive::Depth::Wheel, neon_adaptive::Depth::Wheel8,
+                       neon_adaptive::Depth::Full16}) {
+            print_stats(std::string("Fixed ") + depth_name(d), pipeline_fixed(d, data));
+            std::cout << "\n";
+        }
+        auto stats = pipeline_adaptive(engine, data);
         print_stats("Adaptive Pipeline", stats);
 
         // Test threaded version
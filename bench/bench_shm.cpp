@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "buffer.hpp"
+#include "prime8.h"
+#include "prime8_wire.h"
+#include "shm_ring.hpp"
+
+// Round-trip cost of filtering one request out of process, per transport:
+//   pipe : bench/hybrid_driver, request and bitmap copied through two pipes
+//   shm  : tools/prime8-shmd, candidates and bitmap stay in a shared ring
+// plus the in-process call as the floor. Both helpers are started from the
+// directory this binary lives in (the build directory).
+//
+//   ./build/bench_shm [kernel]
+
+using bench_clock = std::chrono::steady_clock;
+
+namespace {
+
+double ms_since(bench_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(bench_clock::now() - t0).count();
+}
+
+bool read_full(int fd, void* dst, size_t n) {
+  uint8_t* p = static_cast<uint8_t*>(dst);
+  while (n) {
+    const ssize_t r = ::read(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return false;
+    p += r;
+    n -= static_cast<size_t>(r);
+  }
+  return true;
+}
+
+bool write_full(int fd, const void* src, size_t n) {
+  const uint8_t* p = static_cast<const uint8_t*>(src);
+  while (n) {
+    const ssize_t w = ::write(fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return false;
+    p += w;
+    n -= static_cast<size_t>(w);
+  }
+  return true;
+}
+
+pid_t spawn(const std::string& exe, const std::vector<std::string>& args, int in_fd, int out_fd) {
+  const pid_t pid = ::fork();
+  if (pid != 0) return pid;
+  if (in_fd >= 0) ::dup2(in_fd, STDIN_FILENO);
+  if (out_fd >= 0) ::dup2(out_fd, STDOUT_FILENO);
+  std::vector<char*> argv{const_cast<char*>(exe.c_str())};
+  for (const auto& a : args) argv.push_back(const_cast<char*>(a.c_str()));
+  argv.push_back(nullptr);
+  ::execv(exe.c_str(), argv.data());
+  std::fprintf(stderr, "cannot run %s: %s\n", exe.c_str(), std::strerror(errno));
+  ::_exit(127);
+}
+
+struct PipeDriver {
+  int to = -1, from = -1;
+  pid_t pid = -1;
+
+  bool start(const std::string& exe) {
+    // Close-on-exec, so prime8-shmd does not inherit the write end and keep
+    // the driver's stdin open.
+    int a[2], b[2];
+    if (::pipe(a) != 0 || ::pipe(b) != 0) return false;
+    for (int fd : {a[0], a[1], b[0], b[1]}) ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    pid = spawn(exe, {}, a[0], b[1]);
+    ::close(a[0]);
+    ::close(b[1]);
+    to = a[1];
+    from = b[0];
+    return pid > 0;
+  }
+
+  // Returns survivors, or -1 if the driver failed.
+  int64_t filter(int kernel, const uint64_t* numbers, size_t n, uint8_t* bitmap) {
+    const prime8_request req{PRIME8_REQUEST_MAGIC, static_cast<uint8_t>(kernel),
+                             PRIME8_OUT_BITMAP, 0, n};
+    prime8_response h;
+    if (!write_full(to, &req, sizeof(req)) || !write_full(to, numbers, n * sizeof(uint64_t)) ||
+        !read_full(from, &h, sizeof(h)) || h.status != PRIME8_STATUS_OK ||
+        h.payload_bytes != (n + 7) / 8 || !read_full(from, bitmap, h.payload_bytes)) {
+      return -1;
+    }
+    return static_cast<int64_t>(h.survivors);
+  }
+
+  void stop() {
+    if (to >= 0) ::close(to);  // EOF: the driver exits cleanly
+    if (from >= 0) ::close(from);
+    if (pid > 0) ::waitpid(pid, nullptr, 0);
+    to = from = pid = -1;
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* kname = argc > 1 ? argv[1] : "wheel30";
+  int kernel = -1;
+  for (int k = 0; prime8_kernel_name(k); ++k) {
+    if (std::strcmp(kname, prime8_kernel_name(k)) == 0) kernel = k;
+  }
+  if (kernel < 0) {
+    std::fprintf(stderr, "Usage: %s [wheel30|wheel210|barrett16|sieve|prime]\n", argv[0]);
+    return 1;
+  }
+
+  std::string dir = argv[0];
+  dir = dir.find('/') == std::string::npos ? "." : dir.substr(0, dir.rfind('/'));
+  const std::string sock = "/tmp/prime8-bench-shm-" + std::to_string(::getpid()) + ".sock";
+  const size_t sizes[] = {size_t(1) << 10, size_t(1) << 16, size_t(1) << 24};
+  const size_t max_n = sizes[2];
+
+  PipeDriver pipe;
+  if (!pipe.start(dir + "/hybrid_driver")) return 2;
+  const pid_t shmd = spawn(dir + "/prime8-shmd", {"-s", sock}, -1, -1);
+  neon_shm::RingClient ring;
+  for (int tries = 0; tries < 100 && !ring.connect(sock, max_n); ++tries) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  if (!ring.error().empty()) {
+    std::fprintf(stderr, "prime8-shmd: %s\n", ring.error().c_str());
+    pipe.stop();
+    ::kill(shmd, SIGTERM);
+    ::waitpid(shmd, nullptr, 0);
+    return 2;
+  }
+
+  std::mt19937_64 rng(36);
+  neon_mem::vector<uint64_t> numbers(max_n);
+  for (auto& v : numbers) v = rng() & 0xffffffffu;
+  neon_mem::vector<uint8_t> bitmap(max_n / 8, 0), expect(max_n / 8, 0);
+
+  std::printf("Out-of-process filtering, kernel %s (best round trip per request)\n", kname);
+  std::printf("%10s %8s %12s %12s %12s %10s %10s\n", "numbers", "reps", "in-proc ms",
+              "pipe ms", "shm ms", "pipe Mn/s", "shm Mn/s");
+
+  bool ok = true;
+  for (size_t n : sizes) {
+    const int reps = static_cast<int>(std::clamp<size_t>((size_t(1) << 25) / n, 3, 2000));
+    const size_t bytes = (n + 7) / 8;
+    double local = 1e300, via_pipe = 1e300, via_shm = 1e300;
+
+    for (int r = 0; r < reps; ++r) {
+      const auto t0 = bench_clock::now();
+      prime8_filter_bitmap(kernel, numbers.data(), n, expect.data(), PRIME8_PARALLEL);
+      local = std::min(local, ms_since(t0));
+    }
+    uint64_t want = 0;
+    for (size_t i = 0; i < bytes; ++i) want += __builtin_popcount(expect[i]);
+
+    for (int r = 0; r < reps && ok; ++r) {
+      const auto t0 = bench_clock::now();
+      const int64_t got = pipe.filter(kernel, numbers.data(), n, bitmap.data());
+      via_pipe = std::min(via_pipe, ms_since(t0));
+      ok = got == static_cast<int64_t>(want) && std::memcmp(bitmap.data(), expect.data(), bytes) == 0;
+    }
+
+    // The producer writes its candidates into the ring once; that write is
+    // timed here, standing in for whatever generated them.
+    for (int r = 0; r < reps && ok; ++r) {
+      const auto t0 = bench_clock::now();
+      uint64_t* slot = ring.reserve(n);
+      if (!slot) {
+        ok = false;
+        break;
+      }
+      std::memcpy(slot, numbers.data(), n * sizeof(uint64_t));
+      const auto res = ring.wait(ring.submit(static_cast<unsigned>(kernel), n));
+      via_shm = std::min(via_shm, ms_since(t0));
+      ok = res.bitmap && res.status == PRIME8_STATUS_OK && res.survivors == want &&
+           std::memcmp(res.bitmap, expect.data(), bytes) == 0;
+    }
+    if (!ok) {
+      std::fprintf(stderr, "mismatch or transport failure at %zu numbers %s\n", n,
+                   ring.error().c_str());
+      break;
+    }
+    std::printf("%10zu %8d %12.4f %12.4f %12.4f %10.1f %10.1f\n", n, reps, local, via_pipe,
+                via_shm, n / via_pipe / 1e3, n / via_shm / 1e3);
+  }
+
+  ring.close();
+  pipe.stop();
+  ::kill(shmd, SIGTERM);
+  ::waitpid(shmd, nullptr, 0);
+  return ok ? 0 : 3;
+}
@@ -1,3 +1,4 @@
+#include "buffer.hpp"
 #include "simd_fast.hpp"
 
 #include <algorithm>
@@ -14,7 +15,7 @@ struct Result {
     size_t survivors{};
 };
 
-Result run_scalar(const std::vector<uint64_t>& numbers) {
+Result run_scalar(const neon_mem::vector<uint64_t>& numbers) {
     auto start = Clock::now();
     size_t survivors = 0;
     for (uint32_t n : numbers) {
@@ -31,9 +32,9 @@ Result run_scalar(const std::vector<uint64_t>& numbers) {
     return {secs, survivors};
 }
 
-Result run_wheel30(const std::vector<uint64_t>& numbers) {
+Result run_wheel30(const neon_mem::vector<uint64_t>& numbers) {
     const size_t n = numbers.size();
-    std::vector<uint8_t> bitmap((n + 7) / 8);
+    neon_mem::vector<uint8_t> bitmap((n + 7) / 8, 0);
     auto start = Clock::now();
     neon_wheel::filter_stream_u64_wheel_bitmap(numbers.data(), bitmap.data(), n);
     auto stop = Clock::now();
@@ -51,7 +52,7 @@ int main(int argc, char** argv) {
 
     std::mt19937_64 rng(42);
     std::uniform_int_distribution<uint32_t> dist(0, 0xffffffffu);
-    std::vector<uint64_t> numbers(count);
+    neon_mem::vector<uint64_t> numbers(count);
     for (auto& v : numbers) v = dist(rng);
 
     auto scalar = run_scalar(numbers);
@@ -0,0 +1,212 @@
+#include "harness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "autotune.hpp"
+#include "primes_tables.hpp"
+
+namespace prime8_bench {
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+// === Scalar references ===
+
+// Survives trial division by the first `depth` of 2..53 (a value equal to one
+// of those primes survives); values above 32 bits never survive.
+template <int depth>
+bool trial_division(uint64_t v) {
+  if (v > 0xffffffffu) return false;
+  const uint32_t n = static_cast<uint32_t>(v);
+  for (int i = 0; i < depth; ++i) {
+    const uint32_t p = i < 8 ? SMALL_PRIMES[i] : EXT_PRIMES[i - 8];
+    if (n != p && n % p == 0) return false;
+  }
+  return true;
+}
+
+void scalar_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict out, size_t count) {
+  for (size_t i = 0; i < count; ++i) out[i] = trial_division<16>(numbers[i]);
+}
+
+bool is_prime(uint64_t v) { return neon_mr::is_prime_64(v); }
+
+template <neon_adaptive::Depth depth>
+void depth_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap, size_t count) {
+  neon_adaptive::filter_stream_u64_depth_bitmap(depth, numbers, bitmap, count);
+}
+
+void sieve_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap, size_t count) {
+  neon_block_sieve::filter_stream_u64_sieve_bitmap(numbers, bitmap, count);
+}
+
+void fused_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap, size_t count) {
+  neon_fused::fused_prime_bitmap(numbers, bitmap, count);
+}
+
+} // namespace
+
+const std::vector<Kernel>& kernels() {
+  using neon_adaptive::Depth;
+  static const std::vector<Kernel> k = {
+    {"scalar", "reference", Output::Bytes, scalar_kernel, trial_division<16>, 16},
+    {"barrett16", "barrett", Output::Bytes, neon_fast::filter_stream_u64_barrett16,
+     trial_division<16>, 16},
+    {"barrett16_bitmap", "barrett", Output::Bitmap, neon_fast::filter_stream_u64_barrett16_bitmap,
+     trial_division<16>, 16},
+    {"barrett16_ultra", "barrett", Output::Bytes, neon_ultra::filter_stream_u64_barrett16_ultra,
+     trial_division<16>, 16},
+    {"barrett16_final", "barrett", Output::Bytes, neon_final::filter_stream_u64_barrett16_final,
+     trial_division<16>, 16},
+    {"wheel", "wheel", Output::Bytes, neon_wheel::filter_stream_u64_wheel, trial_division<16>, 16},
+    {"wheel_bitmap", "wheel", Output::Bitmap, neon_wheel::filter_stream_u64_wheel_bitmap,
+     trial_division<16>, 16},
+    {"wheel_tuned", "wheel", Output::Bitmap, neon_tune::filter_wheel_bitmap,
+     trial_division<16>, 16},
+    {"wheel_optimized", "wheel", Output::Bitmap, neon_optimized::filter_stream_u64_wheel_optimized,
+     trial_division<16>, 16},
+    {"wheel210", "wheel210", Output::Bitmap, neon_wheel210::filter_stream_u64_wheel210_bitmap,
+     trial_division<16>, 16},
+    {"wheel210_efficient", "wheel210", Output::Bitmap,
+     neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap, trial_division<16>, 16},
+    {"small_wheel", "small", Output::Bytes, neon_small::filter_small_u64_wheel,
+     trial_division<16>, 16},
+    {"small_wheel_bitmap", "small", Output::Bitmap, neon_small::filter_small_u64_wheel_bitmap,
+     trial_division<16>, 16},
+    {"sieve", "sieve", Output::Bitmap, sieve_kernel, trial_division<16>, 16},
+    {"depth_wheel", "depth", Output::Bitmap, depth_kernel<Depth::Wheel>, trial_division<3>, 3},
+    {"depth_wheel8", "depth", Output::Bitmap, depth_kernel<Depth::Wheel8>, trial_division<8>, 8},
+    {"fused_prime", "fused", Output::Bitmap, fused_kernel, is_prime, 0},
+  };
+  return k;
+}
+
+std::span<const Dataset> datasets() { return neon_data::all(); }
+
+namespace {
+
+template <class T, class Match>
+std::vector<const T*> select(std::span<const T> all, const std::string& list,
+                             std::string& unknown, Match&& match) {
+  std::vector<const T*> out;
+  unknown.clear();
+  if (list.empty() || list == "all") {
+    for (const T& x : all) out.push_back(&x);
+    return out;
+  }
+  size_t pos = 0;
+  while (pos <= list.size()) {
+    const size_t comma = std::min(list.find(',', pos), list.size());
+    const std::string name = list.substr(pos, comma - pos);
+    bool found = false;
+    for (const T& x : all) {
+      if (!match(x, name)) continue;
+      found = true;
+      if (std::find(out.begin(), out.end(), &x) == out.end()) out.push_back(&x);
+    }
+    if (!found && !name.empty()) unknown += (unknown.empty() ? "" : ",") + name;
+    pos = comma + 1;
+  }
+  return out;
+}
+
+} // namespace
+
+std::vector<const Kernel*> select_kernels(const std::string& list, std::string& unknown) {
+  return select<Kernel>(kernels(), list, unknown, [](const Kernel& k, const std::string& name) {
+    return name == k.name || name == k.group;
+  });
+}
+
+std::vector<const Dataset*> select_datasets(const std::string& list, std::string& unknown) {
+  return select<Dataset>(datasets(), list, unknown,
+                [](const Dataset& d, const std::string& name) { return name == d.name; });
+}
+
+void run_kernel(const Kernel& k, const uint64_t* numbers, uint8_t* out, size_t count, bool pool) {
+  if (pool) {
+    neon_parallel::parallel_filter_stream(k.fn, k.output == Output::Bitmap, numbers, out, count);
+  } else {
+    k.fn(numbers, out, count);
+  }
+}
+
+Samples measure(const Kernel& k, const uint64_t* numbers, uint8_t* out, size_t count,
+                const RunOptions& opts) {
+  Samples s;
+  for (int i = 0; i < opts.warmup; ++i) run_kernel(k, numbers, out, count, opts.pool);
+
+  // Small inputs finish far below the clock's useful resolution; batch calls
+  // so each sample spans at least min_sample_ms.
+  const auto t0 = bench_clock::now();
+  run_kernel(k, numbers, out, count, opts.pool);
+  const double one_ns = std::chrono::duration<double, std::nano>(bench_clock::now() - t0).count();
+  const double target_ns = opts.min_sample_ms * 1e6;
+  if (one_ns < target_ns) {
+    s.calls_per_sample = static_cast<size_t>(target_ns / std::max(one_ns, 1.0)) + 1;
+  }
+
+  // Counters stay enabled across the samples but are toggled outside the
+  // timed regions, so the ioctls never land in a sample.
+  s.ns.reserve(opts.reps);
+  if (opts.counters) opts.counters->start();
+  for (int r = 0; r < opts.reps; ++r) {
+    const auto start = bench_clock::now();
+    for (size_t c = 0; c < s.calls_per_sample; ++c) run_kernel(k, numbers, out, count, opts.pool);
+    const double ns = std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+    s.ns.push_back(ns / s.calls_per_sample);
+  }
+  if (opts.counters) {
+    s.counters = derive(opts.counters->stop(),
+                        double(count) * double(s.calls_per_sample) * opts.reps);
+  }
+  return s;
+}
+
+namespace {
+
+double median_of(std::vector<double>& v) {
+  const size_t n = v.size();
+  std::nth_element(v.begin(), v.begin() + n / 2, v.end());
+  const double hi = v[n / 2];
+  if (n % 2) return hi;
+  return (*std::max_element(v.begin(), v.begin() + n / 2) + hi) / 2;
+}
+
+} // namespace
+
+Stats summarize(std::vector<double> samples) {
+  Stats st;
+  st.n = samples.size();
+  if (samples.empty()) return st;
+  st.min = *std::min_element(samples.begin(), samples.end());
+  st.max = *std::max_element(samples.begin(), samples.end());
+  double sum = 0;
+  for (double x : samples) sum += x;
+  st.mean = sum / samples.size();
+  st.median = median_of(samples);
+  for (double& x : samples) x = std::abs(x - st.median);
+  st.mad = median_of(samples);
+  return st;
+}
+
+size_t parse_size(const std::string& s) {
+  if (s.empty()) return 0;
+  if (s.size() > 2 && s[0] == '2' && s[1] == '^') {
+    const unsigned long e = std::strtoul(s.c_str() + 2, nullptr, 10);
+    return e < 63 ? size_t(1) << e : 0;
+  }
+  char* end = nullptr;
+  const double v = std::strtod(s.c_str(), &end);
+  double scale = 1;
+  if (*end == 'k' || *end == 'K') scale = 1e3, ++end;
+  else if (*end == 'M') scale = 1e6, ++end;
+  else if (*end == 'G') scale = 1e9, ++end;
+  if (*end != '\0' || v <= 0) return 0;
+  return static_cast<size_t>(v * scale);
+}
+
+} // namespace prime8_bench
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "datasets.hpp"
+#include "perf_counters.hpp"
+#include "simd_fast.hpp"
+
+// Shared pieces of prime8_bench: what can be measured (kernels, datasets),
+// how a measurement is taken, and how samples are summarised.
+namespace prime8_bench {
+
+// === Registries ===
+
+enum class Output { Bytes, Bitmap };
+
+struct Kernel {
+  const char* name;
+  const char* group;    // reference, barrett, wheel, wheel210, small, sieve, depth, fused
+  Output output;
+  neon_stream::StreamKernel fn;
+  bool (*expect)(uint64_t v);  // scalar definition of a survivor, for verification
+  int depth;            // expect tests the first `depth` of 2..53; 0 = exact primality
+};
+
+// Inputs come from the library's generator (src/datasets.hpp).
+using neon_data::Dataset;
+
+const std::vector<Kernel>& kernels();
+std::span<const Dataset> datasets();
+
+// Kernels whose name or group is in the comma-separated list ("all" or empty
+// selects everything). Unknown names are returned in `unknown`.
+std::vector<const Kernel*> select_kernels(const std::string& list, std::string& unknown);
+std::vector<const Dataset*> select_datasets(const std::string& list, std::string& unknown);
+
+// Survivor flag i of a kernel's output, whichever layout it uses.
+inline bool survives(const Kernel& k, const uint8_t* out, size_t i) {
+  return k.output == Output::Bytes ? out[i] != 0 : (out[i >> 3] >> (i & 7)) & 1;
+}
+
+// === Measurement ===
+
+struct RunOptions {
+  int warmup = 2;             // untimed calls before sampling
+  int reps = 15;              // samples
+  double min_sample_ms = 2.0; // calls are batched until one sample takes this long
+  bool pool = false;          // run through neon_parallel::parallel_filter_stream
+  PerfCounters* counters = nullptr;  // counted over all samples when set
+};
+
+// Per-call wall times in nanoseconds, one per sample.
+struct Samples {
+  std::vector<double> ns;
+  size_t calls_per_sample = 1;
+  CounterReport counters;     // per number over every timed call
+};
+
+Samples measure(const Kernel& k, const uint64_t* numbers, uint8_t* out, size_t count,
+                const RunOptions& opts);
+
+void run_kernel(const Kernel& k, const uint64_t* numbers, uint8_t* out, size_t count, bool pool);
+
+struct Stats {
+  double median = 0;
+  double mad = 0;    // median absolute deviation from the median
+  double min = 0;
+  double max = 0;
+  double mean = 0;
+  size_t n = 0;
+};
+
+Stats summarize(std::vector<double> samples);
+
+// Parses "4096", "64k", "16M", "1G" or "2^24"; 0 on error.
+size_t parse_size(const std::string& s);
+
+} // namespace prime8_bench
@@ -1,44 +1,134 @@
-#include "simd_fast.hpp"
+// Long-lived filter co-process for bench_hybrid.py (and any other caller that
+// wants the kernels without linking them).
+//
+// The driver reads framed requests from stdin and answers each one on stdout
+// until stdin closes, so one process serves any number of datasets, modes and
+// sizes. The framing (src/prime8_wire.h) is shared with tools/prime8d.
+#include "prime8.h"
+#include "prime8_wire.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstddef>
 #include <cstdint>
-#include <iostream>
-#include <string>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 
+#include <unistd.h>
+
+namespace {
+
+// Returns bytes read; short only at EOF (or on error, which ends the session).
+size_t read_full(void* dst, size_t n) {
+    uint8_t* p = static_cast<uint8_t*>(dst);
+    size_t got = 0;
+    while (got < n) {
+        const ssize_t r = ::read(STDIN_FILENO, p + got, n - got);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += static_cast<size_t>(r);
+    }
+    return got;
+}
+
+bool write_full(const void* src, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(src);
+    while (n) {
+        const ssize_t w = ::write(STDOUT_FILENO, p, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return false;
+        p += w;
+        n -= static_cast<size_t>(w);
+    }
+    return true;
+}
+
+bool respond(uint32_t status, uint64_t survivors, const void* payload, uint64_t bytes) {
+    const prime8_response h{PRIME8_RESPONSE_MAGIC, status, survivors, bytes};
+    return write_full(&h, sizeof(h)) && write_full(payload, bytes);
+}
+
+} // namespace
+
 int main(int argc, char** argv) {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <wheel30|wheel210> <count>\n";
+    if (argc != 1) {
+        std::fprintf(stderr, "Usage: %s  (framed requests on stdin, see hybrid_driver.cpp)\n",
+                     argv[0]);
         return 1;
     }
 
-    const std::string mode = argv[1];
-    const size_t count = static_cast<size_t>(std::strtoull(argv[2], nullptr, 10));
+    // Reused across requests; they only ever grow.
+    std::vector<uint64_t> numbers;
+    std::vector<uint8_t> bitmap;
+    std::vector<uint64_t> survivors;
 
-    std::vector<uint64_t> numbers(count);
-    const size_t bytes = count * sizeof(uint64_t);
-    if (!std::cin.read(reinterpret_cast<char*>(numbers.data()), bytes)) {
-        std::cerr << "Failed to read " << bytes << " bytes from stdin\n";
-        return 2;
-    }
+    for (;;) {
+        prime8_request req;
+        const size_t got = read_full(&req, sizeof(req));
+        if (got == 0) return 0;  // caller closed stdin: clean shutdown
+        if (got != sizeof(req)) {
+            std::fprintf(stderr, "hybrid_driver: truncated request header\n");
+            return 2;
+        }
+        if (req.magic != PRIME8_REQUEST_MAGIC) {
+            respond(PRIME8_STATUS_BAD_MAGIC, 0, nullptr, 0);
+            std::fprintf(stderr, "hybrid_driver: bad request magic 0x%08x\n", req.magic);
+            return 3;
+        }
+        if (req.count > PRIME8_MAX_COUNT) {
+            // Unread payload: the stream cannot be resynchronized.
+            respond(PRIME8_STATUS_TOO_LARGE, 0, nullptr, 0);
+            std::fprintf(stderr, "hybrid_driver: request of %llu numbers over the limit\n",
+                         static_cast<unsigned long long>(req.count));
+            return 3;
+        }
 
-    std::vector<uint8_t> bitmap((count + 7) / 8);
+        const size_t count = static_cast<size_t>(req.count);
+        if (numbers.size() < count) numbers.resize(count);
+        if (read_full(numbers.data(), count * sizeof(uint64_t)) != count * sizeof(uint64_t)) {
+            std::fprintf(stderr, "hybrid_driver: truncated payload (%zu numbers)\n", count);
+            return 2;
+        }
 
-    if (mode == "wheel30") {
-        neon_wheel::filter_stream_u64_wheel_bitmap(numbers.data(), bitmap.data(), count);
-    } else if (mode == "wheel210") {
-        neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap(
-            numbers.data(), bitmap.data(), count);
-    } else {
-        std::cerr << "Unknown mode '" << mode << "'\n";
-        return 3;
-    }
+        const bool known = prime8_kernel_name(req.mode) != nullptr;
+        if (!known || req.output > PRIME8_OUT_COUNT) {
+            const uint32_t status = known ? PRIME8_STATUS_BAD_OUTPUT : PRIME8_STATUS_BAD_MODE;
+            if (!respond(status, 0, nullptr, 0)) return 2;
+            continue;
+        }
 
-    for (size_t i = 0; i < count; ++i) {
-        if (bitmap[i >> 3] & (1u << (i & 7))) {
-            std::cout << numbers[i] << '\n';
+        const size_t bytes = (count + 7) / 8;
+        if (bitmap.size() < bytes) bitmap.resize(bytes);
+        if (prime8_filter_bitmap(req.mode, numbers.data(), count, bitmap.data(), 0) != PRIME8_OK) {
+            // The bitmap was not written; the stream is still in sync.
+            if (!respond(PRIME8_STATUS_FAILED, 0, nullptr, 0)) return 2;
+            continue;
         }
-    }
+        // The bitmap is reused across requests: only bits < count are this one's.
+        if (count & 7) bitmap[bytes - 1] &= uint8_t((1u << (count & 7)) - 1);
+
+        uint64_t nsurv = 0;
+        for (size_t i = 0; i < bytes; ++i) nsurv += __builtin_popcount(bitmap[i]);
 
-    return 0;
+        bool ok = true;
+        if (req.output == PRIME8_OUT_BITMAP) {
+            ok = respond(PRIME8_STATUS_OK, nsurv, bitmap.data(), bytes);
+        } else if (req.output == PRIME8_OUT_COUNT) {
+            ok = respond(PRIME8_STATUS_OK, nsurv, nullptr, 0);
+        } else {
+            if (survivors.size() < nsurv) survivors.resize(nsurv);
+            size_t k = 0;
+            for (size_t w = 0; w * 8 < bytes; ++w) {
+                uint64_t word = 0;
+                std::memcpy(&word, bitmap.data() + w * 8, std::min<size_t>(8, bytes - w * 8));
+                while (word) {
+                    survivors[k++] = numbers[w * 64 + __builtin_ctzll(word)];
+                    word &= word - 1;
+                }
+            }
+            ok = respond(PRIME8_STATUS_OK, nsurv, survivors.data(), nsurv * sizeof(uint64_t));
+        }
+        if (!ok) return 2;  // caller went away
+    }
 }
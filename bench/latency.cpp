@@ -0,0 +1,77 @@
+#include "latency.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace prime8_bench {
+
+double ticks_per_ns() {
+  static const double rate = [] {
+#if defined(__aarch64__)
+    uint64_t freq;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(freq));
+    return double(freq) / 1e9;
+#elif defined(__x86_64__) || defined(__i386__)
+    // The invariant TSC rate over a 20 ms spin.
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    const uint64_t c0 = read_ticks();
+    while (clock::now() - t0 < std::chrono::milliseconds(20)) {
+    }
+    const uint64_t c1 = read_ticks();
+    const double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+    return double(c1 - c0) / ns;
+#else
+    return 1.0;
+#endif
+  }();
+  return rate;
+}
+
+double timer_overhead_ns() {
+  static const double overhead = [] {
+    std::vector<uint64_t> d(1001);
+    for (uint64_t& x : d) {
+      const uint64_t t0 = read_ticks();
+      x = read_ticks() - t0;
+    }
+    std::nth_element(d.begin(), d.begin() + d.size() / 2, d.end());
+    return d[d.size() / 2] / ticks_per_ns();
+  }();
+  return overhead;
+}
+
+Latency measure_latency(const Kernel& k, const uint64_t* numbers, size_t pool, uint8_t* out,
+                        size_t batch, const LatencyOptions& opts) {
+  Latency lat;
+  if (!batch || batch > pool || !opts.calls) return lat;
+  const size_t slots = pool / batch;
+
+  for (size_t c = 0; c < opts.warmup; ++c) k.fn(numbers + (c % slots) * batch, out, batch);
+
+  std::vector<uint64_t> ticks(opts.calls);
+  for (size_t c = 0; c < opts.calls; ++c) {
+    const uint64_t* in = numbers + (c % slots) * batch;
+    const uint64_t t0 = read_ticks();
+    k.fn(in, out, batch);
+    ticks[c] = read_ticks() - t0;
+  }
+  std::sort(ticks.begin(), ticks.end());
+
+  // Nearest-rank percentiles.
+  const double scale = 1.0 / ticks_per_ns();
+  auto pct = [&](double q) {
+    const size_t rank = static_cast<size_t>(std::ceil(q * ticks.size()));
+    return ticks[std::clamp<size_t>(rank, 1, ticks.size()) - 1] * scale;
+  };
+  lat.p50 = pct(0.50);
+  lat.p90 = pct(0.90);
+  lat.p99 = pct(0.99);
+  lat.p999 = pct(0.999);
+  lat.max = ticks.back() * scale;
+  lat.calls = opts.calls;
+  return lat;
+}
+
+} // namespace prime8_bench
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include "harness.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Per-call latency distributions for small batches, where one call is far
+// below steady_clock's useful resolution and the tail matters more than the
+// mean. Each call is timed on its own with the CPU's tick counter: cntvct_el0
+// on arm64 (24 MHz on Apple silicon, so ~42 ns steps), rdtsc on x86.
+namespace prime8_bench {
+
+// === Tick counter ===
+
+inline uint64_t read_ticks() {
+#if defined(__aarch64__)
+  uint64_t t;
+  asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(t) : : "memory");
+  return t;
+#elif defined(__x86_64__) || defined(__i386__)
+  _mm_lfence();
+  const uint64_t t = __rdtsc();
+  _mm_lfence();
+  return t;
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Tick rate: cntfrq_el0 on arm64, calibrated against steady_clock elsewhere.
+double ticks_per_ns();
+
+// Median cost of an empty read_ticks() pair, in ns. Not subtracted from the
+// results; reported so small-batch figures can be read against it.
+double timer_overhead_ns();
+
+// === Measurement ===
+
+// Calls cycle through a pool of this many numbers, so consecutive calls see
+// different batches, as a service does, while the pool stays in L2.
+constexpr size_t kLatencyPool = size_t(1) << 16;
+
+struct LatencyOptions {
+  size_t calls = 20000;   // timed calls per row
+  size_t warmup = 500;    // untimed calls first
+};
+
+struct Latency {
+  double p50 = 0;         // ns per call
+  double p90 = 0;
+  double p99 = 0;
+  double p999 = 0;
+  double max = 0;
+  size_t calls = 0;
+};
+
+// Times `calls` serial calls of k on `batch` numbers each, taken in turn from
+// numbers[0, pool). out needs room for one batch of output.
+Latency measure_latency(const Kernel& k, const uint64_t* numbers, size_t pool, uint8_t* out,
+                        size_t batch, const LatencyOptions& opts);
+
+} // namespace prime8_bench
@@ -0,0 +1,135 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace prime8_bench {
+
+const char* counter_name(int c) {
+  static const char* const kNames[kNumCounters] = {
+    "cycles", "instructions", "L1D-read-misses", "LLC-read-misses", "branch-misses",
+    "dTLB-read-misses",
+  };
+  return c >= 0 && c < kNumCounters ? kNames[c] : "?";
+}
+
+#if defined(__linux__)
+
+namespace {
+
+struct EventSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t cache_event(uint64_t cache) {
+  return cache | (uint64_t(PERF_COUNT_HW_CACHE_OP_READ) << 8) |
+         (uint64_t(PERF_COUNT_HW_CACHE_RESULT_MISS) << 16);
+}
+
+const EventSpec kEvents[kNumCounters] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D)},
+  {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+int open_event(const EventSpec& e) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = e.type;
+  attr.config = e.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  int first_errno = 0;
+  for (int c = 0; c < kNumCounters; ++c) {
+    fd_[c] = open_event(kEvents[c]);
+    if (fd_[c] >= 0) ++opened_;
+    else if (!first_errno) first_errno = errno;
+  }
+  if (!opened_) {
+    error_ = std::string("perf_event_open: ") + std::strerror(first_errno);
+    if (first_errno == EACCES || first_errno == EPERM) {
+      error_ += " (see /proc/sys/kernel/perf_event_paranoid)";
+    } else if (first_errno == ENOENT || first_errno == ENODEV || first_errno == EOPNOTSUPP) {
+      error_ += " (no hardware PMU exposed here)";
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fd_) {
+    if (fd >= 0) ::close(fd);
+  }
+}
+
+void PerfCounters::start() {
+  for (int fd : fd_) {
+    if (fd < 0) continue;
+    ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+CounterValues PerfCounters::stop() {
+  CounterValues v;
+  for (int fd : fd_) {
+    if (fd >= 0) ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+  for (int c = 0; c < kNumCounters; ++c) {
+    uint64_t buf[3];  // value, time_enabled, time_running
+    if (fd_[c] < 0 || ::read(fd_[c], buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) continue;
+    v.valid[c] = true;
+    v.value[c] = buf[2] < buf[1] ? double(buf[0]) * double(buf[1]) / double(buf[2])
+                                 : double(buf[0]);
+  }
+  return v;
+}
+
+#else
+
+PerfCounters::PerfCounters() : error_("perf_event_open is Linux-only") {
+  for (int& fd : fd_) fd = -1;
+}
+PerfCounters::~PerfCounters() = default;
+void PerfCounters::start() {}
+CounterValues PerfCounters::stop() { return {}; }
+
+#endif
+
+CounterReport derive(const CounterValues& v, double numbers) {
+  CounterReport r;
+  if (numbers <= 0) return r;
+  auto per_1k = [&](int c) { return v.valid[c] ? v.value[c] * 1000.0 / numbers : -1.0; };
+  if (v.valid[kCycles]) r.cycles_per_number = v.value[kCycles] / numbers;
+  if (v.valid[kInstructions]) r.insns_per_number = v.value[kInstructions] / numbers;
+  if (v.valid[kCycles] && v.valid[kInstructions] && v.value[kCycles] > 0) {
+    r.ipc = v.value[kInstructions] / v.value[kCycles];
+  }
+  r.l1d_per_1k = per_1k(kL1dMisses);
+  r.llc_per_1k = per_1k(kLlcMisses);
+  r.branch_per_1k = per_1k(kBranchMisses);
+  r.dtlb_per_1k = per_1k(kDtlbMisses);
+  for (bool b : v.valid) r.any = r.any || b;
+  return r;
+}
+
+} // namespace prime8_bench
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hardware event counts around a measured region, via perf_event_open(2).
+//
+// Each event is opened on its own (not as one group), so a PMU with fewer
+// programmable counters than events multiplexes them instead of refusing
+// the whole set; counts are scaled by time_enabled / time_running. Only
+// user-space events of the calling thread are counted, which
+// perf_event_paranoid <= 2 allows. Events the kernel or the CPU does not
+// offer (no PMU in a container or VM, seccomp, paranoid 3, macOS) are
+// reported as unavailable rather than failing the run.
+namespace prime8_bench {
+
+enum Counter : int {
+  kCycles,
+  kInstructions,
+  kL1dMisses,
+  kLlcMisses,
+  kBranchMisses,
+  kDtlbMisses,
+  kNumCounters,
+};
+
+const char* counter_name(int c);
+
+struct CounterValues {
+  bool valid[kNumCounters] = {};
+  double value[kNumCounters] = {};
+};
+
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // True if at least one event could be opened; otherwise why not.
+  bool available() const { return opened_ > 0; }
+  const std::string& error() const { return error_; }
+
+  void start();                // reset and enable
+  CounterValues stop();        // disable and read
+
+private:
+  int fd_[kNumCounters];
+  int opened_ = 0;
+  std::string error_;
+};
+
+// Derived per-number metrics for one measured region of `numbers` inputs.
+struct CounterReport {
+  bool any = false;
+  double ipc = -1;                 // < 0 where the inputs were unavailable
+  double cycles_per_number = -1;
+  double insns_per_number = -1;
+  double l1d_per_1k = -1;          // misses per 1000 numbers
+  double llc_per_1k = -1;
+  double branch_per_1k = -1;
+  double dtlb_per_1k = -1;
+};
+
+CounterReport derive(const CounterValues& v, double numbers);
+
+} // namespace prime8_bench
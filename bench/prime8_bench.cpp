@@ -0,0 +1,703 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include "baseline.hpp"
+#include "buffer.hpp"
+#include "harness.hpp"
+#include "latency.hpp"
+#include "stats.hpp"
+#include "thread_pool.hpp"
+
+// Single benchmark driver for the filter kernels. Every kernel in the
+// registry (harness.cpp) is timed the same way: warmup calls, then `reps`
+// samples of one or more back-to-back calls, reported as the median per call
+// with its median absolute deviation. Outputs are checked against the
+// kernel's scalar definition before timing. With -c, hardware counters
+// (perf_counters.hpp) run over the timed calls and each row also gets IPC,
+// cycles per number and misses per 1000 numbers. Counters follow the calling
+// thread only, so with -p they cover slot 0's share of the work.
+//
+// --record stores every sample with the commit, compiler and CPU
+// (baseline.hpp). --compare reruns exactly the rows and settings of a stored
+// baseline and flags each row whose samples are slower by a one-sided
+// Mann-Whitney test at --alpha and whose median moved by more than
+// --threshold percent; any such regression makes the exit status 3. A
+// per-kernel summary follows: the geometric-mean speedup over the kernel's
+// rows, which is how a PGO or LTO build is scored against a plain one.
+//
+// --stats (library built with -DPRIME8_STATS=ON) runs each row once more,
+// untimed, and reports where its lanes went (stats.hpp): the share of the
+// input dropped by the >32-bit fallback, the wheel and each prime group, and
+// the share that survives. Kernels without stats hooks show "-".
+//
+// --latency times every call on its own with the tick counter (latency.hpp)
+// and reports p50/p90/p99/p99.9/max per call instead; -n is then the batch
+// size (default 8..4096) and --calls the number of timed calls per row.
+//
+//   ./build/prime8_bench [-k kernels] [-d datasets] [-n sizes] [-r reps] [-w warmup]
+//                        [-m min_sample_ms] [-p] [-t threads] [-s seed] [-c]
+//                        [-f table|csv|json] [-o file] [--no-verify] [-l]
+//                        [--record file] [--compare file [--alpha p] [--threshold pct]]
+//                        [--latency [--calls n]] [--stats]
+//
+//   ./build/prime8_bench -k wheel,barrett16 -d uniform32 -n 4k,1M,2^24
+//   ./build/prime8_bench -f json -o results.json
+//   ./build/prime8_bench -k barrett,wheel -n 64k,16M --record main.baseline
+//   ./build/prime8_bench --compare main.baseline
+//   ./build/prime8_bench --stats -k wheel,small_wheel,barrett16 -d mixed,dense
+//   ./build/prime8_bench --latency -k wheel_bitmap,small_wheel_bitmap -n 8,64,512,4096
+
+using namespace prime8_bench;
+
+namespace {
+
+enum class Format { Table, Csv, Json };
+
+struct Row {
+  const Kernel* kernel;
+  const Dataset* dataset;
+  size_t n;
+  std::vector<double> samples;  // per call, one per sample
+  Stats ns;                 // per call
+  size_t calls_per_sample;
+  long mismatches;          // -1 = not verified
+  CounterReport counters;
+  Latency latency;          // --latency only
+  neon_stats::Snapshot stages;  // --stats only
+};
+
+struct Config {
+  std::string kernels = "all";
+  std::string datasets = "uniform32,mixed";
+  std::vector<size_t> sizes;
+  RunOptions run;
+  unsigned threads = 0;
+  uint64_t seed = 42;
+  Format format = Format::Table;
+  const char* out_path = nullptr;
+  bool verify = true;
+  bool counters = false;
+  const char* record_path = nullptr;
+  const char* compare_path = nullptr;
+  double alpha = 0.01;      // --compare significance level
+  double threshold = 5.0;   // --compare minimum median change, percent
+  bool latency = false;
+  LatencyOptions lat;
+  bool stages = false;      // --stats
+};
+
+struct Job {
+  const Kernel* kernel;
+  const Dataset* dataset;
+  size_t n;
+};
+
+double mnum_per_s(const Row& r) { return r.n / r.ns.median * 1e3; }
+double gb_per_s(const Row& r) { return r.n * sizeof(uint64_t) / r.ns.median; }
+
+const char* verify_text(const Row& r) {
+  return r.mismatches < 0 ? "-" : r.mismatches == 0 ? "ok" : "FAIL";
+}
+
+// Counter-derived columns, in table / CSV / JSON order. Negative = unavailable.
+struct Metric {
+  const char* column;
+  const char* key;
+  double CounterReport::*field;
+};
+
+const Metric kMetrics[] = {
+  {"IPC", "ipc", &CounterReport::ipc},
+  {"cyc/num", "cycles_per_number", &CounterReport::cycles_per_number},
+  {"ins/num", "insns_per_number", &CounterReport::insns_per_number},
+  {"L1D/1k", "l1d_misses_per_1k", &CounterReport::l1d_per_1k},
+  {"LLC/1k", "llc_misses_per_1k", &CounterReport::llc_per_1k},
+  {"br/1k", "branch_misses_per_1k", &CounterReport::branch_per_1k},
+  {"dTLB/1k", "dtlb_misses_per_1k", &CounterReport::dtlb_per_1k},
+};
+
+// --stats columns: percent of the row's lanes each stage drops, then the
+// survivors. They sum to 100 except for barrett16, whose groups also see the
+// low halves of wide values (stats.hpp).
+double stage_pct(const neon_stats::Snapshot& s, uint64_t v) {
+  return s.lanes ? 100.0 * v / s.lanes : -1;
+}
+
+void print_stage_header() {
+  std::printf(" %7s %7s", "wide%", "wheel%");
+  for (int g = 0; g < neon_stats::kGroups; ++g) std::printf(" %6s%%", neon_stats::group_name(g));
+  std::printf(" %7s", "surv%");
+}
+
+void print_stage_row(const neon_stats::Snapshot& s) {
+  auto cell = [&](uint64_t v) {
+    if (!s.lanes) std::printf(" %7s", "-");
+    else std::printf(" %7.2f", stage_pct(s, v));
+  };
+  cell(s.wide);
+  cell(s.wheel);
+  for (int g = 0; g < neon_stats::kGroups; ++g) cell(s.group[g]);
+  cell(s.survivors);
+}
+
+// Raw counts for CSV / JSON, keyed stage_<field>.
+template <class F>
+void each_stage(const neon_stats::Snapshot& s, F&& f) {
+  char key[32];
+  f("stage_lanes", s.lanes);
+  f("stage_wide", s.wide);
+  f("stage_wheel", s.wheel);
+  for (int g = 0; g < neon_stats::kGroups; ++g) {
+    std::snprintf(key, sizeof(key), "stage_group_%s", neon_stats::group_name(g));
+    for (char* c = key; *c; ++c) {
+      if (*c == '-') *c = '_';
+    }
+    f(key, s.group[g]);
+  }
+  f("stage_survivors", s.survivors);
+  f("stage_steps", s.steps);
+  for (int g = 0; g < neon_stats::kGroups - 1; ++g) {
+    std::snprintf(key, sizeof(key), "stage_early_out_%d", g);
+    f(key, s.early_out[g]);
+  }
+  f("stage_wheel_skips", s.wheel_skips);
+}
+
+void print_table_header(bool counters, bool stages) {
+  std::printf("%-20s %-10s %10s %12s %8s %10s %8s %8s", "kernel", "dataset", "n",
+              "median us", "mad %", "Mnum/s", "GB/s", "verify");
+  if (counters) {
+    for (const Metric& m : kMetrics) std::printf(" %8s", m.column);
+  }
+  if (stages) print_stage_header();
+  std::printf("\n");
+}
+
+void print_table_row(const Row& r, bool counters, bool stages) {
+  std::printf("%-20s %-10s %10zu %12.2f %8.2f %10.1f %8.2f %8s", r.kernel->name,
+              r.dataset->name, r.n, r.ns.median / 1e3, 100.0 * r.ns.mad / r.ns.median,
+              mnum_per_s(r), gb_per_s(r), verify_text(r));
+  if (counters) {
+    for (const Metric& m : kMetrics) {
+      const double v = r.counters.*m.field;
+      if (v < 0) std::printf(" %8s", "-");
+      else std::printf(" %8.3g", v);
+    }
+  }
+  if (stages) print_stage_row(r.stages);
+  std::printf("\n");
+}
+
+void write_csv(std::FILE* f, const std::vector<Row>& rows, bool counters, bool stages) {
+  std::fprintf(f, "kernel,group,dataset,n,reps,calls_per_sample,median_ns,mad_ns,min_ns,max_ns,"
+                  "mean_ns,mnum_s,gb_s,mismatches");
+  if (counters) {
+    for (const Metric& m : kMetrics) std::fprintf(f, ",%s", m.key);
+  }
+  if (stages) each_stage({}, [&](const char* key, uint64_t) { std::fprintf(f, ",%s", key); });
+  std::fprintf(f, "\n");
+  for (const Row& r : rows) {
+    std::fprintf(f, "%s,%s,%s,%zu,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f,%.4f,%ld",
+                 r.kernel->name, r.kernel->group, r.dataset->name, r.n, r.ns.n,
+                 r.calls_per_sample, r.ns.median, r.ns.mad, r.ns.min, r.ns.max, r.ns.mean,
+                 mnum_per_s(r), gb_per_s(r), r.mismatches);
+    if (counters) {
+      for (const Metric& m : kMetrics) {
+        const double v = r.counters.*m.field;
+        if (v < 0) std::fprintf(f, ",");
+        else std::fprintf(f, ",%.4g", v);
+      }
+    }
+    if (stages) {
+      each_stage(r.stages, [&](const char*, uint64_t v) {
+        std::fprintf(f, ",%llu", static_cast<unsigned long long>(v));
+      });
+    }
+    std::fprintf(f, "\n");
+  }
+}
+
+void write_json(std::FILE* f, const Config& cfg, const std::vector<Row>& rows) {
+  const BuildInfo& build = build_info();
+  std::fprintf(f, "{\n  \"tool\": \"prime8_bench\",\n  \"format\": 1,\n");
+  std::fprintf(f, "  \"build\": {\"commit\": \"%s\", \"compiler\": \"%s\", \"cpu\": \"%s\"},\n",
+               build.commit.c_str(), build.compiler.c_str(), build.cpu.c_str());
+  std::fprintf(f, "  \"config\": {\"warmup\": %d, \"reps\": %d, \"min_sample_ms\": %g, "
+                  "\"pool\": %s, \"threads\": %u, \"seed\": %llu, \"counters\": %s, "
+                  "\"stats\": %s},\n",
+               cfg.run.warmup, cfg.run.reps, cfg.run.min_sample_ms,
+               cfg.run.pool ? "true" : "false", neon_parallel::thread_count(),
+               static_cast<unsigned long long>(cfg.seed), cfg.counters ? "true" : "false",
+               cfg.stages ? "true" : "false");
+  std::fprintf(f, "  \"results\": [");
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const Row& r = rows[i];
+    std::fprintf(f, "%s\n    {\"kernel\": \"%s\", \"group\": \"%s\", \"dataset\": \"%s\", "
+                    "\"n\": %zu, \"reps\": %zu, \"calls_per_sample\": %zu, "
+                    "\"median_ns\": %.1f, \"mad_ns\": %.1f, \"min_ns\": %.1f, \"max_ns\": %.1f, "
+                    "\"mean_ns\": %.1f, \"mnum_s\": %.3f, \"gb_s\": %.4f, \"mismatches\": %ld",
+                 i ? "," : "", r.kernel->name, r.kernel->group, r.dataset->name, r.n, r.ns.n,
+                 r.calls_per_sample, r.ns.median, r.ns.mad, r.ns.min, r.ns.max, r.ns.mean,
+                 mnum_per_s(r), gb_per_s(r), r.mismatches);
+    if (cfg.counters) {
+      for (const Metric& m : kMetrics) {
+        const double v = r.counters.*m.field;
+        if (v < 0) std::fprintf(f, ", \"%s\": null", m.key);
+        else std::fprintf(f, ", \"%s\": %.4g", m.key, v);
+      }
+    }
+    if (cfg.stages) {
+      each_stage(r.stages, [&](const char* key, uint64_t v) {
+        std::fprintf(f, ", \"%s\": %llu", key, static_cast<unsigned long long>(v));
+      });
+    }
+    std::fprintf(f, "}");
+  }
+  std::fprintf(f, "\n  ]\n}\n");
+}
+
+void list_registries() {
+  std::printf("kernels:\n");
+  for (const Kernel& k : kernels()) {
+    std::printf("  %-20s %-10s %s\n", k.name, k.group,
+                k.output == Output::Bytes ? "bytes" : "bitmap");
+  }
+  std::printf("datasets:\n");
+  for (const Dataset& d : datasets()) std::printf("  %-20s %s\n", d.name, d.description);
+}
+
+// Number of outputs that disagree with k.expect; prints the first one.
+long count_mismatches(const Kernel& k, const uint64_t* numbers, const uint8_t* out,
+                      const std::vector<uint8_t>& want, size_t n) {
+  long bad = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (survives(k, out, i) == bool(want[i])) continue;
+    if (!bad++) {
+      std::fprintf(stderr, "%s: value %llu at index %zu: got %d, expected %d\n", k.name,
+                   static_cast<unsigned long long>(numbers[i]), i, !want[i], int(want[i]));
+    }
+  }
+  return bad;
+}
+
+// === Latency mode ===
+
+void print_latency_header() {
+  std::printf("%-20s %-10s %6s %8s %10s %10s %10s %10s %10s %8s %8s\n", "kernel", "dataset",
+              "batch", "calls", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns", "max ns", "ns/num",
+              "verify");
+}
+
+void print_latency_row(const Row& r) {
+  const Latency& l = r.latency;
+  std::printf("%-20s %-10s %6zu %8zu %10.0f %10.0f %10.0f %10.0f %10.0f %8.2f %8s\n",
+              r.kernel->name, r.dataset->name, r.n, l.calls, l.p50, l.p90, l.p99, l.p999, l.max,
+              l.p50 / r.n, verify_text(r));
+}
+
+void write_latency_csv(std::FILE* f, const std::vector<Row>& rows) {
+  std::fprintf(f, "kernel,group,dataset,batch,calls,p50_ns,p90_ns,p99_ns,p999_ns,max_ns,"
+                  "mismatches\n");
+  for (const Row& r : rows) {
+    const Latency& l = r.latency;
+    std::fprintf(f, "%s,%s,%s,%zu,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%ld\n", r.kernel->name,
+                 r.kernel->group, r.dataset->name, r.n, l.calls, l.p50, l.p90, l.p99, l.p999,
+                 l.max, r.mismatches);
+  }
+}
+
+void write_latency_json(std::FILE* f, const Config& cfg, const std::vector<Row>& rows) {
+  const BuildInfo& build = build_info();
+  std::fprintf(f, "{\n  \"tool\": \"prime8_bench\",\n  \"format\": 1,\n  \"mode\": \"latency\",\n");
+  std::fprintf(f, "  \"build\": {\"commit\": \"%s\", \"compiler\": \"%s\", \"cpu\": \"%s\"},\n",
+               build.commit.c_str(), build.compiler.c_str(), build.cpu.c_str());
+  std::fprintf(f, "  \"config\": {\"calls\": %zu, \"warmup\": %zu, \"seed\": %llu, "
+                  "\"timer_overhead_ns\": %.1f},\n",
+               cfg.lat.calls, cfg.lat.warmup, static_cast<unsigned long long>(cfg.seed),
+               timer_overhead_ns());
+  std::fprintf(f, "  \"results\": [");
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const Row& r = rows[i];
+    const Latency& l = r.latency;
+    std::fprintf(f, "%s\n    {\"kernel\": \"%s\", \"group\": \"%s\", \"dataset\": \"%s\", "
+                    "\"batch\": %zu, \"calls\": %zu, \"p50_ns\": %.1f, \"p90_ns\": %.1f, "
+                    "\"p99_ns\": %.1f, \"p999_ns\": %.1f, \"max_ns\": %.1f, \"mismatches\": %ld}",
+                 i ? "," : "", r.kernel->name, r.kernel->group, r.dataset->name, r.n, l.calls,
+                 l.p50, l.p90, l.p99, l.p999, l.max, r.mismatches);
+  }
+  std::fprintf(f, "\n  ]\n}\n");
+}
+
+// === Baselines ===
+
+std::string utc_now() {
+  const std::time_t t = std::time(nullptr);
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+Baseline to_baseline(const Config& cfg, const std::vector<Row>& rows) {
+  Baseline b;
+  b.build = build_info();
+  b.date = utc_now();
+  b.warmup = cfg.run.warmup;
+  b.reps = cfg.run.reps;
+  b.min_sample_ms = cfg.run.min_sample_ms;
+  b.pool = cfg.run.pool;
+  b.threads = neon_parallel::thread_count();
+  b.seed = cfg.seed;
+  for (const Row& r : rows) b.rows.push_back({r.kernel->name, r.dataset->name, r.n, r.samples});
+  return b;
+}
+
+// Takes the run settings and the job list from the baseline; rows naming a
+// kernel or dataset this build no longer has are reported and skipped.
+bool load_comparison(Config& cfg, Baseline& base, std::vector<Job>& jobs,
+                     std::vector<const BaselineRow*>& against, const char* argv0) {
+  std::string error;
+  if (!read_baseline(cfg.compare_path, base, error)) {
+    std::fprintf(stderr, "%s: %s\n", argv0, error.c_str());
+    return false;
+  }
+  cfg.run.warmup = base.warmup;
+  cfg.run.reps = base.reps;
+  cfg.run.min_sample_ms = base.min_sample_ms;
+  cfg.run.pool = base.pool;
+  cfg.threads = base.threads;
+  cfg.seed = base.seed;
+  for (const BaselineRow& r : base.rows) {
+    std::string unknown;
+    auto k = select_kernels(r.kernel, unknown);
+    // "wheel" names both a kernel and its group; a baseline row means the kernel.
+    std::erase_if(k, [&](const Kernel* x) { return r.kernel != x->name; });
+    const auto d = select_datasets(r.dataset, unknown);
+    if (!unknown.empty() || k.size() != 1 || d.size() != 1) {
+      std::fprintf(stderr, "%s: skipping baseline row %s/%s: not in this build\n", argv0,
+                   r.kernel.c_str(), r.dataset.c_str());
+      continue;
+    }
+    jobs.push_back({k[0], d[0], r.n});
+    against.push_back(&r);
+  }
+  return true;
+}
+
+void print_comparison_header(const Baseline& base) {
+  const BuildInfo& now = build_info();
+  std::printf("baseline: %s, %s, %s, %s\n", base.build.commit.c_str(), base.date.c_str(),
+              base.build.compiler.c_str(), base.build.cpu.c_str());
+  std::printf("current:  %s, %s, %s\n", now.commit.c_str(), now.compiler.c_str(),
+              now.cpu.c_str());
+  if (base.build.cpu != now.cpu || base.build.compiler != now.compiler) {
+    std::printf("warning: different CPU or compiler; differences are not only the code's\n");
+  }
+  std::printf("%-20s %-10s %10s %12s %12s %9s %9s  %s\n", "kernel", "dataset", "n",
+              "base us", "current us", "change %", "p", "verdict");
+}
+
+struct Verdict {
+  double base_median;
+  double change;   // percent, median to median
+  double p;        // of the direction the median moved
+  const char* text;
+};
+
+// A row moved only if the shift is both significant and large enough to matter.
+Verdict judge(const Row& r, const BaselineRow& base, const Config& cfg) {
+  const Stats b = summarize(base.ns);
+  const double change = 100.0 * (r.ns.median - b.median) / b.median;
+  const double p_slower = mann_whitney_slower(base.ns, r.samples);
+  const double p_faster = mann_whitney_slower(r.samples, base.ns);
+  const char* text = "same";
+  if (p_slower < cfg.alpha && change > cfg.threshold) text = "SLOWER";
+  else if (p_faster < cfg.alpha && change < -cfg.threshold) text = "faster";
+  return {b.median, change, change >= 0 ? p_slower : p_faster, text};
+}
+
+// Prints one comparison row; true for a regression.
+bool compare_row(const Row& r, const BaselineRow& base, const Config& cfg) {
+  const Verdict v = judge(r, base, cfg);
+  std::printf("%-20s %-10s %10zu %12.2f %12.2f %+9.1f %9.2g  %s\n", r.kernel->name,
+              r.dataset->name, r.n, v.base_median / 1e3, r.ns.median / 1e3, v.change, v.p,
+              v.text);
+  return v.text[0] == 'S';
+}
+
+// One line per kernel, in first-row order: the geometric mean of
+// base/current medians over its rows, and how many rows judge() moved.
+void print_kernel_summary(const std::vector<Row>& rows,
+                          const std::vector<const BaselineRow*>& against, const Config& cfg) {
+  struct Sum {
+    const char* name;
+    double log_speedup = 0;
+    size_t rows = 0, faster = 0, slower = 0;
+  };
+  std::vector<Sum> sums;
+  for (size_t j = 0; j < rows.size(); ++j) {
+    const Row& r = rows[j];
+    const Verdict v = judge(r, *against[j], cfg);
+    auto it = std::find_if(sums.begin(), sums.end(),
+                           [&](const Sum& s) { return s.name == r.kernel->name; });
+    if (it == sums.end()) it = sums.insert(sums.end(), Sum{r.kernel->name});
+    it->log_speedup += std::log(v.base_median / r.ns.median);
+    ++it->rows;
+    if (v.text[0] == 'f') ++it->faster;
+    else if (v.text[0] == 'S') ++it->slower;
+  }
+  std::printf("%-20s %5s %9s %7s %7s\n", "kernel", "rows", "speedup", "faster", "slower");
+  for (const Sum& s : sums) {
+    std::printf("%-20s %5zu %8.3fx %7zu %7zu\n", s.name, s.rows,
+                std::exp(s.log_speedup / static_cast<double>(s.rows)), s.faster, s.slower);
+  }
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [-k kernels] [-d datasets] [-n sizes] [-r reps] [-w warmup] "
+               "[-m min_sample_ms] [-p] [-t threads] [-s seed] [-c] [-f table|csv|json] "
+               "[-o file] [--no-verify] [-l] [--record file] "
+               "[--compare file [--alpha p] [--threshold pct]] [--latency [--calls n]] "
+               "[--stats]\n",
+               argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "-k" && has_value) {
+      cfg.kernels = argv[++i];
+    } else if (arg == "-d" && has_value) {
+      cfg.datasets = argv[++i];
+    } else if (arg == "-n" && has_value) {
+      const std::string list = argv[++i];
+      for (size_t pos = 0; pos <= list.size();) {
+        const size_t comma = std::min(list.find(',', pos), list.size());
+        const size_t n = parse_size(list.substr(pos, comma - pos));
+        if (!n) return usage(argv[0]);
+        cfg.sizes.push_back(n);
+        pos = comma + 1;
+      }
+    } else if (arg == "-r" && has_value) {
+      cfg.run.reps = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-w" && has_value) {
+      cfg.run.warmup = std::max(0, std::atoi(argv[++i]));
+    } else if (arg == "-m" && has_value) {
+      cfg.run.min_sample_ms = std::strtod(argv[++i], nullptr);
+    } else if (arg == "-p") {
+      cfg.run.pool = true;
+    } else if (arg == "-t" && has_value) {
+      cfg.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "-s" && has_value) {
+      cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-f" && has_value) {
+      const std::string f = argv[++i];
+      if (f == "table") cfg.format = Format::Table;
+      else if (f == "csv") cfg.format = Format::Csv;
+      else if (f == "json") cfg.format = Format::Json;
+      else return usage(argv[0]);
+    } else if (arg == "-o" && has_value) {
+      cfg.out_path = argv[++i];
+    } else if (arg == "-c") {
+      cfg.counters = true;
+    } else if (arg == "--record" && has_value) {
+      cfg.record_path = argv[++i];
+    } else if (arg == "--compare" && has_value) {
+      cfg.compare_path = argv[++i];
+    } else if (arg == "--alpha" && has_value) {
+      cfg.alpha = std::strtod(argv[++i], nullptr);
+    } else if (arg == "--threshold" && has_value) {
+      cfg.threshold = std::strtod(argv[++i], nullptr);
+    } else if (arg == "--latency") {
+      cfg.latency = true;
+    } else if (arg == "--calls" && has_value) {
+      cfg.lat.calls = std::max<size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg == "--stats") {
+      cfg.stages = true;
+    } else if (arg == "--no-verify") {
+      cfg.verify = false;
+    } else if (arg == "-l") {
+      list_registries();
+      return 0;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (cfg.stages && !neon_stats::kEnabled) {
+    std::fprintf(stderr, "%s: --stats needs a build with -DPRIME8_STATS=ON\n", argv[0]);
+    return 1;
+  }
+  if (cfg.stages && (cfg.latency || cfg.compare_path)) {
+    std::fprintf(stderr, "%s: --stats cannot be combined with --latency or --compare\n", argv[0]);
+    return 1;
+  }
+  if (cfg.latency) {
+    // Serial calls on small batches only: no pool, baselines or counters.
+    if (cfg.run.pool || cfg.record_path || cfg.compare_path || cfg.counters) {
+      std::fprintf(stderr, "%s: --latency cannot be combined with -p, -c, --record or "
+                           "--compare\n", argv[0]);
+      return 1;
+    }
+    for (size_t n : cfg.sizes) {
+      if (n > kLatencyPool) {
+        std::fprintf(stderr, "%s: --latency batches are at most %zu numbers\n", argv[0],
+                     kLatencyPool);
+        return 1;
+      }
+    }
+    if (cfg.sizes.empty()) cfg.sizes = {8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+  }
+  if (cfg.sizes.empty()) cfg.sizes.push_back(size_t(1) << 20);
+
+  // The job list: the cross product of -k, -d and -n, or a baseline's rows.
+  std::vector<Job> jobs;
+  Baseline base;
+  std::vector<const BaselineRow*> against;  // parallel to jobs when comparing
+  if (cfg.compare_path) {
+    if (!load_comparison(cfg, base, jobs, against, argv[0])) return 2;
+  } else {
+    std::string unknown;
+    const auto ks = select_kernels(cfg.kernels, unknown);
+    if (!unknown.empty()) {
+      std::fprintf(stderr, "%s: unknown kernel %s (-l lists them)\n", argv[0], unknown.c_str());
+      return 1;
+    }
+    const auto ds = select_datasets(cfg.datasets, unknown);
+    if (!unknown.empty()) {
+      std::fprintf(stderr, "%s: unknown dataset %s (-l lists them)\n", argv[0], unknown.c_str());
+      return 1;
+    }
+    for (const Dataset* d : ds) {
+      for (size_t n : cfg.sizes) {
+        for (const Kernel* k : ks) jobs.push_back({k, d, n});
+      }
+    }
+  }
+  if (cfg.threads) neon_parallel::set_thread_count(cfg.threads);
+
+  // Missing counters (containers, VMs, paranoid kernels) drop the columns
+  // with a note instead of failing the run.
+  PerfCounters counters;
+  if (cfg.counters && !counters.available()) {
+    std::fprintf(stderr, "%s: hardware counters unavailable: %s\n", argv[0],
+                 counters.error().c_str());
+    cfg.counters = false;
+  }
+  if (cfg.counters) cfg.run.counters = &counters;
+
+  // Table (or comparison) rows stream to stdout as they finish; CSV and JSON
+  // are written at the end, to -o or stdout.
+  const bool compare = cfg.compare_path != nullptr;
+  const bool table = cfg.format == Format::Table && !compare;
+  if (compare) print_comparison_header(base);
+  if (table && cfg.latency) {
+    std::printf("prime8_bench: latency, %zu calls per row, %.2f ticks/ns, timer overhead %.0f ns "
+                "(not subtracted)\n",
+                cfg.lat.calls, ticks_per_ns(), timer_overhead_ns());
+    print_latency_header();
+  } else if (table) {
+    std::printf("prime8_bench: %d warmup, %d reps, >= %g ms per sample, %s (%u threads)\n",
+                cfg.run.warmup, cfg.run.reps, cfg.run.min_sample_ms,
+                cfg.run.pool ? "pool" : "serial", neon_parallel::thread_count());
+    print_table_header(cfg.counters, cfg.stages);
+  }
+
+  std::vector<Row> rows;
+  bool all_ok = true;
+  size_t regressions = 0;
+  neon_mem::vector<uint64_t> input;
+  neon_mem::vector<uint8_t> out;
+  std::map<bool (*)(uint64_t), std::vector<uint8_t>> expected;
+  for (size_t j = 0; j < jobs.size(); ++j) {
+    const Kernel* k = jobs[j].kernel;
+    const Dataset* d = jobs[j].dataset;
+    const size_t n = jobs[j].n;
+    // Jobs are grouped by input, so each dataset and size is generated once.
+    // Latency calls cycle through a fixed pool of batches.
+    if (!j || d != jobs[j - 1].dataset || n != jobs[j - 1].n) {
+      const size_t gen = cfg.latency ? kLatencyPool : n;
+      input = neon_mem::vector<uint64_t>(gen);
+      neon_data::generate(*d, input.data(), gen, cfg.seed);
+      out = neon_mem::vector<uint8_t>(n + 64, 0);
+      expected.clear();
+    }
+
+    Row row{k, d, n, {}, {}, 1, -1, {}, {}, {}};
+    if (cfg.verify) {
+      auto& want = expected[k->expect];
+      if (want.empty()) {
+        want.resize(n);
+        for (size_t i = 0; i < n; ++i) want[i] = k->expect(input[i]);
+      }
+      std::memset(out.data(), 0, out.size());
+      run_kernel(*k, input.data(), out.data(), n, cfg.run.pool);
+      row.mismatches = count_mismatches(*k, input.data(), out.data(), want, n);
+      all_ok = all_ok && row.mismatches == 0;
+    }
+    if (cfg.latency) {
+      row.latency = measure_latency(*k, input.data(), input.size(), out.data(), n, cfg.lat);
+      rows.push_back(row);
+      if (table) print_latency_row(row);
+      std::fflush(stdout);
+      continue;
+    }
+    const Samples s = measure(*k, input.data(), out.data(), n, cfg.run);
+    row.samples = s.ns;
+    row.ns = summarize(s.ns);
+    row.calls_per_sample = s.calls_per_sample;
+    row.counters = s.counters;
+    if (cfg.stages) {
+      // A separate untimed call, so the counters see exactly one pass.
+      neon_stats::reset();
+      run_kernel(*k, input.data(), out.data(), n, cfg.run.pool);
+      row.stages = neon_stats::snapshot();
+    }
+    rows.push_back(row);
+    if (table) print_table_row(row, cfg.counters, cfg.stages);
+    if (compare && compare_row(row, *against[j], cfg)) ++regressions;
+    std::fflush(stdout);
+  }
+
+  if (cfg.record_path && !write_baseline(cfg.record_path, to_baseline(cfg, rows))) {
+    std::fprintf(stderr, "%s: cannot write %s\n", argv[0], cfg.record_path);
+    return 2;
+  }
+  if (compare) {
+    std::printf("%zu of %zu rows slower (p < %g, > %g%%)\n", regressions, rows.size(),
+                cfg.alpha, cfg.threshold);
+    print_kernel_summary(rows, against, cfg);
+  }
+
+  if (cfg.format != Format::Table) {
+    std::FILE* f = cfg.out_path ? std::fopen(cfg.out_path, "w") : stdout;
+    if (!f) {
+      std::fprintf(stderr, "%s: cannot create %s\n", argv[0], cfg.out_path);
+      return 2;
+    }
+    if (cfg.latency) {
+      if (cfg.format == Format::Csv) write_latency_csv(f, rows);
+      else write_latency_json(f, cfg, rows);
+    } else if (cfg.format == Format::Csv) {
+      write_csv(f, rows, cfg.counters, cfg.stages);
+    } else {
+      write_json(f, cfg, rows);
+    }
+    if (f != stdout) std::fclose(f);
+  }
+  if (!all_ok) return 1;
+  return regressions ? 3 : 0;
+}
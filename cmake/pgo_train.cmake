@@ -0,0 +1,46 @@
+# Training run for a PRIME8_PGO=generate build (target pgo-train in
+# CMakeLists.txt), as `cmake -DBENCH=... -DPGO_DIR=... [-DPROFDATA=...
+# -DMERGED=...] -P pgo_train.cmake`.
+#
+# Drops the previous run's profiles, then drives the instrumented
+# prime8_bench over every kernel and dataset: serial calls at a cache-sized
+# and a memory-sized batch, pooled calls, and small batches through the
+# latency loop, so the early-out, wheel-skip and depth branches see the same
+# mix of inputs as the benchmarks they are scored on. With clang, PROFDATA
+# (llvm-profdata) merges the raw profiles into MERGED.
+
+if(NOT BENCH OR NOT PGO_DIR)
+  message(FATAL_ERROR "pgo_train.cmake: BENCH and PGO_DIR are required")
+endif()
+
+file(GLOB stale "${PGO_DIR}/*.gcda" "${PGO_DIR}/*.profraw" "${PGO_DIR}/*.profdata")
+if(stale)
+  file(REMOVE ${stale})
+endif()
+
+function(train)
+  list(JOIN ARGN " " args)
+  message(STATUS "pgo-train: prime8_bench ${args}")
+  execute_process(COMMAND "${BENCH}" ${ARGN} RESULT_VARIABLE rc OUTPUT_QUIET)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "pgo-train: prime8_bench ${args} exited with ${rc}")
+  endif()
+endfunction()
+
+train(-d all -n 4k,1M -r 3 -w 1 -m 0)
+train(-p -d uniform32,mixed,dense,composite80 -n 1M -r 3 -w 1 -m 0)
+train(--latency -k small,wheel_bitmap,barrett16_final -d all -n 8,64,512 --calls 2000)
+
+if(PROFDATA)
+  file(GLOB raw "${PGO_DIR}/*.profraw")
+  if(NOT raw)
+    message(FATAL_ERROR "pgo-train: no raw profiles in ${PGO_DIR}")
+  endif()
+  execute_process(COMMAND "${PROFDATA}" merge -o "${MERGED}" ${raw} RESULT_VARIABLE rc)
+  if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "pgo-train: llvm-profdata merge failed")
+  endif()
+  message(STATUS "pgo-train: wrote ${MERGED}")
+else()
+  message(STATUS "pgo-train: profiles in ${PGO_DIR}")
+endif()
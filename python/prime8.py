@@ -0,0 +1,180 @@
+"""
+ctypes bindings for libprime8's C ABI (src/prime8.h).
+
+Arrays are passed to the kernels in place: a C-contiguous uint64 NumPy array
+(or any writable buffer of native u64s, e.g. array.array('Q')) goes straight
+through as a pointer, and results land in caller-provided or freshly allocated
+arrays without intermediate copies.
+
+The library is found via $PRIME8_LIB, then build/libprime8.{so,dylib} next to
+this checkout.
+"""
+
+import ctypes
+import os
+import sys
+from array import array
+from pathlib import Path
+
+try:
+    import numpy as np
+except ImportError:  # the module also works on plain buffers
+    np = None
+
+ABI_VERSION = 1
+
+KERNELS = {"wheel30": 0, "wheel210": 1, "barrett16": 2, "sieve": 3, "prime": 4}
+PARALLEL = 1
+NONTEMPORAL = 2
+
+_ERRORS = {-1: "unknown kernel", -2: "NULL buffer", -3: "out of memory", -4: "internal error"}
+# Failures that are not the caller's arguments; everything else is ValueError.
+_EXCEPTIONS = {-3: MemoryError, -4: RuntimeError}
+
+
+def _load():
+    names = ["libprime8.dylib", "libprime8.so"] if sys.platform == "darwin" else ["libprime8.so"]
+    candidates = []
+    if os.environ.get("PRIME8_LIB"):
+        candidates.append(Path(os.environ["PRIME8_LIB"]))
+    root = Path(__file__).resolve().parent.parent
+    candidates += [root / "build" / n for n in names]
+    for path in candidates:
+        if path.exists():
+            return ctypes.CDLL(str(path))
+    raise OSError("libprime8 not found; build it (cmake --build build) or set PRIME8_LIB")
+
+
+_lib = _load()
+
+_u64p = ctypes.c_void_p
+_u8p = ctypes.c_void_p
+_lib.prime8_abi_version.restype = ctypes.c_int
+_lib.prime8_kernel_name.argtypes = [ctypes.c_int]
+_lib.prime8_kernel_name.restype = ctypes.c_char_p
+_lib.prime8_filter_bitmap.argtypes = [ctypes.c_int, _u64p, ctypes.c_size_t, _u8p, ctypes.c_uint]
+_lib.prime8_filter_bitmap.restype = ctypes.c_int
+_lib.prime8_count.argtypes = [ctypes.c_int, _u64p, ctypes.c_size_t, ctypes.c_uint]
+_lib.prime8_count.restype = ctypes.c_int64
+_lib.prime8_compact.argtypes = [ctypes.c_int, _u64p, ctypes.c_size_t, _u64p, ctypes.c_uint]
+_lib.prime8_compact.restype = ctypes.c_int64
+_lib.prime8_filter_inplace.argtypes = [ctypes.c_int, _u64p, ctypes.c_size_t, ctypes.c_uint]
+_lib.prime8_filter_inplace.restype = ctypes.c_int64
+_lib.prime8_confirm.argtypes = [_u64p, ctypes.c_size_t, _u8p]
+_lib.prime8_confirm.restype = ctypes.c_int64
+_lib.prime8_is_prime.argtypes = [ctypes.c_uint64]
+_lib.prime8_is_prime.restype = ctypes.c_int
+
+if _lib.prime8_abi_version() != ABI_VERSION:
+    raise OSError(f"libprime8 ABI {_lib.prime8_abi_version()}, expected {ABI_VERSION}")
+
+
+def _numbers(buf):
+    """(address, count, keepalive) for a u64 buffer; NumPy arrays are only
+    copied if they are not already contiguous uint64."""
+    if np is not None and isinstance(buf, np.ndarray):
+        arr = np.ascontiguousarray(buf, dtype=np.uint64)
+        return arr.ctypes.data, arr.size, arr
+    view = memoryview(buf).cast("B").cast("Q")
+    if view.readonly:
+        raise TypeError("buffer must be writable (ctypes cannot pin read-only memory)")
+    return _address(view), len(view), view
+
+
+def _address(view):
+    return ctypes.addressof(ctypes.c_char.from_buffer(view)) if view.nbytes else None
+
+
+def _alloc(count, typecode):
+    if np is not None:
+        return np.zeros(count, dtype=np.uint8 if typecode == "B" else np.uint64)
+    return array(typecode, bytes(count * (1 if typecode == "B" else 8)))
+
+
+def _out(buf, count, typecode):
+    """(address, keepalive) for an output buffer of at least count items."""
+    if np is not None and isinstance(buf, np.ndarray):
+        if not buf.flags.c_contiguous or buf.dtype != (np.uint8 if typecode == "B" else np.uint64):
+            raise TypeError("output must be a C-contiguous array of the right dtype")
+        if buf.size < count:
+            raise ValueError(f"output holds {buf.size} items, needs {count}")
+        return buf.ctypes.data, buf
+    view = memoryview(buf).cast("B")
+    if view.nbytes < count * (1 if typecode == "B" else 8):
+        raise ValueError("output buffer too small")
+    return _address(view), view
+
+
+def _kernel(kernel):
+    return KERNELS[kernel] if isinstance(kernel, str) else int(kernel)
+
+
+def _check(rc):
+    if rc < 0:
+        raise _EXCEPTIONS.get(rc, ValueError)(f"prime8: {_ERRORS.get(rc, rc)}")
+    return rc
+
+
+def filter_bitmap(numbers, kernel="wheel30", out=None, parallel=False, nontemporal=False):
+    """Survivor bitmap: bit i of out[i // 8] set iff numbers[i] survives.
+
+    nontemporal streams the bitmap past the cache; worth it on huge inputs
+    whose bitmap is not read again right away."""
+    addr, count, keep = _numbers(numbers)
+    if out is None:
+        out = _alloc((count + 7) // 8, "B")
+    oaddr, okeep = _out(out, (count + 7) // 8, "B")
+    flags = (PARALLEL if parallel else 0) | (NONTEMPORAL if nontemporal else 0)
+    _check(_lib.prime8_filter_bitmap(_kernel(kernel), addr, count, oaddr, flags))
+    return out
+
+
+def count(numbers, kernel="wheel30", parallel=False):
+    """Number of survivors."""
+    addr, n, keep = _numbers(numbers)
+    return _check(_lib.prime8_count(_kernel(kernel), addr, n, PARALLEL if parallel else 0))
+
+
+def compact(numbers, kernel="wheel30", out=None, parallel=False):
+    """Survivors in input order. out (room for len(numbers)) may be numbers
+    itself to compact in place; the result is a view of its first k items."""
+    addr, n, keep = _numbers(numbers)
+    if out is None:
+        out = _alloc(n, "Q")
+    oaddr, okeep = _out(out, n, "Q")
+    k = _check(_lib.prime8_compact(_kernel(kernel), addr, n, oaddr, PARALLEL if parallel else 0))
+    return out[:k]
+
+
+def filter_inplace(numbers, kernel="wheel30", parallel=False):
+    """Overwrites numbers (a writable, contiguous u64 buffer; never copied)
+    with its own survivors. Returns a view of the first k items."""
+    if np is not None and isinstance(numbers, np.ndarray):
+        addr, keep = _out(numbers, numbers.size, "Q")
+        n, view = numbers.size, numbers
+    else:
+        view = memoryview(numbers).cast("B").cast("Q")
+        if view.readonly:
+            raise TypeError("buffer must be writable")
+        addr, n = _address(view), len(view)
+    k = _check(_lib.prime8_filter_inplace(_kernel(kernel), addr, n, PARALLEL if parallel else 0))
+    return view[:k]
+
+
+def confirm(numbers, out=None):
+    """Exact primality: out[i] = 1 iff numbers[i] is prime. Returns (out, primes)."""
+    addr, n, keep = _numbers(numbers)
+    if out is None:
+        out = _alloc(n, "B")
+    oaddr, okeep = _out(out, n, "B")
+    primes = _check(_lib.prime8_confirm(addr, n, oaddr))
+    return out, primes
+
+
+def is_prime(n):
+    return bool(_lib.prime8_is_prime(n))
+
+
+def kernel_name(kernel):
+    name = _lib.prime8_kernel_name(_kernel(kernel))
+    return name.decode() if name else None
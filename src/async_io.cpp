@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "async_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define PRIME8_HAVE_URING 1
+#else
+#define PRIME8_HAVE_URING 0
+#endif
+
+namespace neon_io {
+
+namespace {
+
+constexpr int64_t kPending = INT64_MIN;
+constexpr size_t kMaxSqeLen = UINT32_MAX & ~(kIoAlign - 1);  // keeps O_DIRECT offsets aligned
+
+size_t round_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+// Fills bufs with kIoAlign-aligned buffers of bytes (rounded up to kIoAlign,
+// as aligned_alloc requires). On failure frees what it got and throws
+// std::bad_alloc, so a constructor leaves nothing behind.
+void alloc_buffers(std::vector<uint8_t*>& bufs, size_t bytes) {
+  bytes = round_up(bytes, kIoAlign);
+  for (auto& b : bufs) {
+    b = static_cast<uint8_t*>(std::aligned_alloc(kIoAlign, bytes));
+    if (!b) {
+      for (auto* f : bufs) std::free(f);
+      throw std::bad_alloc();
+    }
+  }
+}
+
+// Uncached I/O on fd if the filesystem supports it. Linux rejects O_DIRECT
+// with EINVAL on filesystems without direct I/O (e.g. older tmpfs); macOS has
+// no O_DIRECT but F_NOCACHE bypasses the unified buffer cache. The flag lives
+// on the caller's open file description, so it is cleared again when done.
+bool set_direct(int fd, bool on) {
+#if defined(__linux__) && defined(O_DIRECT)
+  const int fl = ::fcntl(fd, F_GETFL);
+  return fl >= 0 && ::fcntl(fd, F_SETFL, on ? fl | O_DIRECT : fl & ~O_DIRECT) == 0;
+#elif defined(F_NOCACHE)
+  return ::fcntl(fd, F_NOCACHE, on ? 1 : 0) == 0;
+#else
+  (void)fd;
+  (void)on;
+  return false;
+#endif
+}
+
+// Completes a short transfer synchronously; returns bytes done or -errno.
+int64_t finish_sync(bool write, int fd, uint8_t* buf, size_t len, uint64_t off, size_t done) {
+  while (done < len) {
+    const ssize_t r = write ? ::pwrite(fd, buf + done, len - done, off + done)
+                            : ::pread(fd, buf + done, len - done, off + done);
+    if (r < 0) {
+      if (errno == EINTR) continue;
+      return -errno;
+    }
+    if (r == 0) break;
+    done += static_cast<size_t>(r);
+  }
+  return static_cast<int64_t>(done);
+}
+
+Backend resolve(Backend b) {
+  if (b != Backend::Auto) return b;
+  if (const char* env = std::getenv("PRIME8_IO")) {
+    if (std::strcmp(env, "threads") == 0) return Backend::Threads;
+    if (std::strcmp(env, "uring") == 0) return Backend::Uring;
+  }
+  return PRIME8_HAVE_URING ? Backend::Uring : Backend::Threads;
+}
+
+} // namespace
+
+// === IoQueue ===
+
+IoQueue::IoQueue(Backend backend, unsigned entries) : backend_(resolve(backend)) {
+  if (backend_ == Backend::Uring && !uring_init(entries)) backend_ = Backend::Threads;
+  if (backend_ == Backend::Threads) io_thread_ = std::thread([this] { thread_main(); });
+}
+
+IoQueue::~IoQueue() {
+  if (io_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    io_thread_.join();
+  }
+  if (sqes_) ::munmap(sqes_, sqes_len_);
+  if (cq_ptr_ && cq_ptr_ != sq_ptr_) ::munmap(cq_ptr_, cq_len_);
+  if (sq_ptr_) ::munmap(sq_ptr_, sq_len_);
+  if (ring_fd_ >= 0) ::close(ring_fd_);
+}
+
+void IoQueue::read(unsigned tag, int fd, void* buf, size_t len, uint64_t off) {
+  submit(Request{tag, false, fd, buf, len, off});
+}
+
+void IoQueue::write(unsigned tag, int fd, const void* buf, size_t len, uint64_t off) {
+  submit(Request{tag, true, fd, const_cast<void*>(buf), len, off});
+}
+
+void IoQueue::submit(const Request& r) {
+  if (backend_ == Backend::Uring) {
+    uring_submit(r);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    todo_.push_back(r);
+  }
+  cv_.notify_all();
+}
+
+void IoQueue::wait(unsigned& tag, int64_t& res) {
+  if (backend_ == Backend::Uring) {
+    uring_wait(tag, res);
+    return;
+  }
+  std::unique_lock<std::mutex> lk(mu_);
+  cv_.wait(lk, [this] { return !done_.empty(); });
+  tag = done_.front().first;
+  res = done_.front().second;
+  done_.pop_front();
+}
+
+// Requests run in FIFO order, each to completion (short transfers retried).
+void IoQueue::thread_main() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] { return stop_ || !todo_.empty(); });
+    if (todo_.empty()) return;
+    const Request r = todo_.front();
+    todo_.pop_front();
+    lk.unlock();
+    const int64_t res = finish_sync(r.write, r.fd, static_cast<uint8_t*>(r.buf), r.len, r.off, 0);
+    lk.lock();
+    done_.emplace_back(r.tag, res);
+    cv_.notify_all();
+  }
+}
+
+// === io_uring (raw syscalls) ===
+
+#if PRIME8_HAVE_URING
+
+bool IoQueue::uring_init(unsigned entries) {
+  io_uring_params p;
+  std::memset(&p, 0, sizeof(p));
+  const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &p));
+  if (fd < 0) return false;  // ENOSYS, or EPERM under seccomp / io_uring_disabled
+  // IORING_OP_READ/WRITE arrived with RW_CUR_POS (5.6); older kernels fall back.
+  if (!(p.features & IORING_FEAT_RW_CUR_POS)) {
+    ::close(fd);
+    return false;
+  }
+  ring_fd_ = fd;
+
+  sq_len_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+  const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+  if (single) sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+
+  void* sq = ::mmap(nullptr, sq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                    IORING_OFF_SQ_RING);
+  if (sq == MAP_FAILED) return false;
+  sq_ptr_ = sq;
+  if (single) {
+    cq_ptr_ = sq_ptr_;
+  } else {
+    void* cq = ::mmap(nullptr, cq_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_CQ_RING);
+    if (cq == MAP_FAILED) return false;
+    cq_ptr_ = cq;
+  }
+  sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, sqes_len_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) return false;
+  sqes_ = sqes;
+
+  char* s = static_cast<char*>(sq_ptr_);
+  sq_head_ = reinterpret_cast<unsigned*>(s + p.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(s + p.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(s + p.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(s + p.sq_off.array);
+  char* c = static_cast<char*>(cq_ptr_);
+  cq_head_ = reinterpret_cast<unsigned*>(c + p.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(c + p.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(c + p.cq_off.ring_mask);
+  cqes_ = c + p.cq_off.cqes;
+  return true;
+}
+
+// Callers never have more requests outstanding than the ring has entries, so
+// the SQ cannot be full; each SQE is handed to the kernel straight away so a
+// read starts loading while the caller is still busy with the previous buffer.
+//
+// If the kernel will not take it (EAGAIN, EBUSY with a full CQ, or nothing
+// consumed), reaping the completions that are ready frees room and the enter
+// is retried. Failing that, the SQE is taken back (without SQPOLL the kernel
+// only consumes SQEs inside io_uring_enter) and the request runs with
+// pread/pwrite instead; its result, or -errno, is queued as its completion.
+void IoQueue::uring_submit(const Request& r) {
+  if (uring_broken_) {
+    uring_sync(r);
+    return;
+  }
+  const unsigned tail = *sq_tail_;
+  const unsigned idx = tail & *sq_mask_;
+  io_uring_sqe* sqe = static_cast<io_uring_sqe*>(sqes_) + idx;
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = r.write ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = r.fd;
+  sqe->addr = reinterpret_cast<uint64_t>(r.buf);
+  // An SQE carries a 32-bit length. A larger transfer goes in as its largest
+  // aligned prefix and completes short; callers finish short transfers with
+  // finish_sync, as they must anyway (Linux caps one read or write at ~2 GiB).
+  sqe->len = static_cast<uint32_t>(std::min<size_t>(r.len, kMaxSqeLen));
+  sqe->off = r.off;
+  sqe->user_data = r.tag;
+  sq_array_[idx] = idx;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+  for (;;) {
+    const long n = ::syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (__atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) != tail) break;  // consumed
+    const int err = n < 0 ? errno : EAGAIN;
+    if ((err == EAGAIN || err == EBUSY) && uring_reap() > 0) continue;
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    uring_sync(r);
+    return;
+  }
+  uring_tags_.push_back(r.tag);
+}
+
+void IoQueue::uring_sync(const Request& r) {
+  done_.emplace_back(r.tag,
+                     finish_sync(r.write, r.fd, static_cast<uint8_t*>(r.buf), r.len, r.off, 0));
+}
+
+// Moves every ready CQE to done_; returns how many. A CQE for a request
+// uring_wait has already failed is dropped.
+unsigned IoQueue::uring_reap() {
+  unsigned n = 0;
+  for (unsigned head = *cq_head_; head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE); ++head) {
+    const io_uring_cqe* cqe = static_cast<const io_uring_cqe*>(cqes_) + (head & *cq_mask_);
+    const unsigned tag = static_cast<unsigned>(cqe->user_data);
+    const auto it = std::find(uring_tags_.begin(), uring_tags_.end(), tag);
+    if (it != uring_tags_.end()) {
+      uring_tags_.erase(it);
+      done_.emplace_back(tag, cqe->res);
+      ++n;
+    }
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  }
+  return n;
+}
+
+// A wait that the kernel refuses for good (anything but EINTR, EAGAIN or
+// EBUSY) fails every request it holds with that error and turns the queue
+// synchronous, rather than blocking in GETEVENTS for completions that may
+// never be reported.
+void IoQueue::uring_wait(unsigned& tag, int64_t& res) {
+  for (;;) {
+    if (!done_.empty()) {
+      tag = done_.front().first;
+      res = done_.front().second;
+      done_.pop_front();
+      return;
+    }
+    if (uring_reap()) continue;
+    const long n = ::syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS,
+                             nullptr, 0);
+    if (n >= 0 || errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+    const int err = errno;
+    for (unsigned t : uring_tags_) done_.emplace_back(t, -err);
+    uring_tags_.clear();
+    uring_broken_ = true;
+  }
+}
+
+#else
+
+bool IoQueue::uring_init(unsigned) { return false; }
+void IoQueue::uring_submit(const Request&) {}
+void IoQueue::uring_wait(unsigned&, int64_t&) {}
+unsigned IoQueue::uring_reap() { return 0; }
+void IoQueue::uring_sync(const Request&) {}
+
+#endif
+
+// === AsyncReader ===
+
+AsyncReader::AsyncReader(int fd, uint64_t size, const AsyncOptions& opts)
+    : fd_(fd),
+      size_(size),
+      buf_bytes_(round_up(std::max<size_t>(opts.buffer_bytes, kIoAlign), kIoAlign)),
+      depth_(std::max(2u, opts.depth)),
+      queue_(opts.backend, std::max(2u, opts.depth)),
+      bufs_(depth_),
+      offset_(depth_, 0),
+      result_(depth_, kPending),
+      issued_(depth_, false) {
+  alloc_buffers(bufs_, buf_bytes_);
+  if (opts.direct) direct_ = set_direct(fd_, true);
+  for (unsigned s = 0; s < depth_; ++s) issue(s);
+}
+
+AsyncReader::~AsyncReader() {
+  while (in_flight_) {
+    unsigned tag;
+    int64_t res;
+    queue_.wait(tag, res);
+    --in_flight_;
+  }
+  if (direct_) set_direct(fd_, false);
+  for (auto* b : bufs_) std::free(b);
+}
+
+// Under O_DIRECT every read is a whole aligned buffer; the kernel stops at
+// EOF, so the last one simply comes back short.
+void AsyncReader::issue(unsigned slot) {
+  if (next_off_ >= size_ || error_) return;
+  const size_t len = direct_ ? buf_bytes_ : std::min<uint64_t>(buf_bytes_, size_ - next_off_);
+  offset_[slot] = next_off_;
+  result_[slot] = kPending;
+  issued_[slot] = true;
+  queue_.read(slot, fd_, bufs_[slot], len, next_off_);
+  next_off_ += buf_bytes_;
+  ++in_flight_;
+}
+
+bool AsyncReader::next(const uint8_t*& data, size_t& len) {
+  if (held_) {
+    issue((cur_ + depth_ - 1) % depth_);
+    held_ = false;
+  }
+  if (error_ || !issued_[cur_]) return false;
+
+  while (result_[cur_] == kPending) {
+    unsigned tag;
+    int64_t res;
+    queue_.wait(tag, res);
+    result_[tag] = res;
+    --in_flight_;
+  }
+  const int64_t res = result_[cur_];
+  const uint64_t off = offset_[cur_];
+  const size_t want = std::min<uint64_t>(buf_bytes_, size_ - off);
+  if (res >= 0 && static_cast<size_t>(res) < want) {
+    const int64_t r = finish_sync(false, fd_, bufs_[cur_], want, off, static_cast<size_t>(res));
+    if (r >= 0 && static_cast<size_t>(r) < want) {
+      error_ = EIO;  // file shrank under us
+      return false;
+    }
+    if (r < 0) {
+      error_ = static_cast<int>(-r);
+      return false;
+    }
+  } else if (res < 0) {
+    error_ = static_cast<int>(-res);
+    return false;
+  }
+
+  data = bufs_[cur_];
+  len = want;
+  issued_[cur_] = false;
+  cur_ = (cur_ + 1) % depth_;
+  held_ = true;
+  return true;
+}
+
+// === AsyncWriter ===
+
+AsyncWriter::AsyncWriter(int fd, const AsyncOptions& opts)
+    : fd_(fd),
+      buf_bytes_(round_up(std::max<size_t>(opts.buffer_bytes, kIoAlign), kIoAlign)),
+      depth_(std::max(2u, opts.depth)),
+      queue_(opts.backend, std::max(2u, opts.depth)),
+      bufs_(depth_),
+      busy_(depth_, false),
+      want_(depth_, 0),
+      offset_(depth_, 0) {
+  const off_t pos = ::lseek(fd_, 0, SEEK_CUR);
+  next_off_ = logical_ = pos > 0 ? static_cast<uint64_t>(pos) : 0;
+  alloc_buffers(bufs_, buf_bytes_);
+  if (opts.direct && next_off_ % kIoAlign == 0) direct_ = set_direct(fd_, true);
+}
+
+AsyncWriter::~AsyncWriter() {
+  finish();
+  for (auto* b : bufs_) std::free(b);
+}
+
+void AsyncWriter::submit(size_t len) {
+  if (len == 0 || finished_) return;
+  size_t want = len;
+  if (direct_) {
+    want = round_up(len, kIoAlign);
+    std::memset(bufs_[cur_] + len, 0, want - len);
+  }
+  busy_[cur_] = true;
+  want_[cur_] = want;
+  offset_[cur_] = next_off_;
+  queue_.write(cur_, fd_, bufs_[cur_], want, next_off_);
+  ++in_flight_;
+  logical_ += len;
+  next_off_ += want;
+  cur_ = (cur_ + 1) % depth_;
+  while (busy_[cur_]) reap_one();
+}
+
+void AsyncWriter::reap_one() {
+  unsigned tag;
+  int64_t res;
+  queue_.wait(tag, res);
+  --in_flight_;
+  busy_[tag] = false;
+  if (res >= 0 && static_cast<size_t>(res) < want_[tag]) {
+    res = finish_sync(true, fd_, bufs_[tag], want_[tag], offset_[tag], static_cast<size_t>(res));
+    if (res >= 0 && static_cast<size_t>(res) < want_[tag]) res = -EIO;
+  }
+  if (res < 0 && !error_) error_ = static_cast<int>(-res);
+}
+
+bool AsyncWriter::finish() {
+  if (!finished_) {
+    while (in_flight_) reap_one();
+    if (direct_) set_direct(fd_, false);
+    // Drop the O_DIRECT padding of the final block.
+    if (next_off_ != logical_ && ::ftruncate(fd_, static_cast<off_t>(logical_)) != 0 && !error_) {
+      error_ = errno;
+    }
+    finished_ = true;
+  }
+  return error_ == 0;
+}
+
+} // namespace neon_io
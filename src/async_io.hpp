@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace neon_io {
+
+enum class Backend {
+  Auto,     // $PRIME8_IO (uring|threads) if set, else io_uring, else threads
+  Uring,    // Linux io_uring via raw syscalls
+  Threads,  // one I/O thread issuing pread/pwrite
+};
+
+struct AsyncOptions {
+  size_t buffer_bytes = size_t(8) << 20;  // rounded up to kIoAlign
+  unsigned depth = 4;                     // buffers per stream (>= 2)
+  bool direct = true;                     // O_DIRECT / F_NOCACHE when the fs allows it
+  Backend backend = Backend::Auto;
+};
+
+// Buffer address, length and file offset alignment required by O_DIRECT.
+constexpr size_t kIoAlign = 4096;
+
+// Submission queue shared by a reader or writer: requests go in tagged with a
+// slot, completions come back (possibly out of order) with the same tag.
+// io_uring when the kernel allows it, otherwise a single thread running
+// pread/pwrite from a FIFO.
+class IoQueue {
+public:
+  IoQueue(Backend backend, unsigned entries);
+  ~IoQueue();
+
+  IoQueue(const IoQueue&) = delete;
+  IoQueue& operator=(const IoQueue&) = delete;
+
+  Backend backend() const { return backend_; }
+  const char* name() const { return backend_ == Backend::Uring ? "io_uring" : "threads"; }
+
+  void read(unsigned tag, int fd, void* buf, size_t len, uint64_t off);
+  void write(unsigned tag, int fd, const void* buf, size_t len, uint64_t off);
+
+  // Blocks for one completion; res is bytes transferred or -errno.
+  void wait(unsigned& tag, int64_t& res);
+
+private:
+  struct Request {
+    unsigned tag;
+    bool write;
+    int fd;
+    void* buf;
+    size_t len;
+    uint64_t off;
+  };
+
+  void submit(const Request& r);
+  bool uring_init(unsigned entries);
+  void uring_submit(const Request& r);
+  void uring_wait(unsigned& tag, int64_t& res);
+  unsigned uring_reap();
+  void uring_sync(const Request& r);
+  void thread_main();
+
+  Backend backend_;
+
+  // io_uring state (raw syscalls, no liburing)
+  int ring_fd_ = -1;
+  void* sq_ptr_ = nullptr;
+  void* cq_ptr_ = nullptr;
+  void* sqes_ = nullptr;
+  size_t sq_len_ = 0, cq_len_ = 0, sqes_len_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_mask_ = nullptr;
+  unsigned* sq_array_ = nullptr;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned* cq_mask_ = nullptr;
+  void* cqes_ = nullptr;
+  std::vector<unsigned> uring_tags_;  // requests the kernel has taken
+  bool uring_broken_ = false;         // io_uring_enter failed for good: run synchronously
+
+  // thread fallback
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Request> todo_;
+  // Completions: the I/O thread's, or under io_uring CQEs reaped early and
+  // requests that ran synchronously.
+  std::deque<std::pair<unsigned, int64_t>> done_;
+  bool stop_ = false;
+  std::thread io_thread_;
+};
+
+// Sequential reader keeping `depth` aligned buffers in flight. The buffer
+// returned by next() is owned by the caller until the following next(), so
+// the kernel runs on buffer k while buffers k+1..k+depth-1 load. The
+// constructor throws std::bad_alloc if the buffers cannot be allocated.
+class AsyncReader {
+public:
+  AsyncReader(int fd, uint64_t size, const AsyncOptions& opts = {});
+  ~AsyncReader();
+
+  AsyncReader(const AsyncReader&) = delete;
+  AsyncReader& operator=(const AsyncReader&) = delete;
+
+  // Next buffer in file order; false at EOF or on error (see error()).
+  bool next(const uint8_t*& data, size_t& len);
+
+  int error() const { return error_; }
+  bool direct() const { return direct_; }
+  const char* backend_name() const { return queue_.name(); }
+  size_t buffer_bytes() const { return buf_bytes_; }
+
+private:
+  void issue(unsigned slot);
+
+  int fd_;
+  uint64_t size_;
+  size_t buf_bytes_;
+  unsigned depth_;
+  bool direct_ = false;
+  IoQueue queue_;
+  std::vector<uint8_t*> bufs_;
+  std::vector<uint64_t> offset_;   // file offset each slot was issued for
+  std::vector<int64_t> result_;    // completion result, or kPending
+  std::vector<bool> issued_;
+  uint64_t next_off_ = 0;          // next offset to issue
+  unsigned cur_ = 0;               // slot next() returns next
+  bool held_ = false;              // caller holds the slot before cur_
+  unsigned in_flight_ = 0;
+  int error_ = 0;
+};
+
+// Sequential writer with `depth` aligned buffers: fill buffer(), submit()
+// queues it and hands back the next free one while earlier writes drain.
+// The constructor throws std::bad_alloc if the buffers cannot be allocated.
+class AsyncWriter {
+public:
+  AsyncWriter(int fd, const AsyncOptions& opts = {});
+  ~AsyncWriter();
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  uint8_t* buffer() { return bufs_[cur_]; }
+  size_t capacity() const { return buf_bytes_; }
+
+  // Queues len bytes of buffer(). Only the last submit may be shorter than
+  // capacity(); under O_DIRECT it is padded and the file truncated at finish().
+  void submit(size_t len);
+
+  // Waits for every write; false on error (see error()). Idempotent.
+  bool finish();
+
+  int error() const { return error_; }
+  bool direct() const { return direct_; }
+  const char* backend_name() const { return queue_.name(); }
+
+private:
+  void reap_one();
+
+  int fd_;
+  size_t buf_bytes_;
+  unsigned depth_;
+  bool direct_ = false;
+  IoQueue queue_;
+  std::vector<uint8_t*> bufs_;
+  std::vector<bool> busy_;
+  std::vector<size_t> want_;       // bytes each in-flight slot must write
+  std::vector<uint64_t> offset_;
+  unsigned cur_ = 0;
+  unsigned in_flight_ = 0;
+  uint64_t logical_ = 0;           // bytes submitted, before padding
+  uint64_t next_off_ = 0;
+  bool finished_ = false;
+  int error_ = 0;
+};
+
+} // namespace neon_io
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "autotune.hpp"
+#include "topology.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace neon_tune {
+
+namespace {
+
+std::vector<std::string> split_tabs(const std::string& line) {
+  std::vector<std::string> fields;
+  std::stringstream ss(line);
+  std::string f;
+  while (std::getline(ss, f, '\t')) fields.push_back(f);
+  return fields;
+}
+
+bool valid(const neon_wheel::WheelTuning& t) {
+  return (t.steps == 1 || t.steps == 2 || t.steps == 4) && t.prefetch <= 4096;
+}
+
+struct Active {
+  Profile profile;
+  std::string status;
+
+  Active() {
+    const std::string path = default_profile_path();
+    if (path.empty()) {
+      status = "none (profiles disabled)";
+      return;
+    }
+    Profile p;
+    std::string error;
+    if (!read_profile(path, p, error)) {
+      // A missing file is the normal untuned case; anything else is worth a note.
+      status = std::ifstream(path) ? "ignored " + error : "none (no " + path + ")";
+      return;
+    }
+    const std::string cpu = neon_parallel::cpu_model();
+    if (p.cpu != cpu) {
+      status = "ignored " + path + ": tuned on " + p.cpu + ", this is " + cpu;
+      return;
+    }
+    profile = p;
+    status = "loaded " + path;
+  }
+};
+
+const Active& state() {
+  static const Active a;
+  return a;
+}
+
+} // namespace
+
+bool write_profile(const std::string& path, const Profile& p) {
+  std::FILE* f = std::fopen(path.c_str(), "w");
+  if (!f) return false;
+  std::fprintf(f, "# prime8-autotune profile; read by libprime8 on first use\n");
+  std::fprintf(f, "format\t1\n");
+  std::fprintf(f, "cpu\t%s\ndataset\t%s\nn\t%zu\ndate\t%s\n", p.cpu.c_str(), p.dataset.c_str(),
+               p.n, p.date.c_str());
+  std::fprintf(f, "wheel_steps\t%u\nwheel_prefetch\t%u\nwheel_early_out\t%d\n", p.wheel.steps,
+               p.wheel.prefetch, p.wheel.early_out ? 1 : 0);
+  return std::fclose(f) == 0;
+}
+
+bool read_profile(const std::string& path, Profile& p, std::string& error) {
+  std::ifstream in(path);
+  if (!in) {
+    error = "cannot open " + path;
+    return false;
+  }
+  p = Profile{};
+  std::string line;
+  int format = 0;
+  for (int lineno = 1; std::getline(in, line); ++lineno) {
+    if (line.empty() || line[0] == '#') continue;
+    const std::vector<std::string> f = split_tabs(line);
+    if (f.size() != 2) {
+      error = path + ":" + std::to_string(lineno) + ": malformed line";
+      return false;
+    }
+    const std::string& key = f[0];
+    const char* v = f[1].c_str();
+    if (key == "format") format = std::atoi(v);
+    else if (key == "cpu") p.cpu = f[1];
+    else if (key == "dataset") p.dataset = f[1];
+    else if (key == "n") p.n = std::strtoull(v, nullptr, 10);
+    else if (key == "date") p.date = f[1];
+    else if (key == "wheel_steps") p.wheel.steps = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    else if (key == "wheel_prefetch")
+      p.wheel.prefetch = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+    else if (key == "wheel_early_out") p.wheel.early_out = f[1] == "1";
+    // Unknown keys are skipped so later versions can add fields.
+  }
+  if (format != 1) {
+    error = path + ": not a prime8 profile (format " + std::to_string(format) + ")";
+    return false;
+  }
+  if (!valid(p.wheel)) {
+    error = path + ": wheel settings out of range";
+    return false;
+  }
+  return true;
+}
+
+std::string default_profile_path() {
+  if (const char* env = std::getenv("PRIME8_PROFILE")) return env;
+  if (const char* xdg = std::getenv("XDG_CONFIG_HOME"); xdg && *xdg) {
+    return std::string(xdg) + "/prime8/profile";
+  }
+  if (const char* home = std::getenv("HOME"); home && *home) {
+    return std::string(home) + "/.config/prime8/profile";
+  }
+  return {};
+}
+
+const Profile& active() { return state().profile; }
+const std::string& status() { return state().status; }
+
+void filter_wheel_bitmap(const uint64_t* __restrict numbers,
+                         uint8_t*       __restrict bitmap,
+                         size_t count) {
+  neon_wheel::filter_stream_u64_wheel_bitmap_tuned(active().wheel, numbers, bitmap, count);
+}
+
+} // namespace neon_tune
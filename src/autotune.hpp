@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "simd_fast.hpp"
+
+// Per-host kernel profiles. The wheel-30 loop's unroll, prefetch distance and
+// early-out were tuned on an M4; prime8-autotune times every setting of
+// neon_wheel::WheelTuning on the machine it runs on and writes the fastest
+// to a profile, which the C API's wheel30 dispatch loads on first use.
+//
+// A profile is a tab-separated text file of `key<TAB>value` lines ('#'
+// starts a comment). It records the CPU it was measured on and is ignored
+// on any other, so a profile copied between an x86 and an ARM server does
+// not carry one's settings to the other.
+namespace neon_tune {
+
+struct Profile {
+  std::string cpu;       // neon_parallel::cpu_model() of the tuning host
+  std::string dataset;   // input distribution it was tuned on
+  size_t n = 0;          // numbers per call while tuning
+  std::string date;      // UTC, ISO 8601
+  neon_wheel::WheelTuning wheel;
+};
+
+bool write_profile(const std::string& path, const Profile& p);
+
+// False with a message in `error` if the file is missing or malformed.
+bool read_profile(const std::string& path, Profile& p, std::string& error);
+
+// $PRIME8_PROFILE if set (empty disables profiles), else
+// $XDG_CONFIG_HOME/prime8/profile, else ~/.config/prime8/profile.
+std::string default_profile_path();
+
+// The profile in effect: read from default_profile_path() on first use, or
+// the defaults when there is none, it does not parse or it is for another
+// CPU. status() says which, for tools to print.
+const Profile& active();
+const std::string& status();
+
+// neon_wheel::filter_stream_u64_wheel_bitmap under active().wheel.
+void filter_wheel_bitmap(const uint64_t* __restrict numbers,
+                         uint8_t*       __restrict bitmap,
+                         size_t count);
+
+} // namespace neon_tune
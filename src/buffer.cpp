@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "buffer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace neon_mem {
+
+namespace {
+
+size_t round_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+// Large blocks are mmapped 2 MiB-aligned: the kernel can only back an
+// aligned 2 MiB range with a huge page. Over-map by one huge page and trim.
+void* map_aligned(size_t bytes, HugePages mode) {
+#if defined(MAP_HUGETLB)
+  if (mode == HugePages::Explicit) {
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) return p;  // else: no reserved pages, fall back to THP
+  }
+#endif
+  const size_t span = bytes + kHugePage;
+  void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) return nullptr;
+  const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t aligned = round_up(base, kHugePage);
+  if (aligned > base) ::munmap(raw, aligned - base);
+  const uintptr_t end = aligned + bytes;
+  if (base + span > end) ::munmap(reinterpret_cast<void*>(end), base + span - end);
+  void* p = reinterpret_cast<void*>(aligned);
+#if defined(MADV_HUGEPAGE)
+  if (mode != HugePages::Off) ::madvise(p, bytes, MADV_HUGEPAGE);
+#else
+  (void)mode;
+#endif
+  return p;
+}
+
+} // namespace
+
+HugePages default_huge_pages() {
+  static const HugePages mode = [] {
+    const char* env = std::getenv("PRIME8_HUGEPAGES");
+    if (env && std::strcmp(env, "off") == 0) return HugePages::Off;
+    if (env && std::strcmp(env, "explicit") == 0) return HugePages::Explicit;
+    return HugePages::Transparent;
+  }();
+  return mode;
+}
+
+const char* huge_pages_name(HugePages mode) {
+  switch (mode) {
+    case HugePages::Off: return "off";
+    case HugePages::Transparent: return "thp";
+    case HugePages::Explicit: return "explicit";
+  }
+  return "?";
+}
+
+// Small requests come from the heap; large ones are mapped (and therefore
+// must be released with their size, which the allocator interface has).
+void* allocate(size_t bytes, HugePages mode) {
+  if (bytes < kHugePage) {
+    void* p = std::aligned_alloc(kAlign, round_up(std::max<size_t>(bytes, 1), kAlign));
+    if (!p) throw std::bad_alloc();
+    return p;
+  }
+  void* p = map_aligned(round_up(bytes, kHugePage), mode);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void deallocate(void* p, size_t bytes) noexcept {
+  if (!p) return;
+  if (bytes < kHugePage) {
+    std::free(p);
+  } else {
+    ::munmap(p, round_up(bytes, kHugePage));
+  }
+}
+
+// === Arena ===
+
+Arena::Arena(size_t initial_bytes, HugePages mode) : mode_(mode) {
+  if (initial_bytes) {
+    const size_t size = round_up(initial_bytes, kAlign);
+    blocks_.push_back({static_cast<uint8_t*>(neon_mem::allocate(size, mode_)), size});
+  }
+}
+
+Arena::~Arena() {
+  for (const Block& b : blocks_) neon_mem::deallocate(b.data, b.size);
+}
+
+void* Arena::allocate(size_t bytes) {
+  const size_t need = round_up(std::max<size_t>(bytes, 1), kAlign);
+  if (blocks_.empty() || blocks_.back().size - offset_ < need) {
+    // Grow geometrically so a pass needs only a few chained blocks.
+    const size_t last = blocks_.empty() ? 0 : blocks_.back().size;
+    const size_t size = std::max({need, last * 2, size_t(64) << 10});
+    blocks_.push_back({static_cast<uint8_t*>(neon_mem::allocate(size, mode_)), size});
+    offset_ = 0;
+  }
+  uint8_t* p = blocks_.back().data + offset_;
+  offset_ += need;
+  used_ += need;
+  return p;
+}
+
+void Arena::reset() {
+  peak_ = std::max(peak_, used_);
+  if (blocks_.size() > 1) {
+    // Replace the chain with one block that held the busiest pass.
+    size_t total = 0;
+    for (const Block& b : blocks_) {
+      total += b.size;
+      neon_mem::deallocate(b.data, b.size);
+    }
+    blocks_.clear();
+    const size_t size = round_up(std::max(total, peak_), kAlign);
+    blocks_.push_back({static_cast<uint8_t*>(neon_mem::allocate(size, mode_)), size});
+  }
+  offset_ = 0;
+  used_ = 0;
+}
+
+size_t Arena::capacity() const {
+  size_t total = 0;
+  for (const Block& b : blocks_) total += b.size;
+  return total;
+}
+
+} // namespace neon_mem
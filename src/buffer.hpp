@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Memory for inputs, bitmaps and survivor arrays. Everything handed out is
+// 64-byte (cache line) aligned; allocations of kHugePage or more are mapped
+// directly and backed by 2 MiB pages where the OS allows, so a multi-GiB
+// input costs a few hundred TLB entries instead of hundreds of thousands.
+namespace neon_mem {
+
+constexpr size_t kAlign = 64;
+constexpr size_t kHugePage = size_t(2) << 20;
+
+enum class HugePages {
+  Off,          // plain 4K/16K pages
+  Transparent,  // 2 MiB-aligned mapping + MADV_HUGEPAGE (Linux THP)
+  Explicit,     // MAP_HUGETLB from the reserved pool, else Transparent
+};
+
+// $PRIME8_HUGEPAGES (off | thp | explicit), default thp.
+HugePages default_huge_pages();
+const char* huge_pages_name(HugePages mode);
+
+// Raw 64-byte-aligned memory, not zeroed. Release with the same size.
+void* allocate(size_t bytes, HugePages mode = default_huge_pages());
+void deallocate(void* p, size_t bytes) noexcept;
+
+// std::allocator replacement: aligned, huge-page backed when large, and
+// default-initialising, so resize() on a vector of integers reserves memory
+// without zero-filling it. Fill what you read.
+template <class T>
+struct Allocator {
+  using value_type = T;
+
+  Allocator() = default;
+  template <class U>
+  Allocator(const Allocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+    return static_cast<T*>(neon_mem::allocate(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t n) noexcept { neon_mem::deallocate(p, n * sizeof(T)); }
+
+  template <class U>
+  void construct(U* p) noexcept(noexcept(::new (static_cast<void*>(p)) U)) {
+    ::new (static_cast<void*>(p)) U;
+  }
+  template <class U, class... Args>
+  void construct(U* p, Args&&... args) {
+    ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <class U>
+  bool operator==(const Allocator<U>&) const noexcept { return true; }
+  template <class U>
+  bool operator!=(const Allocator<U>&) const noexcept { return false; }
+};
+
+// Drop-in for std::vector in hot paths and benches. Note that
+// `vector<uint8_t> v(n)` leaves the bytes uninitialised; use v(n, 0) for zeros.
+template <class T>
+using vector = std::vector<T, Allocator<T>>;
+
+// Bump allocator for per-call scratch (bitmaps, survivor lists). reset()
+// rewinds without freeing or clearing, so a loop that allocates the same
+// shapes every iteration touches the same (already faulted-in) lines. When a
+// pass outgrows the arena it chains another block; the next reset() merges
+// them into one block big enough for the whole pass.
+class Arena {
+public:
+  explicit Arena(size_t initial_bytes = 0, HugePages mode = default_huge_pages());
+  ~Arena();
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(size_t bytes);
+
+  template <class T>
+  T* alloc(size_t n) {
+    return static_cast<T*>(allocate(n * sizeof(T)));
+  }
+
+  void reset();
+  size_t used() const { return used_; }          // bytes handed out since reset()
+  size_t capacity() const;                        // bytes currently mapped
+
+private:
+  struct Block {
+    uint8_t* data;
+    size_t size;
+  };
+
+  HugePages mode_;
+  std::vector<Block> blocks_;
+  size_t offset_ = 0;  // into blocks_.back()
+  size_t used_ = 0;
+  size_t peak_ = 0;    // most used in any pass
+};
+
+} // namespace neon_mem
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace neon_data {
+
+namespace {
+
+constexpr uint64_t kGolden = 0x9e3779b97f4a7c15ull;
+
+constexpr uint64_t mix64(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+struct SplitMix {
+  uint64_t s;
+  uint64_t next() { return mix64(s += kGolden); }
+  // Uniform in [0, n) by multiply-high; the bias is below 2^-32 for n < 2^32.
+  uint64_t below(uint64_t n) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * n) >> 64);
+  }
+};
+
+constexpr uint32_t kLargestPrime32 = 4294967291u;
+constexpr unsigned kCoprime30[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+// === Random distributions ===
+
+void fill_uniform32(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) c.out[i] = rng.next() & 0xffffffffu;
+}
+
+void fill_uniform64(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) c.out[i] = rng.next();
+}
+
+// Every fifth value just above 2^32 and every eleventh far above it (the
+// > 32-bit rejection path), the rest uniform 32-bit.
+void fill_mixed(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t j = 0; j < c.count; ++j) {
+    const size_t i = c.first + j;
+    const uint64_t r = rng.next();
+    if (i % 5 == 0) c.out[j] = 0x100000000ull + (r & 0xffffu);
+    else if (i % 11 == 0) c.out[j] = (static_cast<uint64_t>(i) << 32) | 0xabcdefu;
+    else c.out[j] = r & 0xffffffffu;
+  }
+}
+
+void fill_odd32(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) c.out[i] = (rng.next() & 0xffffffffu) | 1;
+}
+
+void fill_mult6(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) c.out[i] = 6 * rng.below(0xffffffffu / 6 + 1);
+}
+
+// 80% multiples of 2, 3 or 5 (equally likely), 20% uniform 32-bit.
+void fill_composite80(const Chunk& c) {
+  static constexpr uint64_t kDiv[3] = {2, 3, 5};
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) {
+    const uint64_t pick = rng.below(10);
+    if (pick < 8) {
+      const uint64_t p = kDiv[pick % 3];
+      c.out[i] = p * rng.below(0xffffffffu / p + 1);
+    } else {
+      c.out[i] = rng.next() & 0xffffffffu;
+    }
+  }
+}
+
+// Odd with the top two bits set, the shape of an RSA key-generation candidate
+// scaled to the 32-bit filter range.
+void fill_rsa32(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) c.out[i] = 0xc0000001u | (rng.next() & 0x3ffffffeu);
+}
+
+// Primes in [2^31, 2^32): every lane survives every filter stage.
+void fill_primes32(const Chunk& c) {
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) {
+    uint32_t x = 0x80000001u | static_cast<uint32_t>(rng.next() & 0x7ffffffeu);
+    if (x > kLargestPrime32) x = kLargestPrime32;
+    while (!neon_mr::miller_rabin_32(x)) x += 2;
+    c.out[i] = x;
+  }
+}
+
+// Primes in (2^15, 2^16), sieved once.
+const std::vector<uint32_t>& primes16() {
+  static const std::vector<uint32_t> primes = [] {
+    std::vector<bool> composite(1 << 16);
+    std::vector<uint32_t> out;
+    for (uint32_t i = 2; i < (1u << 16); ++i) {
+      if (composite[i]) continue;
+      if (i > (1u << 15)) out.push_back(i);
+      for (uint32_t j = i * i; j < (1u << 16); j += i) composite[j] = true;
+    }
+    return out;
+  }();
+  return primes;
+}
+
+// p * q with p, q prime in (2^15, 2^16): both factors are beyond every filter
+// prime, so these are the false positives the prefilter must pass on.
+void fill_semiprimes(const Chunk& c) {
+  const auto& p = primes16();
+  SplitMix rng{c.stream};
+  for (size_t i = 0; i < c.count; ++i) {
+    c.out[i] = uint64_t(p[rng.below(p.size())]) * p[rng.below(p.size())];
+  }
+}
+
+// === Sorted ranges (a function of the global index) ===
+
+// Consecutive odd numbers from a start in [2^30, 2^31): below 2^32 for up
+// to 2^30 values.
+void fill_ap_odd(const Chunk& c) {
+  const uint64_t start = ((uint64_t(1) << 30) + (mix64(c.seed) & 0x3fffffffu)) | 1;
+  for (size_t j = 0; j < c.count; ++j) c.out[j] = start + 2 * (c.first + j);
+}
+
+void fill_dense(const Chunk& c) {
+  const uint64_t start = mix64(c.seed) & 0x7fffffffu;
+  for (size_t j = 0; j < c.count; ++j) c.out[j] = start + c.first + j;
+}
+
+// Every wheel-30 candidate from a random multiple of 30 below 2^31.
+void fill_wheel30(const Chunk& c) {
+  const uint64_t k0 = mix64(c.seed) & 0x3ffffffu;
+  for (size_t j = 0; j < c.count; ++j) {
+    const size_t i = c.first + j;
+    c.out[j] = (k0 + i / 8) * 30 + kCoprime30[i % 8];
+  }
+}
+
+const Dataset kDatasets[] = {
+  {"uniform32", "uniform random 32-bit values", fill_uniform32, false},
+  {"uniform64", "uniform random 64-bit values (almost all above 2^32)", fill_uniform64, false},
+  {"mixed", "uniform 32-bit with 27% of values above 2^32", fill_mixed, false},
+  {"odd32", "uniform random odd 32-bit values", fill_odd32, false},
+  {"mult6", "random multiples of 2*3", fill_mult6, false},
+  {"composite80", "80% multiples of 2/3/5, 20% uniform 32-bit", fill_composite80, false},
+  {"rsa32", "odd 32-bit candidates with the top two bits set", fill_rsa32, false},
+  {"primes32", "random primes in [2^31, 2^32)", fill_primes32, false},
+  {"semiprimes", "p*q with p, q prime in (2^15, 2^16)", fill_semiprimes, false},
+  {"ap_odd", "consecutive odd numbers from a random start", fill_ap_odd, true},
+  {"dense", "consecutive integers from a random start", fill_dense, true},
+  {"wheel30", "consecutive wheel-30 candidates (gaps <= 6)", fill_wheel30, true},
+};
+
+Chunk chunk(uint64_t* out, size_t index, size_t count, uint64_t seed) {
+  const size_t first = index * kGenChunk;
+  return {out + first, first, std::min(kGenChunk, count - first), seed,
+          mix64(seed ^ mix64(kGolden * (index + 1)))};
+}
+
+} // namespace
+
+std::span<const Dataset> all() { return kDatasets; }
+
+const Dataset* find(std::string_view name) {
+  for (const Dataset& d : kDatasets) {
+    if (name == d.name) return &d;
+  }
+  return nullptr;
+}
+
+void generate(const Dataset& d, uint64_t* out, size_t count, uint64_t seed) {
+  const size_t chunks = (count + kGenChunk - 1) / kGenChunk;
+  neon_parallel::WorkStealingPool& pool = neon_parallel::default_pool();
+  if (pool.size() == 1 || chunks < 2) return generate_serial(d, out, count, seed);
+  pool.parallel_for(chunks, [&](size_t c) { d.fill(chunk(out, c, count, seed)); });
+}
+
+void generate_serial(const Dataset& d, uint64_t* out, size_t count, uint64_t seed) {
+  for (size_t c = 0; c * kGenChunk < count; ++c) d.fill(chunk(out, c, count, seed));
+}
+
+} // namespace neon_data
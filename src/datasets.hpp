@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// Seeded input distributions shared by the benchmarks and tests.
+//
+// Every dataset is defined per kGenChunk-number chunk: chunk c draws from its
+// own splitmix64 stream derived from (seed, c), and anything global (the start
+// of a dense range) derives from the seed alone. generate() fills chunks on
+// the shared pool, so a billion-number set is built on every core, each
+// worker first-touches the pages it fills, and the result depends only on
+// (dataset, count, seed), never on the thread count.
+namespace neon_data {
+
+constexpr size_t kGenChunk = 65536;
+
+// One chunk of a dataset: global indices [first, first + count).
+struct Chunk {
+  uint64_t* out;
+  size_t first;
+  size_t count;
+  uint64_t seed;     // the dataset seed
+  uint64_t stream;   // this chunk's RNG seed
+};
+
+struct Dataset {
+  const char* name;
+  const char* description;
+  void (*fill)(const Chunk& chunk);
+  bool sorted;       // ascending (usable with neon_delta)
+};
+
+// uniform32, uniform64, mixed, odd32, mult6, composite80, rsa32, primes32,
+// semiprimes, ap_odd, dense, wheel30.
+std::span<const Dataset> all();
+const Dataset* find(std::string_view name);
+
+void generate(const Dataset& d, uint64_t* out, size_t count, uint64_t seed);
+
+// Serial; for callers that must not touch the pool.
+void generate_serial(const Dataset& d, uint64_t* out, size_t count, uint64_t seed);
+
+} // namespace neon_data
@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "delta.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+#include "wheel_core.hpp"
+
+#include <algorithm>
+#include <array>
+#include <arm_neon.h>
+#include <cstring>
+#include <utility>
+
+namespace neon_delta {
+
+namespace {
+
+constexpr size_t kRows = kBlock / 4;
+
+BlockHeader read_header(const uint8_t* p) {
+  BlockHeader h;
+  std::memcpy(&h, p, sizeof(h));
+  return h;
+}
+
+// === Row decode ===
+// Row R of a width-W block: bits [R*W, R*W + W) of each lane's stream, which
+// is stored as W u32x4 words (word k holds bits 32k.. of all four lanes).
+// Everything but the loads folds to constant shifts.
+template <unsigned W, unsigned R>
+__attribute__((always_inline)) inline
+uint32x4_t unpack_row(const uint32_t* words) {
+  if constexpr (W == 0) {
+    return vdupq_n_u32(0);
+  } else {
+    constexpr unsigned pos = R * W, k = pos / 32, off = pos % 32;
+    uint32x4_t x = vld1q_u32(words + 4 * k);
+    if constexpr (off != 0) x = vshrq_n_u32(x, off);
+    if constexpr (off + W > 32) x = vorrq_u32(x, vshlq_n_u32(vld1q_u32(words + 4 * (k + 1)), 32 - off));
+    if constexpr (W < 32) x = vandq_u32(x, vdupq_n_u32((1u << W) - 1));
+    return x;
+  }
+}
+
+// Inclusive prefix sum of the four lanes.
+__attribute__((always_inline)) inline
+uint32x4_t prefix4(uint32x4_t x) {
+  const uint32x4_t zero = vdupq_n_u32(0);
+  x = vaddq_u32(x, vextq_u32(zero, x, 3));
+  return vaddq_u32(x, vextq_u32(zero, x, 2));
+}
+
+// Calls row(integral_constant<R>, gaps) for R = 0..31 with each row's
+// in-row prefix sums, fully unrolled.
+template <unsigned W, class Row>
+__attribute__((always_inline)) inline
+void walk_rows(const uint8_t* payload, Row&& row) {
+  const auto* words = reinterpret_cast<const uint32_t*>(payload);
+  [&]<unsigned... R>(std::integer_sequence<unsigned, R...>) {
+    (row(std::integral_constant<unsigned, R>{}, prefix4(unpack_row<W, R>(words))), ...);
+  }(std::make_integer_sequence<unsigned, kRows>{});
+}
+
+// === Block kernels ===
+// A block is written as 16 whole bitmap bytes; the caller trims the last one.
+
+using BlockFilter = uint32_t (*)(const uint8_t* payload, uint64_t base, uint8_t* bits);
+using BlockDecode = void (*)(const uint8_t* payload, uint64_t base, uint64_t* out);
+
+template <unsigned W>
+uint32_t filter_block(const uint8_t* payload, uint64_t base, uint8_t* bits) {
+  if (base > 0xffffffffu) {  // ascending: no value in the block fits 32 bits
+    std::memset(bits, 0, kBlock / 8);
+    return 0;
+  }
+  PRIME8_STATS_SCOPE
+  uint64_t acc = base;
+  uint32x4_t n[4], en[4];
+  uint16_t out[kRows / 4];
+  walk_rows<W>(payload, [&](auto r, uint32x4_t p) {
+    constexpr unsigned R = decltype(r)::value;
+    // acc + p in 32 bits; a lane wrapped (n < p) iff its value is >= 2^32.
+    n[R % 4] = vaddq_u32(vdupq_n_u32(uint32_t(acc)), p);
+    en[R % 4] = acc <= 0xffffffffu ? vcgeq_u32(n[R % 4], p) : vdupq_n_u32(0);
+    acc += vgetq_lane_u32(p, 3);
+    if constexpr (R % 4 == 3) {
+      uint32x4_t w[4];
+      for (int q = 0; q < 4; ++q) w[q] = vandq_u32(neon_wheel::wheel30_lanes(n[q]), en[q]);
+      PRIME8_STATS_ONLY(neon_stats::wheel_step(stats, 16, en[0], en[1], en[2], en[3],
+                                               w[0], w[1], w[2], w[3]);)
+      out[R / 4] = neon_wheel::sieve16_u32(n[0], n[1], n[2], n[3], w[0], w[1], w[2], w[3]
+                                           PRIME8_STATS_ARG);
+    }
+  });
+  std::memcpy(bits, out, sizeof(out));
+  uint32_t survivors = 0;
+  for (uint16_t b : out) survivors += __builtin_popcount(b);
+  return survivors;
+}
+
+uint32_t filter_raw_block(const uint8_t* payload, uint64_t, uint8_t* bits) {
+  uint64_t values[kBlock];
+  std::memcpy(values, payload, sizeof(values));
+  neon_wheel::filter_stream_u64_wheel_bitmap(values, bits, kBlock);
+  uint32_t survivors = 0;
+  for (size_t i = 0; i < kBlock / 8; ++i) survivors += __builtin_popcount(bits[i]);
+  return survivors;
+}
+
+template <unsigned W>
+void decode_block(const uint8_t* payload, uint64_t base, uint64_t* out) {
+  uint64_t acc = base;
+  walk_rows<W>(payload, [&](auto r, uint32x4_t p) {
+    constexpr unsigned R = decltype(r)::value;
+    const uint64x2_t a = vdupq_n_u64(acc);
+    vst1q_u64(out + 4 * R, vaddq_u64(a, vmovl_u32(vget_low_u32(p))));
+    vst1q_u64(out + 4 * R + 2, vaddq_u64(a, vmovl_u32(vget_high_u32(p))));
+    acc += vgetq_lane_u32(p, 3);
+  });
+}
+
+void decode_raw_block(const uint8_t* payload, uint64_t, uint64_t* out) {
+  std::memcpy(out, payload, kBlock * sizeof(uint64_t));
+}
+
+template <unsigned... W>
+constexpr auto make_filters(std::integer_sequence<unsigned, W...>) {
+  return std::array<BlockFilter, sizeof...(W)>{filter_block<W>...};
+}
+template <unsigned... W>
+constexpr auto make_decoders(std::integer_sequence<unsigned, W...>) {
+  return std::array<BlockDecode, sizeof...(W)>{decode_block<W>...};
+}
+
+constexpr auto kFilters = make_filters(std::make_integer_sequence<unsigned, kMaxPackedWidth + 1>{});
+constexpr auto kDecoders = make_decoders(std::make_integer_sequence<unsigned, kMaxPackedWidth + 1>{});
+
+// Filters blocks [first, last) starting at byte offset `offset` of view.data.
+size_t filter_range(const View& view, size_t first, size_t last, size_t offset,
+                    uint8_t* bitmap) {
+  size_t survivors = 0;
+  const uint8_t* p = view.data + offset;
+  for (size_t b = first; b < last; ++b) {
+    const BlockHeader h = read_header(p);
+    const uint8_t* payload = p + sizeof(BlockHeader);
+    const BlockFilter fn = h.width == kRawWidth ? filter_raw_block : kFilters[h.width];
+    if (h.count == kBlock) {
+      survivors += fn(payload, h.base, bitmap + b * (kBlock / 8));
+    } else {
+      uint8_t bits[kBlock / 8];
+      fn(payload, h.base, bits);
+      const size_t bytes = (h.count + 7) / 8;
+      if (h.count % 8) bits[bytes - 1] &= uint8_t((1u << (h.count % 8)) - 1);
+      for (size_t i = 0; i < bytes; ++i) survivors += __builtin_popcount(bits[i]);
+      std::memcpy(bitmap + b * (kBlock / 8), bits, bytes);
+    }
+    p = payload + payload_bytes(h.width);
+  }
+  return survivors;
+}
+
+} // namespace
+
+// === Encoder ===
+
+size_t encode(const uint64_t* values, size_t count, uint8_t* out) {
+  const size_t blocks = (count + kBlock - 1) / kBlock;
+  const FileHeader fh{kMagic, kVersion, count, blocks, 0};
+  std::memcpy(out, &fh, sizeof(fh));
+  uint8_t* p = out + sizeof(fh);
+
+  for (size_t b = 0; b < blocks; ++b) {
+    const uint64_t* v = values + b * kBlock;
+    const size_t n = std::min(kBlock, count - b * kBlock);
+    if (b && v[0] < v[-1]) return 0;
+    uint64_t max_gap = 0;
+    for (size_t j = 1; j < n; ++j) {
+      if (v[j] < v[j - 1]) return 0;
+      max_gap = std::max(max_gap, v[j] - v[j - 1]);
+    }
+    const unsigned bits = max_gap ? 64 - __builtin_clzll(max_gap) : 0;
+    const unsigned width = bits <= kMaxPackedWidth ? bits : kRawWidth;
+
+    BlockHeader h{};
+    h.base = v[0];
+    h.count = static_cast<uint16_t>(n);
+    h.width = static_cast<uint8_t>(width);
+    std::memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+
+    if (width == kRawWidth) {
+      uint64_t raw[kBlock];
+      for (size_t j = 0; j < kBlock; ++j) raw[j] = v[std::min(j, n - 1)];
+      std::memcpy(p, raw, sizeof(raw));
+    } else {
+      uint32_t words[4 * kMaxPackedWidth] = {};
+      for (size_t j = 1; j < n; ++j) {
+        const uint32_t gap = static_cast<uint32_t>(v[j] - v[j - 1]);
+        const unsigned lane = j % 4, pos = unsigned(j / 4) * width;
+        const unsigned k = pos / 32, off = pos % 32;
+        words[4 * k + lane] |= gap << off;
+        if (off + width > 32) words[4 * (k + 1) + lane] |= gap >> (32 - off);
+      }
+      std::memcpy(p, words, payload_bytes(width));
+    }
+    p += payload_bytes(width);
+  }
+  return static_cast<size_t>(p - out);
+}
+
+// === Reader ===
+
+const char* open(const uint8_t* data, size_t bytes, View& view) {
+  FileHeader fh;
+  if (bytes < sizeof(fh)) return "truncated header";
+  std::memcpy(&fh, data, sizeof(fh));
+  if (fh.magic != kMagic) return "bad magic";
+  if (fh.version != kVersion) return "unsupported version";
+  // Header fields are untrusted: no overflow in the block count, and no
+  // allocation sized by it before it is checked against the input.
+  if (fh.blocks != fh.count / kBlock + (fh.count % kBlock != 0)) {
+    return "block count does not match value count";
+  }
+  if (fh.blocks > (bytes - sizeof(fh)) / sizeof(BlockHeader)) return "truncated block header";
+
+  view = View{};
+  view.data = data + sizeof(fh);
+  view.count = fh.count;
+  view.blocks = fh.blocks;
+  view.chunk_offsets.reserve((fh.blocks + kChunkBlocks - 1) / kChunkBlocks);
+  size_t off = 0;
+  const size_t avail = bytes - sizeof(fh);
+  for (uint64_t b = 0; b < fh.blocks; ++b) {
+    if (b % kChunkBlocks == 0) view.chunk_offsets.push_back(off);
+    if (avail - off < sizeof(BlockHeader)) return "truncated block header";
+    const BlockHeader h = read_header(view.data + off);
+    if (h.width > kMaxPackedWidth && h.width != kRawWidth) return "bad block width";
+    const uint64_t want = b + 1 < fh.blocks ? kBlock : fh.count - b * kBlock;
+    if (h.count != want) return "bad block length";
+    off += sizeof(BlockHeader);
+    if (avail - off < payload_bytes(h.width)) return "truncated block";
+    off += payload_bytes(h.width);
+  }
+  view.bytes = sizeof(fh) + off;
+  return nullptr;
+}
+
+size_t decode(const View& view, uint64_t* out) {
+  const uint8_t* p = view.data;
+  for (size_t b = 0; b < view.blocks; ++b) {
+    const BlockHeader h = read_header(p);
+    const uint8_t* payload = p + sizeof(BlockHeader);
+    const BlockDecode fn = h.width == kRawWidth ? decode_raw_block : kDecoders[h.width];
+    if (h.count == kBlock) {
+      fn(payload, h.base, out + b * kBlock);
+    } else {
+      uint64_t values[kBlock];
+      fn(payload, h.base, values);
+      std::memcpy(out + b * kBlock, values, h.count * sizeof(uint64_t));
+    }
+    p = payload + payload_bytes(h.width);
+  }
+  return view.count;
+}
+
+// === Fused filter ===
+
+size_t filter_wheel_bitmap(const View& view, uint8_t* bitmap) {
+  return filter_range(view, 0, view.blocks, 0, bitmap);
+}
+
+size_t parallel_filter_wheel_bitmap(const View& view, uint8_t* bitmap) {
+  const size_t chunks = view.chunk_offsets.size();
+  neon_parallel::WorkStealingPool& pool = neon_parallel::default_pool();
+  if (pool.size() == 1 || chunks < 2) return filter_wheel_bitmap(view, bitmap);
+  std::vector<size_t> survivors(chunks);
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t first = c * kChunkBlocks;
+    const size_t last = std::min<size_t>(view.blocks, first + kChunkBlocks);
+    survivors[c] = filter_range(view, first, last, view.chunk_offsets[c], bitmap);
+  });
+  size_t total = 0;
+  for (size_t s : survivors) total += s;
+  return total;
+}
+
+} // namespace neon_delta
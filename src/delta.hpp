@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed input for sorted candidate lists.
+//
+// Values are cut into blocks of kBlock. Each block stores its first value
+// (base) in a 16-byte header and the 127 gaps to the following values
+// bit-packed at the block's own width, frame-of-reference style. The packing
+// is vertical over four 32-bit lanes (value j sits in lane j % 4, row j / 4):
+// width w costs 16 * w bytes per block. A dense list of wheel-30 candidates
+// has gaps of at most 6 and needs 3 bits per value instead of 64.
+//
+// The filter kernel decodes a block four rows (16 values) at a time in
+// registers, using shifts and an in-register prefix sum, and feeds the lanes
+// straight to the wheel-30 + Barrett stage. Decoded values are never written
+// to memory, so a pass reads about w/64 of the bytes that raw u64 input needs.
+//
+// Blocks whose largest gap needs more than kMaxPackedWidth bits are stored raw
+// (kRawWidth, 128 u64s). The last block may be partial; its padding gaps are 0.
+namespace neon_delta {
+
+constexpr uint32_t kMagic = 0x31443850u;  // "P8D1"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kBlock = 128;
+constexpr unsigned kMaxPackedWidth = 30;  // four gaps summed in a u32 lane cannot overflow
+constexpr unsigned kRawWidth = 64;
+
+// Blocks per parallel work item: 32768 numbers, a 4 KiB bitmap slice.
+constexpr size_t kChunkBlocks = 256;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t count;     // values
+  uint64_t blocks;
+  uint64_t reserved;
+};
+
+struct BlockHeader {
+  uint64_t base;      // first value of the block
+  uint16_t count;     // kBlock except in the last block
+  uint8_t width;      // 0..kMaxPackedWidth, or kRawWidth
+  uint8_t reserved[5];
+};
+
+static_assert(sizeof(FileHeader) == 32 && sizeof(BlockHeader) == 16, "on-disk layout");
+
+constexpr size_t payload_bytes(unsigned width) {
+  return width == kRawWidth ? kBlock * sizeof(uint64_t) : width * 16;
+}
+
+// Largest encoding of count values (every block raw).
+constexpr size_t encoded_bound(size_t count) {
+  return sizeof(FileHeader) +
+         (count + kBlock - 1) / kBlock * (sizeof(BlockHeader) + payload_bytes(kRawWidth));
+}
+
+// Encodes values (ascending; equal neighbours allowed) into out, which holds
+// encoded_bound(count) bytes. Returns the bytes written, or 0 if values are
+// not ascending.
+size_t encode(const uint64_t* values, size_t count, uint8_t* out);
+
+// A validated encoding. data must outlive the view.
+struct View {
+  const uint8_t* data = nullptr;      // first block header
+  uint64_t count = 0;
+  uint64_t blocks = 0;
+  size_t bytes = 0;                   // of the whole encoding, header included
+  std::vector<size_t> chunk_offsets;  // offset (from data) of every kChunkBlocks-th block
+};
+
+// Checks the header and walks every block header. Returns nullptr on success,
+// otherwise why the buffer is not a valid encoding.
+const char* open(const uint8_t* data, size_t bytes, View& view);
+
+// Writes the view.count values to out. Returns view.count.
+size_t decode(const View& view, uint64_t* out);
+
+// Fused decode + wheel-30/Barrett filter: bit i of bitmap[i >> 3] is set iff
+// value i survives neon_wheel::filter_stream_u64_wheel_bitmap. Bits past
+// count in the last byte are cleared. Returns the number of survivors.
+size_t filter_wheel_bitmap(const View& view, uint8_t* bitmap);
+
+// Same, kChunkBlocks blocks per work item on the shared pool.
+size_t parallel_filter_wheel_bitmap(const View& view, uint8_t* bitmap);
+
+} // namespace neon_delta
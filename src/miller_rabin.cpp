@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include "primes_tables.hpp"
+#include <cstdint>
+
+namespace neon_mr {
+
+// === 32-bit ===
+// Bases {2, 7, 61} are deterministic below 4 759 123 141 > 2^32.
+__attribute__((always_inline)) inline
+uint32_t powmod32(uint32_t a, uint32_t e, uint32_t n) {
+  uint64_t x = 1, b = a;
+  while (e) {
+    if (e & 1) x = (x * b) % n;
+    b = (b * b) % n;
+    e >>= 1;
+  }
+  return (uint32_t)x;
+}
+
+bool miller_rabin_32(uint32_t n) {
+  if (n < 2) return false;
+  if (n < 4) return true;
+  if ((n & 1) == 0) return false;
+
+  uint32_t d = n - 1;
+  int r = __builtin_ctz(d);
+  d >>= r;
+
+  static constexpr uint32_t kBases[3] = {2, 7, 61};
+  for (uint32_t a : kBases) {
+    if (a % n == 0) continue;
+    uint64_t x = powmod32(a, d, n);
+    if (x == 1 || x == n - 1) continue;
+    bool composite = true;
+    for (int i = 1; i < r; ++i) {
+      x = (x * x) % n;
+      if (x == n - 1) { composite = false; break; }
+    }
+    if (composite) return false;
+  }
+  return true;
+}
+
+// === 64-bit ===
+// Jim Sinclair's 7 bases are deterministic for all n < 2^64.
+__attribute__((always_inline)) inline
+uint64_t mulmod64(uint64_t a, uint64_t b, uint64_t n) {
+  return (uint64_t)((unsigned __int128)a * b % n);
+}
+
+bool miller_rabin_64(uint64_t n) {
+  if (n <= 0xffffffffu) return miller_rabin_32((uint32_t)n);
+  if ((n & 1) == 0) return false;
+
+  uint64_t d = n - 1;
+  int r = __builtin_ctzll(d);
+  d >>= r;
+
+  static constexpr uint64_t kBases[7] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+  for (uint64_t a : kBases) {
+    uint64_t b = a % n;
+    if (b == 0) continue;
+    uint64_t x = 1;
+    for (uint64_t e = d; e; e >>= 1) {
+      if (e & 1) x = mulmod64(x, b, n);
+      b = mulmod64(b, b, n);
+    }
+    if (x == 1 || x == n - 1) continue;
+    bool composite = true;
+    for (int i = 1; i < r; ++i) {
+      x = mulmod64(x, x, n);
+      if (x == n - 1) { composite = false; break; }
+    }
+    if (composite) return false;
+  }
+  return true;
+}
+
+// The SIMD filters reject > 32-bit values outright; this is the scalar
+// screen-then-confirm path the exact engines use for them.
+bool is_prime_64(uint64_t n) {
+  if (n <= 0xffffffffu) return miller_rabin_32((uint32_t)n);
+  for (uint32_t p : SMALL_PRIMES) if (n % p == 0) return false;
+  for (uint32_t p : EXT_PRIMES) if (n % p == 0) return false;
+  return miller_rabin_64(n);
+}
+
+} // namespace neon_mr
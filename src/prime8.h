@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (c) 2025 Justin Guida */
+/*
+ * Stable C ABI for libprime8 (ctypes, cffi, or any FFI).
+ *
+ * Every entry point takes raw pointers plus an element count and writes into
+ * caller-provided buffers, so NumPy arrays (or any contiguous u64 buffer) are
+ * used in place without copies. Nothing here allocates memory the caller has
+ * to free, and no C++ types cross the boundary.
+ *
+ * Kernel ids match the hybrid_driver wire protocol. Functions returning int
+ * or int64_t return a negative PRIME8_E* code on bad arguments or failure;
+ * no C++ exception ever leaves an entry point.
+ */
+#ifndef PRIME8_H
+#define PRIME8_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PRIME8_API __attribute__((visibility("default")))
+#else
+#define PRIME8_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped only when an existing signature or meaning changes. */
+#define PRIME8_ABI_VERSION 1
+
+/* Prefilter kernels: survivor iff no prime <= 53 divides n (or n is that
+ * prime) and n < 2^32. PRIME8_PRIME is exact: survivor iff n is prime.
+ * Every kernel writes its bitmap in whole bytes: the padding bits past count
+ * in the last byte come out zero whatever the buffer held, so callers may
+ * popcount the bytes directly. */
+enum prime8_kernel {
+  PRIME8_WHEEL30 = 0,
+  PRIME8_WHEEL210 = 1,
+  PRIME8_BARRETT16 = 2,
+  PRIME8_SIEVE = 3,
+  PRIME8_PRIME = 4
+};
+
+/* Flags for the filter functions. */
+#define PRIME8_PARALLEL 1u    /* use the shared thread pool where the kernel has a parallel variant */
+#define PRIME8_NONTEMPORAL 2u /* prime8_filter_bitmap: write the bitmap with non-temporal stores */
+
+enum prime8_error {
+  PRIME8_OK = 0,
+  PRIME8_EKERNEL = -1, /* unknown kernel id */
+  PRIME8_ENULL = -2,   /* NULL buffer with count > 0 */
+  PRIME8_ENOMEM = -3,  /* scratch memory (e.g. the PRIME8_PARALLEL bitmap) could not be allocated */
+  PRIME8_EINTERNAL = -4 /* other failure inside the library, e.g. a pool thread could not start */
+};
+
+PRIME8_API int prime8_abi_version(void);
+
+/* Kernel name ("wheel30", ...) or NULL for an unknown id. */
+PRIME8_API const char* prime8_kernel_name(int kernel);
+
+/* Bit i of bitmap[i / 8] set iff numbers[i] survives; bitmap holds
+ * (count + 7) / 8 bytes. Returns PRIME8_OK, or a PRIME8_E* code. */
+PRIME8_API int prime8_filter_bitmap(int kernel, const uint64_t* numbers, size_t count,
+                                    uint8_t* bitmap, unsigned flags);
+
+/* Number of survivors. */
+PRIME8_API int64_t prime8_count(int kernel, const uint64_t* numbers, size_t count,
+                                unsigned flags);
+
+/* Writes the survivors to out in input order and returns how many. out needs
+ * room for count values in the worst case and may equal numbers (in place). */
+PRIME8_API int64_t prime8_compact(int kernel, const uint64_t* numbers, size_t count,
+                                  uint64_t* out, unsigned flags);
+
+/* Overwrites numbers with its own survivors, in input order, and returns the
+ * new length. Needs no scratch beyond a stack bitmap, so peak memory is the
+ * input alone. */
+PRIME8_API int64_t prime8_filter_inplace(int kernel, uint64_t* numbers, size_t count,
+                                         unsigned flags);
+
+/* Exact confirmation: is_prime[i] = 1 iff numbers[i] is prime, else 0.
+ * Returns the number of primes. */
+PRIME8_API int64_t prime8_confirm(const uint64_t* numbers, size_t count, uint8_t* is_prime);
+
+PRIME8_API int prime8_is_prime(uint64_t n);
+
+/* Per-stage lane counters, summed over every thread since the last reset.
+ * Only counted in a library built with -DPRIME8_STATS=ON; otherwise all zero.
+ * Groups are {2,3}, {5,7}, {11..19}, {23..37}, {41..53}. */
+typedef struct prime8_stats {
+  uint64_t lanes;        /* values entering an instrumented vector step */
+  uint64_t wide;         /* of those, above 32 bits: dropped by the fallback */
+  uint64_t wheel;        /* dropped by the wheel-30 prefilter */
+  uint64_t group[5];     /* dropped by each prime group */
+  uint64_t survivors;
+  uint64_t steps;        /* barrett16 8-lane early-out steps */
+  uint64_t early_out[4]; /* of those, left after group g with no lane alive */
+  uint64_t wheel_skips;  /* barrett16 8-lane steps the wheel skipped whole */
+} prime8_stats;
+
+/* 1 if the counters are compiled in, else 0. */
+PRIME8_API int prime8_stats_enabled(void);
+
+/* Fills *out. Returns PRIME8_OK, or PRIME8_ENULL for a NULL out. */
+PRIME8_API int prime8_stats_get(prime8_stats* out);
+
+/* Zeroes the counters. Call while no filter is running. */
+PRIME8_API void prime8_stats_reset(void);
+
+/* Which autotune profile PRIME8_WHEEL30 runs under, e.g. "loaded <path>",
+ * "none (...)" or "ignored <path>: <reason>". Reading it loads the profile if
+ * no filter call has yet. Written by prime8-autotune; see README. */
+PRIME8_API const char* prime8_profile(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PRIME8_H */
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "prime8.h"
+#include "autotune.hpp"
+#include "simd_fast.hpp"
+#include "stats.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace {
+
+using BitmapKernel = void (*)(const uint64_t* __restrict, uint8_t* __restrict, size_t);
+
+void fused_prime_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap,
+                        size_t count) {
+  neon_fused::fused_prime_bitmap(numbers, bitmap, count);
+}
+
+// wheel30 runs under this host's autotune profile (autotune.hpp), if any.
+void tuned_wheel_parallel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap,
+                          size_t count) {
+  neon_parallel::parallel_filter_stream(neon_tune::filter_wheel_bitmap, true, numbers, bitmap,
+                                        count, neon_stream::OutputPolicy::Cached);
+}
+
+struct KernelEntry {
+  const char* name;
+  BitmapKernel serial;
+  BitmapKernel parallel;  // nullptr: no parallel variant, serial is used
+  BitmapKernel small;     // batches up to kSmallBatchMax; nullptr: serial
+};
+
+// Indexed by prime8_kernel.
+const KernelEntry kKernels[] = {
+  {"wheel30", neon_tune::filter_wheel_bitmap, tuned_wheel_parallel,
+   neon_small::filter_small_u64_wheel_bitmap},
+  {"wheel210", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+   neon_parallel::parallel_filter_stream_u64_wheel210_efficient_bitmap, nullptr},
+  {"barrett16", neon_fast::filter_stream_u64_barrett16_bitmap,
+   neon_parallel::parallel_filter_stream_u64_barrett16_bitmap,
+   neon_small::filter_small_u64_wheel_bitmap},
+  {"sieve", neon_block_sieve::filter_stream_u64_sieve_bitmap, nullptr, nullptr},
+  {"prime", fused_prime_kernel, nullptr, nullptr},
+};
+constexpr int kNumKernels = sizeof(kKernels) / sizeof(kKernels[0]);
+
+const KernelEntry* lookup(int kernel) {
+  return kernel >= 0 && kernel < kNumKernels ? &kKernels[kernel] : nullptr;
+}
+
+// Service-sized batches skip the stream kernels' setup (and the pool, which
+// cannot pay off on a few thousand numbers).
+BitmapKernel pick(const KernelEntry& k, unsigned flags, size_t count) {
+  if (count <= neon_small::kSmallBatchMax && k.small) return k.small;
+  return (flags & PRIME8_PARALLEL) && k.parallel ? k.parallel : k.serial;
+}
+
+// Serial blocks keep their bitmap on the stack (2 KiB, L1-resident); parallel
+// blocks are large enough to give every pool slot several kParallelChunks.
+constexpr size_t kSerialBlock = 16384;
+constexpr size_t kParallelBlock = size_t(1) << 20;
+
+// Runs the kernel block by block and calls visit(base, bitmap, len) for each.
+// The kernel reads a block before visit() sees it, so visit() may overwrite
+// numbers at or below the block (in-place compaction).
+template <class Visit>
+int64_t for_each_block(int kernel, const uint64_t* numbers, size_t count, unsigned flags,
+                       Visit&& visit) {
+  const KernelEntry* k = lookup(kernel);
+  if (!k) return PRIME8_EKERNEL;
+  if (count && !numbers) return PRIME8_ENULL;
+  const BitmapKernel fn = pick(*k, flags, count);
+
+  uint8_t stack_bitmap[kSerialBlock / 8];
+  std::vector<uint8_t> heap_bitmap;
+  uint8_t* bitmap = stack_bitmap;
+  size_t block = kSerialBlock;
+  if (fn == k->parallel && count > kSerialBlock) {
+    block = kParallelBlock;
+    heap_bitmap.resize(block / 8);
+    bitmap = heap_bitmap.data();
+  }
+
+  for (size_t base = 0; base < count; base += block) {
+    const size_t len = std::min(block, count - base);
+    fn(numbers + base, bitmap, len);
+    visit(base, bitmap, len);
+  }
+  return PRIME8_OK;
+}
+
+// Bitmap words covering len numbers. The tail word is masked to len bits:
+// the block bitmap is reused, so bits past len are not this block's.
+__attribute__((always_inline)) inline
+uint64_t load_word(const uint8_t* bitmap, size_t w, size_t len) {
+  const size_t bytes = (len + 7) / 8;
+  uint64_t word = 0;
+  std::memcpy(&word, bitmap + w * 8, std::min<size_t>(8, bytes - w * 8));
+  const size_t bits = len - w * 64;
+  return bits < 64 ? word & ((uint64_t(1) << bits) - 1) : word;
+}
+
+// Runs an entry point's body with no exception escaping into the C caller
+// (ctypes would abort the process): allocation failures become
+// PRIME8_ENOMEM and anything else, e.g. a pool thread that could not start,
+// PRIME8_EINTERNAL.
+template <class F>
+auto guarded(F&& body) noexcept -> decltype(body()) {
+  try {
+    return body();
+  } catch (const std::bad_alloc&) {
+    return PRIME8_ENOMEM;
+  } catch (...) {
+    return PRIME8_EINTERNAL;
+  }
+}
+
+} // namespace
+
+extern "C" {
+
+int prime8_abi_version(void) { return PRIME8_ABI_VERSION; }
+
+const char* prime8_kernel_name(int kernel) {
+  const KernelEntry* k = lookup(kernel);
+  return k ? k->name : nullptr;
+}
+
+int prime8_filter_bitmap(int kernel, const uint64_t* numbers, size_t count, uint8_t* bitmap,
+                         unsigned flags) {
+  const KernelEntry* k = lookup(kernel);
+  if (!k) return PRIME8_EKERNEL;
+  if (count && (!numbers || !bitmap)) return PRIME8_ENULL;
+  return guarded([&]() -> int {
+    if (flags & PRIME8_NONTEMPORAL) {
+      const auto nt = neon_stream::OutputPolicy::NonTemporal;
+      if ((flags & PRIME8_PARALLEL) && k->parallel) {
+        neon_parallel::parallel_filter_stream(k->serial, true, numbers, bitmap, count, nt);
+      } else {
+        neon_stream::filter_stream(k->serial, true, numbers, bitmap, count, nt);
+      }
+      return PRIME8_OK;
+    }
+    pick(*k, flags, count)(numbers, bitmap, count);
+    return PRIME8_OK;
+  });
+}
+
+int64_t prime8_count(int kernel, const uint64_t* numbers, size_t count, unsigned flags) {
+  return guarded([&]() -> int64_t {
+    int64_t survivors = 0;
+    const int64_t rc = for_each_block(kernel, numbers, count, flags,
+                                      [&](size_t, const uint8_t* bitmap, size_t len) {
+      for (size_t w = 0; w * 64 < len; ++w) {
+        survivors += __builtin_popcountll(load_word(bitmap, w, len));
+      }
+    });
+    return rc < 0 ? rc : survivors;
+  });
+}
+
+int64_t prime8_compact(int kernel, const uint64_t* numbers, size_t count, uint64_t* out,
+                       unsigned flags) {
+  if (count && !out) return PRIME8_ENULL;
+  return guarded([&]() -> int64_t {
+    size_t k = 0;
+    const int64_t rc = for_each_block(kernel, numbers, count, flags,
+                                      [&](size_t base, const uint8_t* bitmap, size_t len) {
+      k += neon_inplace::left_pack(numbers + base, bitmap, len, out + k);
+    });
+    return rc < 0 ? rc : static_cast<int64_t>(k);
+  });
+}
+
+int64_t prime8_filter_inplace(int kernel, uint64_t* numbers, size_t count, unsigned flags) {
+  const KernelEntry* k = lookup(kernel);
+  if (!k) return PRIME8_EKERNEL;
+  if (count && !numbers) return PRIME8_ENULL;
+  return guarded([&]() -> int64_t {
+    if ((flags & PRIME8_PARALLEL) && k->parallel) {
+      return static_cast<int64_t>(neon_parallel::parallel_filter_inplace(k->serial, numbers, count));
+    }
+    return static_cast<int64_t>(neon_inplace::filter_inplace(k->serial, numbers, count));
+  });
+}
+
+int64_t prime8_confirm(const uint64_t* numbers, size_t count, uint8_t* is_prime) {
+  if (count && (!numbers || !is_prime)) return PRIME8_ENULL;
+  return guarded([&]() -> int64_t {
+    return static_cast<int64_t>(neon_fused::fused_prime_flags(numbers, is_prime, count));
+  });
+}
+
+int prime8_is_prime(uint64_t n) { return neon_mr::is_prime_64(n) ? 1 : 0; }
+
+int prime8_stats_enabled(void) { return neon_stats::kEnabled ? 1 : 0; }
+
+int prime8_stats_get(prime8_stats* out) {
+  static_assert(sizeof(prime8_stats) == sizeof(neon_stats::Snapshot),
+                "prime8_stats must mirror neon_stats::Fields");
+  if (!out) return PRIME8_ENULL;
+  return guarded([&]() -> int {
+    const neon_stats::Snapshot s = neon_stats::snapshot();
+    std::memcpy(out, &s, sizeof(*out));
+    return PRIME8_OK;
+  });
+}
+
+// reset() and the profile load take locks and allocate; neither has an
+// error code to return, so a failure leaves the counters as they were or
+// reports no profile.
+void prime8_stats_reset(void) {
+  try {
+    neon_stats::reset();
+  } catch (...) {
+  }
+}
+
+const char* prime8_profile(void) {
+  try {
+    return neon_tune::status().c_str();
+  } catch (...) {
+    return "none (profile could not be loaded)";
+  }
+}
+
+} // extern "C"
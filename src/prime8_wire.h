@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/* Copyright (c) 2025 Justin Guida */
+/*
+ * Binary request/response framing shared by the out-of-process front ends
+ * (bench/hybrid_driver over stdin/stdout, tools/prime8d over a Unix socket).
+ * Everything is little-endian; nothing is parsed as text.
+ *
+ *   request  : prime8_request (16 bytes) + count u64 numbers
+ *   response : prime8_response (24 bytes) + payload_bytes of payload
+ *
+ *   PRIME8_OUT_BITMAP    -> (count + 7) / 8 bytes, bit i of byte i/8 = survivor i
+ *   PRIME8_OUT_SURVIVORS -> the surviving u64s in input order
+ *   PRIME8_OUT_COUNT     -> no payload; the count is in the header
+ *
+ * mode is a prime8_kernel id (prime8.h). A request with an unknown mode or
+ * output is still consumed in full and answered with a non-zero status and
+ * no payload. A bad magic means the stream is out of sync and is fatal.
+ * prime8d answers a count above PRIME8_MAX_COUNT with
+ * PRIME8_STATUS_TOO_LARGE and closes the connection without reading the
+ * payload, rather than trying to buffer it. A request whose kernel call
+ * fails (out of memory, internal error) is answered with
+ * PRIME8_STATUS_FAILED and no payload; the stream stays in sync.
+ */
+#ifndef PRIME8_WIRE_H
+#define PRIME8_WIRE_H
+
+#include <stdint.h>
+
+#define PRIME8_REQUEST_MAGIC 0x51384550u  /* "PE8Q" */
+#define PRIME8_RESPONSE_MAGIC 0x52384550u /* "PE8R" */
+#define PRIME8_MAX_COUNT (1ull << 26)    /* numbers per request: 512 MiB */
+
+enum prime8_output {
+  PRIME8_OUT_BITMAP = 0,
+  PRIME8_OUT_SURVIVORS = 1,
+  PRIME8_OUT_COUNT = 2
+};
+
+enum prime8_status {
+  PRIME8_STATUS_OK = 0,
+  PRIME8_STATUS_BAD_MODE = 1,
+  PRIME8_STATUS_BAD_OUTPUT = 2,
+  PRIME8_STATUS_BAD_MAGIC = 3,
+  PRIME8_STATUS_BAD_SLICE = 4, /* shared-memory ring: slice outside the region */
+  PRIME8_STATUS_TOO_LARGE = 5, /* count above PRIME8_MAX_COUNT */
+  PRIME8_STATUS_FAILED = 6     /* the kernel call failed (prime8_filter_bitmap error) */
+};
+
+struct prime8_request {
+  uint32_t magic;
+  uint8_t mode;
+  uint8_t output;
+  uint16_t reserved;
+  uint64_t count;
+};
+
+struct prime8_response {
+  uint32_t magic;
+  uint32_t status;
+  uint64_t survivors;
+  uint64_t payload_bytes;
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(prime8_request) == 16, "wire layout");
+static_assert(sizeof(prime8_response) == 24, "wire layout");
+#endif
+
+#endif /* PRIME8_WIRE_H */
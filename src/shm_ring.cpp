@@ -0,0 +1,436 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "shm_ring.hpp"
+
+#include "prime8.h"
+#include "prime8_wire.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace neon_shm {
+
+namespace {
+
+// Requests at least this large go to the thread pool (as in prime8d).
+constexpr size_t kParallelMin = size_t(1) << 17;
+
+// Polls before sleeping; a round trip with a busy peer is usually shorter
+// than a futex wake. On a single CPU the peer cannot run while we spin.
+const int kSpin = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+
+// Sleeps are bounded so both ends notice a peer that died without closing.
+constexpr int kSleepMs = 100;
+
+size_t round_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+inline void cpu_relax() {
+#if defined(__aarch64__)
+  asm volatile("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// Shared (not FUTEX_PRIVATE) operations: the words live in a mapping shared
+// between processes. Without futexes the waiter just naps.
+void futex_wait(std::atomic<uint32_t>* word, uint32_t seen, int timeout_ms) {
+#if defined(__linux__)
+  timespec ts{timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, seen, &ts, nullptr, 0);
+#else
+  (void)word;
+  (void)seen;
+  (void)timeout_ms;
+  ::usleep(50);
+#endif
+}
+
+void futex_wake(std::atomic<uint32_t>* word) {
+#if defined(__linux__)
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr,
+            0);
+#else
+  (void)word;
+#endif
+}
+
+// Waits (bounded) for word to move past `seen` and returns its value. The
+// waiting flag and the word are both seq_cst, so either the publisher sees
+// the flag and wakes us or we see the new value before sleeping.
+uint32_t await_change(std::atomic<uint32_t>& word, uint32_t seen, std::atomic<uint32_t>& waiting) {
+  for (int i = 0; i < kSpin; ++i) {
+    const uint32_t v = word.load(std::memory_order_acquire);
+    if (v != seen) return v;
+    cpu_relax();
+  }
+  waiting.store(1);
+  if (word.load() == seen) futex_wait(&word, seen, kSleepMs);
+  waiting.store(0);
+  return word.load(std::memory_order_acquire);
+}
+
+void publish(std::atomic<uint32_t>& word, uint32_t value, std::atomic<uint32_t>& waiting) {
+  word.store(value);
+  if (waiting.load()) futex_wake(&word);
+}
+
+// True once the peer has closed its end of the socket.
+bool hung_up(int fd) {
+  pollfd p{fd, POLLIN, 0};
+  if (::poll(&p, 1, 0) <= 0) return false;
+  if (p.revents & (POLLHUP | POLLERR)) return true;
+  char c;
+  return ::recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) == 0;
+}
+
+// The server maps the ring once and trusts that mapping, so on Linux the
+// size is sealed before the descriptor leaves: a client that shrank it later
+// would make the server's accesses fault with SIGBUS. A macOS shm object
+// cannot be resized once its size is set, so it needs no seals.
+int create_shared(size_t bytes) {
+#if defined(__linux__)
+  const int fd = ::memfd_create("prime8-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+#else
+  static std::atomic<unsigned> seq{0};
+  char name[64];
+  std::snprintf(name, sizeof(name), "/prime8-ring-%d-%u", static_cast<int>(::getpid()),
+                seq.fetch_add(1));
+  const int fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd >= 0) ::shm_unlink(name);
+#endif
+  if (fd < 0) return -1;
+  if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+#if defined(__linux__)
+  if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+    ::close(fd);
+    return -1;
+  }
+#endif
+  return fd;
+}
+
+// True if the ring's size can no longer change (see create_shared).
+bool size_sealed(int fd) {
+#if defined(__linux__)
+  const int seals = ::fcntl(fd, F_GET_SEALS);
+  constexpr int kNeed = F_SEAL_SHRINK | F_SEAL_GROW;
+  return seals >= 0 && (seals & kNeed) == kNeed;
+#else
+  (void)fd;
+  return true;
+#endif
+}
+
+bool send_fd(int sock, int fd) {
+  char byte = 0;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  cmsghdr* c = CMSG_FIRSTHDR(&msg);
+  c->cmsg_level = SOL_SOCKET;
+  c->cmsg_type = SCM_RIGHTS;
+  c->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(c), &fd, sizeof(int));
+  ssize_t r;
+  do {
+    r = ::sendmsg(sock, &msg, 0);
+  } while (r < 0 && errno == EINTR);
+  return r == 1;
+}
+
+// MSG_CMSG_CLOEXEC and SOCK_CLOEXEC are Linux-only (not on macOS); without
+// them the descriptor gets FD_CLOEXEC right after the call that made it.
+#if !defined(MSG_CMSG_CLOEXEC) || !defined(SOCK_CLOEXEC)
+void set_cloexec(int fd) { ::fcntl(fd, F_SETFD, FD_CLOEXEC); }
+#endif
+
+// The received descriptor is close-on-exec before anything maps it.
+int recv_fd(int sock) {
+  char byte;
+  iovec iov{&byte, 1};
+  alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = ctrl;
+  msg.msg_controllen = sizeof(ctrl);
+  ssize_t r;
+  do {
+#if defined(MSG_CMSG_CLOEXEC)
+    r = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+#else
+    r = ::recvmsg(sock, &msg, 0);
+#endif
+  } while (r < 0 && errno == EINTR);
+  if (r != 1) return -1;
+  for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS) {
+      int fd;
+      std::memcpy(&fd, CMSG_DATA(c), sizeof(int));
+#if !defined(MSG_CMSG_CLOEXEC)
+      set_cloexec(fd);
+#endif
+      return fd;
+    }
+  }
+  return -1;
+}
+
+// The client may be buggy or hostile; nothing in the header is trusted
+// beyond what the mapping can hold.
+bool layout_ok(const RingHeader& h, size_t mapped) {
+  if (h.magic != kRingMagic || h.version != kRingVersion) return false;
+  if (h.slots == 0 || (h.slots & (h.slots - 1)) || h.slots > (1u << 20)) return false;
+  if (h.capacity == 0 || h.capacity % kSliceAlign || h.capacity > (uint64_t(1) << 40)) return false;
+  if (h.total_bytes > mapped) return false;
+  auto fits = [&](uint64_t off, uint64_t len, uint64_t align) {
+    return off % align == 0 && off >= sizeof(RingHeader) && off <= h.total_bytes &&
+           len <= h.total_bytes - off;
+  };
+  return fits(h.slots_offset, uint64_t(h.slots) * sizeof(Slot), alignof(Slot)) &&
+         fits(h.numbers_offset, h.capacity * sizeof(uint64_t), 8) &&
+         fits(h.bitmap_offset, h.capacity / 8, 8);
+}
+
+uint64_t popcount_bits(const uint8_t* bits, size_t count) {
+  uint64_t n = 0;
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t w;
+    std::memcpy(&w, bits + i / 8, 8);
+    n += __builtin_popcountll(w);
+  }
+  for (size_t b = i / 8; b < count / 8; ++b) n += __builtin_popcount(bits[b]);
+  // The output region is reused: bits past count in the last byte are stale.
+  if (count % 8) n += __builtin_popcount(bits[count / 8] & ((1u << (count % 8)) - 1));
+  return n;
+}
+
+} // namespace
+
+// === Client ===
+
+RingClient::~RingClient() { close(); }
+
+bool RingClient::fail(const char* what) {
+  error_ = std::string(what) + ": " + std::strerror(errno);
+  close();
+  return false;
+}
+
+bool RingClient::connect(const std::string& socket_path, size_t capacity, unsigned slots) {
+  close();
+  error_.clear();
+  capacity_ = round_up(capacity ? capacity : 1, kSliceAlign);
+  unsigned s = 2;
+  while (s < slots) s <<= 1;
+
+  const size_t slots_off = round_up(sizeof(RingHeader), 64);
+  const size_t numbers_off = round_up(slots_off + s * sizeof(Slot), 4096);
+  const size_t bitmap_off = numbers_off + capacity_ * sizeof(uint64_t);
+  bytes_ = round_up(bitmap_off + capacity_ / 8, 4096);
+
+  mem_fd_ = create_shared(bytes_);
+  if (mem_fd_ < 0) return fail("shared memory");
+  base_ = ::mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd_, 0);
+  if (base_ == MAP_FAILED) {
+    base_ = nullptr;
+    return fail("mmap");
+  }
+  hdr_ = new (base_) RingHeader();
+  hdr_->magic = kRingMagic;
+  hdr_->version = kRingVersion;
+  hdr_->slots = s;
+  hdr_->capacity = capacity_;
+  hdr_->slots_offset = slots_off;
+  hdr_->numbers_offset = numbers_off;
+  hdr_->bitmap_offset = bitmap_off;
+  hdr_->total_bytes = bytes_;
+  uint8_t* base = static_cast<uint8_t*>(base_);
+  slots_ = reinterpret_cast<Slot*>(base + slots_off);
+  numbers_ = reinterpret_cast<uint64_t*>(base + numbers_off);
+  bitmap_ = base + bitmap_off;
+  ends_.assign(s, 0);
+  head_ = reserved_at_ = free_to_ = 0;
+  next_ticket_ = waited_ = 0;
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return fail("socket path");
+  }
+  std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+#if defined(SOCK_CLOEXEC)
+  sock_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (sock_ < 0) return fail("socket");
+#else
+  sock_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock_ < 0) return fail("socket");
+  set_cloexec(sock_);
+#endif
+  if (::connect(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    return fail("connect");
+  }
+  if (!send_fd(sock_, mem_fd_)) return fail("send ring");
+  char ack = 1;
+  if (::recv(sock_, &ack, 1, MSG_WAITALL) != 1 || ack != 0) {
+    errno = EPROTO;
+    return fail("server rejected ring");
+  }
+  return true;
+}
+
+void RingClient::close() {
+  if (hdr_) {
+    hdr_->closed.store(1);
+    futex_wake(&hdr_->submitted);
+  }
+  if (sock_ >= 0) ::close(sock_);
+  if (base_) ::munmap(base_, bytes_);
+  if (mem_fd_ >= 0) ::close(mem_fd_);
+  sock_ = mem_fd_ = -1;
+  base_ = nullptr;
+  hdr_ = nullptr;
+  slots_ = nullptr;
+  numbers_ = nullptr;
+  bitmap_ = nullptr;
+}
+
+uint64_t* RingClient::reserve(size_t count) {
+  if (!hdr_) return nullptr;
+  const size_t need = round_up(count, kSliceAlign);
+  if (need > capacity_ || next_ticket_ - waited_ >= hdr_->slots) return nullptr;
+  // Never straddle the wrap point: skip to the start of the region instead.
+  uint64_t pos = head_;
+  if (pos % capacity_ + need > capacity_) pos += capacity_ - pos % capacity_;
+  if (free_to_ == head_) free_to_ = pos;  // nothing in flight: the skip is free
+  if (pos + need - free_to_ > capacity_) return nullptr;
+  reserved_at_ = pos;
+  return numbers_ + pos % capacity_;
+}
+
+uint32_t RingClient::submit(unsigned mode, size_t count) {
+  const uint32_t t = next_ticket_++;
+  Slot& s = slots_[t & (hdr_->slots - 1)];
+  s.offset = reserved_at_ % capacity_;
+  s.count = count;
+  s.mode = mode;
+  s.survivors = 0;
+  s.status = PRIME8_STATUS_OK;
+  head_ = reserved_at_ + round_up(count, kSliceAlign);
+  ends_[t & (hdr_->slots - 1)] = head_;
+  publish(hdr_->submitted, next_ticket_, hdr_->server_waiting);
+  return t;
+}
+
+RingClient::Result RingClient::wait(uint32_t ticket) {
+  if (!hdr_) return {nullptr, 0, PRIME8_STATUS_BAD_SLICE};
+  uint32_t done = hdr_->completed.load(std::memory_order_acquire);
+  while (static_cast<int32_t>(done - ticket) <= 0) {
+    const uint32_t seen = done;
+    done = await_change(hdr_->completed, seen, hdr_->client_waiting);
+    if (done == seen && hung_up(sock_)) {
+      errno = ECONNRESET;
+      fail("server");
+      return {nullptr, 0, PRIME8_STATUS_BAD_SLICE};
+    }
+  }
+  const Slot& s = slots_[ticket & (hdr_->slots - 1)];
+  waited_ = ticket + 1;
+  free_to_ = ends_[ticket & (hdr_->slots - 1)];
+  return {bitmap_ + s.offset / 8, s.survivors, s.status};
+}
+
+// === Server ===
+
+int64_t serve_ring(int conn_fd, const std::atomic<bool>& stop) {
+  const int mem_fd = recv_fd(conn_fd);
+  if (mem_fd < 0) return -1;
+  struct stat st;
+  void* base = MAP_FAILED;
+  if (size_sealed(mem_fd) && ::fstat(mem_fd, &st) == 0 &&
+      st.st_size >= static_cast<off_t>(sizeof(RingHeader))) {
+    base = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_SHARED,
+                  mem_fd, 0);
+  }
+  ::close(mem_fd);
+  const size_t mapped = base == MAP_FAILED ? 0 : static_cast<size_t>(st.st_size);
+  RingHeader* hdr = static_cast<RingHeader*>(base);
+  const char ack = mapped && layout_ok(*hdr, mapped) ? 0 : 1;
+  if (::send(conn_fd, &ack, 1, MSG_NOSIGNAL) != 1 || ack != 0) {
+    if (mapped) ::munmap(base, mapped);
+    return -1;
+  }
+
+  // Copy the layout once; later writes to the header by the client cannot
+  // move the regions under us.
+  uint8_t* const b = static_cast<uint8_t*>(base);
+  const uint32_t mask = hdr->slots - 1;
+  const uint64_t capacity = hdr->capacity;
+  Slot* const slots = reinterpret_cast<Slot*>(b + hdr->slots_offset);
+  const uint64_t* const numbers = reinterpret_cast<const uint64_t*>(b + hdr->numbers_offset);
+  uint8_t* const bitmap = b + hdr->bitmap_offset;
+
+  int64_t served = 0;
+  uint32_t done = hdr->completed.load();
+  while (!stop.load() && !hdr->closed.load()) {
+    const uint32_t avail = await_change(hdr->submitted, done, hdr->server_waiting);
+    if (avail == done) {
+      if (hung_up(conn_fd)) break;
+      continue;
+    }
+    // At most `slots` requests can be outstanding; anything more is a
+    // corrupt or hostile counter (e.g. done - 1 would mean 2^32 requests).
+    if (avail - done > mask + 1) break;
+    for (; done != avail; ++done) {
+      Slot& s = slots[done & mask];
+      const uint64_t off = s.offset, count = s.count;
+      const int mode = static_cast<int>(s.mode);
+      if (off % kSliceAlign || off > capacity || count > capacity - off) {
+        s.survivors = 0;
+        s.status = PRIME8_STATUS_BAD_SLICE;
+      } else if (!prime8_kernel_name(mode)) {
+        s.survivors = 0;
+        s.status = PRIME8_STATUS_BAD_MODE;
+      } else {
+        uint8_t* out = bitmap + off / 8;
+        const int rc = prime8_filter_bitmap(mode, numbers + off, count, out,
+                                            count >= kParallelMin ? PRIME8_PARALLEL : 0);
+        s.survivors = rc == PRIME8_OK ? popcount_bits(out, count) : 0;
+        s.status = rc == PRIME8_OK ? PRIME8_STATUS_OK : PRIME8_STATUS_FAILED;
+      }
+      ++served;
+      publish(hdr->completed, done + 1, hdr->client_waiting);
+    }
+  }
+  ::munmap(base, mapped);
+  return served;
+}
+
+} // namespace neon_shm
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shared-memory transport for same-host filter clients.
+//
+// Each client owns one shared mapping (memfd on Linux, an unlinked shm_open
+// object elsewhere) and hands its descriptor to the server over a Unix socket
+// with SCM_RIGHTS. The mapping holds a single-producer/single-consumer ring of
+// request descriptors, a candidate region the client writes numbers into, and
+// a companion bitmap region the server writes results into: number i of the
+// candidate region owns bit i of the bitmap region. Requests and results never
+// pass through a socket or a copy; the two sides only exchange sequence
+// numbers, sleeping on futexes (polling elsewhere) when there is nothing to do.
+namespace neon_shm {
+
+constexpr uint32_t kRingMagic = 0x53384550u;  // "PE8S"
+constexpr uint32_t kRingVersion = 1;
+
+// Offsets into the candidate region are multiples of this many numbers so each
+// request's bitmap starts on a whole (and 8-byte aligned) byte.
+constexpr size_t kSliceAlign = 64;
+
+struct Slot {
+  uint64_t offset;     // first number in the candidate region
+  uint64_t count;      // numbers in the request
+  uint64_t survivors;  // written by the server
+  uint32_t mode;       // prime8_kernel id
+  uint32_t status;     // prime8_status, written by the server
+};
+
+struct alignas(64) RingHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slots;           // power of two
+  uint32_t reserved;
+  uint64_t capacity;        // numbers in the candidate region
+  uint64_t numbers_offset;  // byte offsets from the start of the mapping
+  uint64_t bitmap_offset;
+  uint64_t slots_offset;
+  uint64_t total_bytes;
+
+  // Futex words: each side publishes one counter and sleeps on the other's.
+  alignas(64) std::atomic<uint32_t> submitted;  // client
+  std::atomic<uint32_t> server_waiting;
+  alignas(64) std::atomic<uint32_t> completed;  // server
+  std::atomic<uint32_t> client_waiting;
+  alignas(64) std::atomic<uint32_t> closed;     // client hung up
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex words must be lock-free");
+
+// Client end. Usage:
+//   uint64_t* p = ring.reserve(n);  fill p[0..n)
+//   uint32_t t = ring.submit(mode, n);
+//   Result r = ring.wait(t);        r.bitmap holds n bits
+// Several requests may be in flight. A result stays readable until the next
+// reserve() after the wait() that returned it; waiting on a ticket also
+// retires every earlier one. A failed wait() returns a null bitmap.
+class RingClient {
+public:
+  struct Result {
+    const uint8_t* bitmap;
+    uint64_t survivors;
+    uint32_t status;
+  };
+
+  RingClient() = default;
+  ~RingClient();
+
+  RingClient(const RingClient&) = delete;
+  RingClient& operator=(const RingClient&) = delete;
+
+  // Creates a ring for up to `capacity` numbers in flight and registers it
+  // with the server at `socket_path`. False (see error()) on failure.
+  bool connect(const std::string& socket_path, size_t capacity, unsigned slots = 64);
+  void close();
+
+  // Space for `count` numbers, or nullptr if it cannot fit even after every
+  // waited result is reclaimed (too much in flight, or count > capacity).
+  uint64_t* reserve(size_t count);
+  uint32_t submit(unsigned mode, size_t count);
+  Result wait(uint32_t ticket);
+
+  size_t capacity() const { return capacity_; }
+  const std::string& error() const { return error_; }
+
+private:
+  bool fail(const char* what);
+
+  int sock_ = -1;
+  int mem_fd_ = -1;
+  void* base_ = nullptr;
+  size_t bytes_ = 0;
+  RingHeader* hdr_ = nullptr;
+  uint64_t* numbers_ = nullptr;
+  uint8_t* bitmap_ = nullptr;
+  Slot* slots_ = nullptr;
+  size_t capacity_ = 0;
+
+  // Monotonic positions in the candidate region (physical = pos % capacity).
+  uint64_t head_ = 0;          // end of the last reservation
+  uint64_t reserved_at_ = 0;   // start of the pending reservation
+  uint64_t free_to_ = 0;       // everything before this is reclaimable
+  uint32_t next_ticket_ = 0;
+  uint32_t waited_ = 0;        // tickets [0, waited_) have been returned
+  std::vector<uint64_t> ends_; // per slot: monotonic end of that request
+  std::string error_;
+};
+
+// Server end for one connected client: maps the ring received on `conn_fd`
+// and answers requests until the client closes it or `stop` becomes true.
+// Rings whose size is not sealed (Linux) are refused, and a client that
+// publishes more than `slots` requests at once is dropped.
+// Returns requests served, or -1 if the handshake failed.
+int64_t serve_ring(int conn_fd, const std::atomic<bool>& stop);
+
+} // namespace neon_shm
@@ -0,0 +1,304 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include "primes_tables.hpp"
+#include <arm_neon.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace neon_adaptive {
+
+// === Depth-templated kernels ===
+// Depth = number of primes tested, in order 2,3,5,...,53. The first three
+// are the wheel-30 residue check; the rest are Barrett divisibility tests.
+// Survivor semantics match neon_wheel at Depth 16.
+
+constexpr uint32_t MU30 = 143165576u; // floor(2^32 / 30)
+
+__attribute__((always_inline)) inline
+uint32_t prime_at(int i) { return i < 8 ? SMALL_PRIMES[i] : EXT_PRIMES[i - 8]; }
+
+__attribute__((always_inline)) inline
+uint32_t mu_at(int i) { return i < 8 ? SMALL_MU[i] : EXT_MU[i - 8]; }
+
+__attribute__((always_inline)) inline
+uint32x4_t barrett_modq_u32(uint32x4_t n, uint32x4_t mu, uint32x4_t p) {
+  uint64x2_t lo = vmull_u32(vget_low_u32(n), vget_low_u32(mu));
+  uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu));
+  uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
+  uint32x4_t r = vsubq_u32(n, vmulq_u32(q, p));
+  return vsubq_u32(r, vandq_u32(vcgeq_u32(r, p), p));
+}
+
+// Lanes coprime to 30, or equal to 2, 3 or 5.
+__attribute__((always_inline)) inline
+uint32x4_t wheel30_pass(uint32x4_t n) {
+  uint32x4_t r = barrett_modq_u32(n, vdupq_n_u32(MU30), vdupq_n_u32(30));
+  // Coprime residues mod 30 as a bit set: {1,7,11,13,17,19,23,29}.
+  const uint32x4_t set = vdupq_n_u32((1u << 1) | (1u << 7) | (1u << 11) | (1u << 13) |
+                                     (1u << 17) | (1u << 19) | (1u << 23) | (1u << 29));
+  uint32x4_t bit = vshlq_u32(vdupq_n_u32(1), vreinterpretq_s32_u32(r));
+  uint32x4_t pass = vtstq_u32(bit, set);
+  pass = vorrq_u32(pass, vceqq_u32(n, vdupq_n_u32(2)));
+  pass = vorrq_u32(pass, vceqq_u32(n, vdupq_n_u32(3)));
+  return vorrq_u32(pass, vceqq_u32(n, vdupq_n_u32(5)));
+}
+
+__attribute__((always_inline)) inline
+uint8_t movemask8_from_u32(uint32x4_t a, uint32x4_t b) {
+  const uint8x8_t bytes = vmovn_u16(vcombine_u16(vmovn_u32(a), vmovn_u32(b)));
+  static const uint8_t kBits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  return vaddv_u8(vand_u8(bytes, vld1_u8(kBits)));
+}
+
+template <int Depth>
+__attribute__((always_inline, flatten)) inline
+uint16_t filter16_depth(const uint64_t* __restrict ptr) {
+  uint32x4_t n[4], pass[4];
+  for (int v = 0; v < 4; ++v) {
+    uint64x2_t a = vld1q_u64(ptr + 4 * v);
+    uint64x2_t b = vld1q_u64(ptr + 4 * v + 2);
+    uint64x2_t high = vorrq_u64(vshrq_n_u64(a, 32), vshrq_n_u64(b, 32));
+    n[v] = vcombine_u32(vmovn_u64(a), vmovn_u64(b));
+    pass[v] = wheel30_pass(n[v]);
+    if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) {
+      // > 32-bit lanes never survive.
+      uint32x4_t hi32 = vcombine_u32(vshrn_n_u64(a, 32), vshrn_n_u64(b, 32));
+      pass[v] = vandq_u32(pass[v], vceqq_u32(hi32, vdupq_n_u32(0)));
+    }
+  }
+
+  if (Depth > 3) {
+    if ((vmaxvq_u32(pass[0]) | vmaxvq_u32(pass[1]) |
+         vmaxvq_u32(pass[2]) | vmaxvq_u32(pass[3])) == 0) {
+      return 0;
+    }
+    const uint32x4_t zero = vdupq_n_u32(0);
+    for (int i = 3; i < Depth; ++i) {
+      const uint32x4_t p = vdupq_n_u32(prime_at(i));
+      const uint32x4_t mu = vdupq_n_u32(mu_at(i));
+      for (int v = 0; v < 4; ++v) {
+        uint32x4_t r = barrett_modq_u32(n[v], mu, p);
+        uint32x4_t divisible = vandq_u32(vceqq_u32(r, zero), vmvnq_u32(vceqq_u32(n[v], p)));
+        pass[v] = vbicq_u32(pass[v], divisible);
+      }
+    }
+  }
+
+  return (uint16_t)movemask8_from_u32(pass[0], pass[1]) |
+         ((uint16_t)movemask8_from_u32(pass[2], pass[3]) << 8);
+}
+
+template <int Depth>
+static bool survives_scalar(uint64_t n) {
+  if (n > 0xffffffffu) return false;
+  const uint32_t n32 = (uint32_t)n;
+  for (int i = 0; i < Depth; ++i) {
+    const uint32_t p = prime_at(i);
+    if (n32 != p && n32 % p == 0) return false;
+  }
+  return true;
+}
+
+template <int Depth>
+static void filter_stream_depth(const uint64_t* __restrict numbers,
+                                uint8_t*       __restrict bitmap,
+                                size_t count) {
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __builtin_prefetch(numbers + i + 64, 0, 1);
+    const uint16_t bits = filter16_depth<Depth>(numbers + i);
+    std::memcpy(bitmap + (i >> 3), &bits, 2);
+  }
+  if (i < count) {
+    uint16_t bits = 0;
+    for (size_t k = 0; i + k < count; ++k) {
+      if (survives_scalar<Depth>(numbers[i + k])) bits |= (uint16_t)(1u << k);
+    }
+    const size_t bytes = (count - i + 7) / 8;
+    std::memcpy(bitmap + (i >> 3), &bits, bytes);
+  }
+}
+
+void filter_stream_u64_depth_bitmap(Depth depth,
+                                    const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count) {
+  switch (depth) {
+    case Depth::Wheel:  filter_stream_depth<3>(numbers, bitmap, count); break;
+    case Depth::Wheel8: filter_stream_depth<8>(numbers, bitmap, count); break;
+    case Depth::Full16: filter_stream_depth<16>(numbers, bitmap, count); break;
+  }
+}
+
+// === Adaptive engine ===
+
+namespace {
+
+constexpr size_t kTileWords = kAdaptiveTile / 64;
+constexpr Depth kDepths[3] = {Depth::Wheel, Depth::Wheel8, Depth::Full16};
+constexpr double kEwma = 0.25;
+
+int depth_index(Depth d) { return d == Depth::Wheel ? 0 : d == Depth::Wheel8 ? 1 : 2; }
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t popcount_words(const uint64_t* words) {
+  size_t c = 0;
+  for (size_t w = 0; w < kTileWords; ++w) c += __builtin_popcountll(words[w]);
+  return c;
+}
+
+// The bitmap tail beyond len is not written by the stream kernels.
+void filter_tile(Depth d, const uint64_t* tile, size_t len, uint64_t* words) {
+  if (len < kAdaptiveTile) std::memset(words, 0, kTileWords * 8);
+  filter_stream_u64_depth_bitmap(d, tile, reinterpret_cast<uint8_t*>(words), len);
+  if (len % 64) words[len / 64] &= (1ull << (len % 64)) - 1;
+}
+
+void ewma(double& avg, double sample, bool first) {
+  avg = first ? sample : avg + kEwma * (sample - avg);
+}
+
+} // namespace
+
+double AdaptiveStats::ns_per_prime() const {
+  return primes ? total_ns / primes : 0.0;
+}
+
+AdaptiveEngine::AdaptiveEngine(const AdaptiveOptions& opts)
+    : opts_(opts), depth_(opts.initial), since_probe_(opts.resample_tiles) {
+  stats_.depth = depth_;
+}
+
+void AdaptiveEngine::reset_stats() {
+  const AdaptiveStats keep = stats_;
+  stats_ = AdaptiveStats{};
+  // Cost estimates are state, not counters.
+  std::copy(keep.survival, keep.survival + 3, stats_.survival);
+  std::copy(keep.filter_ns, keep.filter_ns + 3, stats_.filter_ns);
+  stats_.mr_ns = keep.mr_ns;
+  stats_.depth = depth_;
+}
+
+// Filters one tile at every depth, timing each and counting its survivors:
+// per-stage elimination and per-number filter cost measured on live data.
+void AdaptiveEngine::probe(const uint64_t* tile, size_t len, uint64_t* words) {
+  alignas(64) uint64_t scratch[3][kTileWords];
+  for (int k = 0; k < 3; ++k) {
+    const uint64_t t0 = now_ns();
+    filter_tile(kDepths[k], tile, len, scratch[k]);
+    const uint64_t t1 = now_ns();
+    ewma(stats_.filter_ns[k], double(t1 - t0) / len, stats_.probes == 0);
+    stats_.survival[k] = double(popcount_words(scratch[k])) / len;
+  }
+  ++stats_.probes;
+
+  // Expected ns per input number: filter + survivors x Miller-Rabin. The
+  // number of primes is the same at every depth, so minimising this also
+  // minimises ns per confirmed prime.
+  const double mr = stats_.mr_ns > 0 ? stats_.mr_ns : 0.0;
+  double cost[3];
+  int best = 0;
+  for (int k = 0; k < 3; ++k) {
+    cost[k] = stats_.filter_ns[k] + stats_.survival[k] * mr;
+    if (cost[k] < cost[best]) best = k;
+  }
+  const int cur = depth_index(depth_);
+  if (best != cur && cost[best] < cost[cur] * (1.0 - opts_.switch_margin)) {
+    depth_ = kDepths[best];
+    stats_.depth = depth_;
+    ++stats_.switches;
+  }
+  std::memcpy(words, scratch[depth_index(depth_)], sizeof(scratch[0]));
+}
+
+template <class Emit>
+void AdaptiveEngine::run(const uint64_t* __restrict numbers, size_t count, Emit&& emit) {
+  alignas(64) uint64_t words[kTileWords];
+  alignas(64) uint16_t idx[kAdaptiveTile];
+
+  for (size_t base = 0; base < count; base += kAdaptiveTile) {
+    const size_t len = std::min(kAdaptiveTile, count - base);
+    const uint64_t* tile = numbers + base;
+    const uint64_t t0 = now_ns();
+
+    // Stage 1: filter at the current depth (or all depths on a probe tile).
+    if (opts_.resample_tiles && since_probe_ >= opts_.resample_tiles) {
+      probe(tile, len, words);
+      since_probe_ = 0;
+    } else {
+      filter_tile(depth_, tile, len, words);
+      ++since_probe_;
+    }
+    const uint64_t t1 = now_ns();
+    const int k = depth_index(depth_);
+    ++stats_.tiles[k];
+    if (since_probe_ != 0) {
+      ewma(stats_.filter_ns[k], double(t1 - t0) / len, false);
+      ewma(stats_.survival[k], double(popcount_words(words)) / len, false);
+    }
+
+    uint64_t high = 0;
+    for (size_t i = 0; i < len; ++i) high |= tile[i];
+    if (high >> 32) {
+      for (size_t i = 0; i < len; ++i) {
+        if (tile[i] >> 32) words[i / 64] |= 1ull << (i % 64);
+      }
+    }
+
+    // Stage 2: compact survivors.
+    size_t nsurv = 0;
+    for (size_t w = 0; w < kTileWords; ++w) {
+      uint64_t bits = words[w];
+      while (bits) {
+        idx[nsurv++] = (uint16_t)(w * 64 + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+
+    // Stage 3: confirm.
+    const uint64_t t2 = now_ns();
+    size_t nprimes = 0;
+    for (size_t s = 0; s < nsurv; ++s) {
+      const uint64_t n = tile[idx[s]];
+      const bool prime = (n >> 32) ? neon_mr::is_prime_64(n) : neon_mr::miller_rabin_32((uint32_t)n);
+      idx[nprimes] = idx[s];
+      nprimes += prime;
+    }
+    const uint64_t t3 = now_ns();
+    if (nsurv) ewma(stats_.mr_ns, double(t3 - t2) / nsurv, stats_.mr_ns == 0);
+
+    stats_.numbers += len;
+    stats_.survivors += nsurv;
+    stats_.primes += nprimes;
+    stats_.total_ns += double(t3 - t0);
+    emit(base, len, idx, nprimes);
+  }
+}
+
+size_t AdaptiveEngine::prime_flags(const uint64_t* __restrict numbers,
+                                   uint8_t*       __restrict flags,
+                                   size_t count) {
+  size_t total = 0;
+  run(numbers, count, [&](size_t base, size_t len, const uint16_t* idx, size_t np) {
+    std::memset(flags + base, 0, len);
+    for (size_t k = 0; k < np; ++k) flags[base + idx[k]] = 1;
+    total += np;
+  });
+  return total;
+}
+
+size_t AdaptiveEngine::prime_count(const uint64_t* __restrict numbers, size_t count) {
+  size_t total = 0;
+  run(numbers, count, [&](size_t, size_t, const uint16_t*, size_t np) { total += np; });
+  return total;
+}
+
+} // namespace neon_adaptive
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include <arm_neon.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace neon_block_sieve {
+
+// === Block layout ===
+// A block is kSieveBlock numbers: the input is read once, narrowed to a u32
+// scratch array (8 KiB) and its wheel-30 bitmap (256 B) is built in the same
+// visit. All further passes read only the scratch and bitmap, which stay in
+// L1 for the whole block, and the finished bitmap is copied out once.
+static_assert(kSieveBlock % 64 == 0, "block must be whole bitmap words");
+
+constexpr size_t kBlockWords = kSieveBlock / 64;
+constexpr uint32_t MU30 = 143165576u; // floor(2^32 / 30)
+
+struct PrimeConst {
+  uint32x4_t p;
+  uint32x4_t mu;
+};
+
+__attribute__((always_inline)) inline
+uint32x4_t barrett_modq_u32(uint32x4_t n, uint32x4_t mu, uint32x4_t p) {
+  uint64x2_t lo = vmull_u32(vget_low_u32(n), vget_low_u32(mu));
+  uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu));
+  uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
+  uint32x4_t r = vsubq_u32(n, vmulq_u32(q, p));
+  return vsubq_u32(r, vandq_u32(vcgeq_u32(r, p), p));
+}
+
+// Lanes divisible by p but not equal to it.
+__attribute__((always_inline)) inline
+uint32x4_t divisible_mask(uint32x4_t n, const PrimeConst& c) {
+  uint32x4_t r = barrett_modq_u32(n, c.mu, c.p);
+  return vbicq_u32(vceqq_u32(r, vdupq_n_u32(0)), vceqq_u32(n, c.p));
+}
+
+// 16 lane masks -> 16 bits, lane i in bit i.
+__attribute__((always_inline)) inline
+uint16_t movemask16(uint32x4_t m0, uint32x4_t m1, uint32x4_t m2, uint32x4_t m3) {
+  static const uint8_t kBits[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x8_t bits = vld1_u8(kBits);
+  const uint8x8_t lo = vmovn_u16(vcombine_u16(vmovn_u32(m0), vmovn_u32(m1)));
+  const uint8x8_t hi = vmovn_u16(vcombine_u16(vmovn_u32(m2), vmovn_u32(m3)));
+  return (uint16_t)vaddv_u8(vand_u8(lo, bits)) |
+         ((uint16_t)vaddv_u8(vand_u8(hi, bits)) << 8);
+}
+
+__attribute__((always_inline)) inline
+uint16_t load_bits16(const uint64_t* words, size_t i) {
+  return (uint16_t)(words[i / 64] >> (i % 64));
+}
+
+__attribute__((always_inline)) inline
+void clear_bits16(uint64_t* words, size_t i, uint16_t clear) {
+  words[i / 64] &= ~((uint64_t)clear << (i % 64));
+}
+
+// === First visit: narrow + wheel-30 ===
+// Lanes past len are padded with 0, which fails the wheel, so every later
+// pass runs whole 16-lane groups with no scalar tail.
+static void first_visit(const uint64_t* __restrict numbers, size_t len,
+                        uint32_t* __restrict scratch, uint64_t* __restrict words) {
+  const uint32x4_t thirty = vdupq_n_u32(30);
+  const uint32x4_t mu30 = vdupq_n_u32(MU30);
+  const uint32x4_t coprime = vdupq_n_u32((1u << 1) | (1u << 7) | (1u << 11) | (1u << 13) |
+                                         (1u << 17) | (1u << 19) | (1u << 23) | (1u << 29));
+  const size_t full = len & ~size_t(15);
+  std::memset(words, 0, kBlockWords * sizeof(uint64_t));
+
+  for (size_t i = 0; i < full + (len > full ? 16 : 0); i += 16) {
+    uint64_t tmp[16];
+    const uint64_t* src = numbers + i;
+    if (i + 16 > len) {
+      std::memset(tmp, 0, sizeof(tmp));
+      std::memcpy(tmp, numbers + i, (len - i) * sizeof(uint64_t));
+      src = tmp;
+    }
+
+    uint32x4_t pass[4];
+    for (int v = 0; v < 4; ++v) {
+      uint64x2_t a = vld1q_u64(src + 4 * v);
+      uint64x2_t b = vld1q_u64(src + 4 * v + 2);
+      uint32x4_t n = vcombine_u32(vmovn_u64(a), vmovn_u64(b));
+      uint32x4_t hi = vcombine_u32(vshrn_n_u64(a, 32), vshrn_n_u64(b, 32));
+      vst1q_u32(scratch + i + 4 * v, n);
+
+      uint32x4_t r = barrett_modq_u32(n, mu30, thirty);
+      uint32x4_t ok = vtstq_u32(vshlq_u32(vdupq_n_u32(1), vreinterpretq_s32_u32(r)), coprime);
+      ok = vorrq_u32(ok, vceqq_u32(n, vdupq_n_u32(2)));
+      ok = vorrq_u32(ok, vceqq_u32(n, vdupq_n_u32(3)));
+      ok = vorrq_u32(ok, vceqq_u32(n, vdupq_n_u32(5)));
+      pass[v] = vandq_u32(ok, vceqq_u32(hi, vdupq_n_u32(0)));  // > 32-bit never survives
+    }
+    words[i / 64] |= (uint64_t)movemask16(pass[0], pass[1], pass[2], pass[3]) << (i % 64);
+  }
+}
+
+// === Prime-major passes ===
+// One pass over the block per prime: its two broadcast constants stay in
+// registers however many primes there are. Groups already fully cleared
+// (common on composite-heavy input) are skipped without touching scratch.
+static void passes_prime_major(const uint32_t* __restrict scratch, uint64_t* __restrict words,
+                               size_t groups, const PrimeConst* consts, size_t nprimes) {
+  for (size_t k = 0; k < nprimes; ++k) {
+    const PrimeConst c = consts[k];
+    for (size_t g = 0; g < groups; ++g) {
+      const size_t i = g * 16;
+      if (load_bits16(words, i) == 0) continue;
+      const uint32x4_t d0 = divisible_mask(vld1q_u32(scratch + i + 0), c);
+      const uint32x4_t d1 = divisible_mask(vld1q_u32(scratch + i + 4), c);
+      const uint32x4_t d2 = divisible_mask(vld1q_u32(scratch + i + 8), c);
+      const uint32x4_t d3 = divisible_mask(vld1q_u32(scratch + i + 12), c);
+      clear_bits16(words, i, movemask16(d0, d1, d2, d3));
+    }
+  }
+}
+
+// === Lane-major passes ===
+// Every prime for one 16-lane group before moving on, as the neon_wheel
+// kernels do. Cheapest while the prime constants fit in registers.
+static void passes_lane_major(const uint32_t* __restrict scratch, uint64_t* __restrict words,
+                              size_t groups, const PrimeConst* consts, size_t nprimes) {
+  for (size_t g = 0; g < groups; ++g) {
+    const size_t i = g * 16;
+    if (load_bits16(words, i) == 0) continue;
+    const uint32x4_t n0 = vld1q_u32(scratch + i + 0);
+    const uint32x4_t n1 = vld1q_u32(scratch + i + 4);
+    const uint32x4_t n2 = vld1q_u32(scratch + i + 8);
+    const uint32x4_t n3 = vld1q_u32(scratch + i + 12);
+    uint32x4_t m0 = vdupq_n_u32(0), m1 = m0, m2 = m0, m3 = m0;
+    for (size_t k = 0; k < nprimes; ++k) {
+      m0 = vorrq_u32(m0, divisible_mask(n0, consts[k]));
+      m1 = vorrq_u32(m1, divisible_mask(n1, consts[k]));
+      m2 = vorrq_u32(m2, divisible_mask(n2, consts[k]));
+      m3 = vorrq_u32(m3, divisible_mask(n3, consts[k]));
+    }
+    clear_bits16(words, i, movemask16(m0, m1, m2, m3));
+  }
+}
+
+// === Driver ===
+
+Layout choose_layout(size_t nprimes) {
+  return nprimes > kLaneMajorMaxPrimes ? Layout::PrimeMajor : Layout::LaneMajor;
+}
+
+void filter_stream_u64_sieve_bitmap(const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count,
+                                    const uint32_t* primes, size_t nprimes,
+                                    Layout layout) {
+  // Precompute floor(2^32 / p); p = 2, 3, 5 are covered by the wheel and
+  // p < 2 is meaningless, so both are dropped.
+  PrimeConst stack_consts[64];
+  PrimeConst* consts = stack_consts;
+  PrimeConst* heap = nullptr;
+  if (nprimes > 64) consts = heap = new PrimeConst[nprimes];
+  size_t nconsts = 0;
+  for (size_t k = 0; k < nprimes; ++k) {
+    const uint32_t p = primes[k];
+    if (p < 7) continue;
+    consts[nconsts].p = vdupq_n_u32(p);
+    consts[nconsts].mu = vdupq_n_u32((uint32_t)(0x100000000ull / p));
+    ++nconsts;
+  }
+  if (layout == Layout::Auto) layout = choose_layout(nconsts);
+
+  alignas(64) uint32_t scratch[kSieveBlock];
+  alignas(64) uint64_t words[kBlockWords];
+
+  for (size_t base = 0; base < count; base += kSieveBlock) {
+    const size_t len = std::min(kSieveBlock, count - base);
+    const size_t groups = (len + 15) / 16;
+    __builtin_prefetch(numbers + base + kSieveBlock, 0, 1);
+
+    first_visit(numbers + base, len, scratch, words);
+    if (layout == Layout::PrimeMajor) {
+      passes_prime_major(scratch, words, groups, consts, nconsts);
+    } else {
+      passes_lane_major(scratch, words, groups, consts, nconsts);
+    }
+    std::memcpy(bitmap + (base >> 3), words, (len + 7) / 8);
+  }
+  delete[] heap;
+}
+
+void filter_stream_u64_sieve_bitmap(const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count) {
+  static constexpr uint32_t kDefault[13] = {7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+  filter_stream_u64_sieve_bitmap(numbers, bitmap, count, kDefault, 13, Layout::PrimeMajor);
+}
+
+} // namespace neon_block_sieve
@@ -35,8 +35,43 @@ void filter_stream_u64_wheel(const uint64_t* __restrict numbers,
                              uint8_t*       __restrict out,
                              size_t count);
 
+// Knobs of filter_stream_u64_wheel_bitmap's main loop; the defaults are
+// that kernel. prime8-autotune picks them per host (autotune.hpp).
+struct WheelTuning {
+  unsigned steps = 2;      // 16-lane steps per iteration: 1, 2 or 4
+  unsigned prefetch = 64;  // read prefetch distance in numbers; 0 = none
+  bool early_out = false;  // skip 23..53 when 7..19 already removed every lane
+};
+
+// filter_stream_u64_wheel_bitmap under `t`; the output is the same for any t.
+void filter_stream_u64_wheel_bitmap_tuned(const WheelTuning& t,
+                                          const uint64_t* __restrict numbers,
+                                          uint8_t*       __restrict bitmap,
+                                          size_t count);
+
 } // namespace neon_wheel
 
+namespace neon_small {
+
+// Entry points for online batches of 8 to a few thousand numbers, where the
+// stream kernels' fixed costs dominate: the 32-wide unrolled loop, prefetches
+// past the end of the batch and a scalar tail. One 16-lane step per
+// iteration, no prefetch; the last partial step runs the same vector code on
+// a zero-padded copy. Same survivors and output layout as neon_wheel (and
+// neon_fast), for any count.
+constexpr size_t kSmallBatchMax = 4096;   // below this the C API routes here
+
+void filter_small_u64_wheel_bitmap(const uint64_t* __restrict numbers,
+                                   uint8_t*       __restrict bitmap,
+                                   size_t count);
+
+// One byte (1/0) per number.
+void filter_small_u64_wheel(const uint64_t* __restrict numbers,
+                            uint8_t*       __restrict out,
+                            size_t count);
+
+} // namespace neon_small
+
 namespace neon_ultra {
 
 // Ultra-optimized streaming API
@@ -46,6 +81,24 @@ void filter_stream_u64_barrett16_ultra(const uint64_t* __restrict numbers,
 
 } // namespace neon_ultra
 
+namespace neon_final {
+
+// 32-wide software-pipelined Barrett stage with wheel-30 early-out
+void filter_stream_u64_barrett16_final(const uint64_t* __restrict numbers,
+                                       uint8_t*       __restrict out,
+                                       size_t count);
+
+} // namespace neon_final
+
+namespace neon_optimized {
+
+// Wheel-30 bitmap with interleaved Barrett reductions
+void filter_stream_u64_wheel_optimized(const uint64_t* __restrict numbers,
+                                       uint8_t*       __restrict bitmap,
+                                       size_t count);
+
+} // namespace neon_optimized
+
 namespace neon_wheel210 {
 
 // Wheel-210 (2×3×5×7) - 77.1% elimination
@@ -63,3 +116,261 @@ void filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numb
                                                  size_t count);
 
 } // namespace neon_wheel210_efficient
+
+namespace neon_mr {
+
+// Deterministic Miller-Rabin: bases {2, 7, 61} below 2^32, seven-base set
+// for the full 64-bit range.
+bool miller_rabin_32(uint32_t n);
+bool miller_rabin_64(uint64_t n);
+
+// Exact test for any 64-bit value: trial division by the 16 filter primes
+// above 2^32, then miller_rabin_64.
+bool is_prime_64(uint64_t n);
+
+} // namespace neon_mr
+
+namespace neon_fused {
+
+// Fused filter-then-confirm: the input is processed in kFusedTile-number
+// tiles; each tile runs the wheel-30 bitmap filter, compacts its survivors
+// into an on-stack index list and confirms them with Miller-Rabin while the
+// tile is still in L1. Results are exact for every 64-bit value.
+constexpr size_t kFusedTile = 2048;   // 16 KiB of input per tile
+
+// flags[i] = 1 iff numbers[i] is prime. Returns the number of primes.
+size_t fused_prime_flags(const uint64_t* __restrict numbers,
+                         uint8_t*       __restrict flags,
+                         size_t count);
+
+// Bit i of bitmap[i >> 3] set iff numbers[i] is prime. Returns the number of primes.
+size_t fused_prime_bitmap(const uint64_t* __restrict numbers,
+                          uint8_t*       __restrict bitmap,
+                          size_t count);
+
+// Appends the primes in input order to `primes` (room for count values in
+// the worst case). Returns how many were written.
+size_t fused_prime_list(const uint64_t* __restrict numbers,
+                        uint64_t*       __restrict primes,
+                        size_t count);
+
+size_t fused_prime_count(const uint64_t* __restrict numbers, size_t count);
+
+} // namespace neon_fused
+
+namespace neon_adaptive {
+
+// Filter depth: how many of the primes 2,3,5,...,53 are tested. Wheel is the
+// mod-30 residue check alone, Wheel8 adds 7..19, Full16 adds 23..53 (the same
+// survivors as neon_wheel).
+enum class Depth : int { Wheel = 3, Wheel8 = 8, Full16 = 16 };
+
+void filter_stream_u64_depth_bitmap(Depth depth,
+                                    const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count);
+
+constexpr size_t kAdaptiveTile = 2048;
+
+struct AdaptiveOptions {
+  size_t resample_tiles = 32;    // tiles between probes of all three depths; 0 = fixed depth
+  double switch_margin = 0.05;   // predicted gain required before switching
+  Depth initial = Depth::Full16;
+};
+
+// Counters since construction / reset_stats(); indices [0..2] follow
+// Wheel, Wheel8, Full16.
+struct AdaptiveStats {
+  size_t numbers = 0;
+  size_t survivors = 0;          // Miller-Rabin calls
+  size_t primes = 0;
+  size_t probes = 0;
+  size_t switches = 0;
+  size_t tiles[3] = {};          // tiles filtered at each depth
+  double survival[3] = {};       // survivor fraction per depth (latest estimate)
+  double filter_ns[3] = {};      // filter cost per number per depth (EWMA)
+  double mr_ns = 0.0;            // cost per Miller-Rabin call (EWMA)
+  double total_ns = 0.0;
+  Depth depth = Depth::Full16;   // depth in use
+
+  double ns_per_prime() const;
+};
+
+// Exact prime detection with a self-tuning filter depth. Works in
+// kAdaptiveTile-number tiles like neon_fused. Every resample_tiles tiles a
+// probe tile is filtered at all three depths, measuring each stage's real
+// elimination rate and cost on the data currently streaming past; the engine
+// then keeps whichever depth minimises filter + survivors x Miller-Rabin time
+// per number, which is also the minimum ns per confirmed prime. Because probes
+// recur through the stream, the depth follows drifting input.
+class AdaptiveEngine {
+public:
+  explicit AdaptiveEngine(const AdaptiveOptions& opts = AdaptiveOptions());
+
+  // flags[i] = 1 iff numbers[i] is prime. Returns the number of primes.
+  size_t prime_flags(const uint64_t* __restrict numbers,
+                     uint8_t*       __restrict flags,
+                     size_t count);
+  size_t prime_count(const uint64_t* __restrict numbers, size_t count);
+
+  Depth depth() const { return depth_; }
+  const AdaptiveStats& stats() const { return stats_; }
+  void reset_stats();  // clears counters, keeps the learned costs
+
+private:
+  template <class Emit>
+  void run(const uint64_t* __restrict numbers, size_t count, Emit&& emit);
+  void probe(const uint64_t* tile, size_t len, uint64_t* words);
+
+  AdaptiveOptions opts_;
+  AdaptiveStats stats_;
+  Depth depth_;
+  size_t since_probe_;
+};
+
+} // namespace neon_adaptive
+
+namespace neon_block_sieve {
+
+// Cache-blocked sieve over an arbitrary prime set. Each block of
+// kSieveBlock numbers is read once: narrowed to a u32 scratch array and
+// given its wheel-30 bitmap in the same visit. The remaining primes are then
+// applied to the L1-resident scratch, either prime-major (one pass per prime
+// over the block) or lane-major (all primes per 16-lane group, the layout of
+// the neon_wheel kernels). Survivor semantics match neon_wheel: a bit is set
+// iff n <= 2^32-1 and no prime in {2,3,5} or the set divides n (n equal to a
+// prime survives).
+constexpr size_t kSieveBlock = 2048;
+
+// Above this many primes their constants no longer fit in NEON registers
+// next to the lanes, and prime-major wins.
+constexpr size_t kLaneMajorMaxPrimes = 13;
+
+enum class Layout { Auto, LaneMajor, PrimeMajor };
+
+Layout choose_layout(size_t nprimes);
+
+// primes: any order; entries below 7 are ignored (the wheel covers 2, 3, 5).
+void filter_stream_u64_sieve_bitmap(const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count,
+                                    const uint32_t* primes, size_t nprimes,
+                                    Layout layout = Layout::Auto);
+
+// Prime-major sieve over 7..53; same output as neon_wheel.
+void filter_stream_u64_sieve_bitmap(const uint64_t* __restrict numbers,
+                                    uint8_t*       __restrict bitmap,
+                                    size_t count);
+
+} // namespace neon_block_sieve
+
+namespace neon_stream {
+
+using StreamKernel = void (*)(const uint64_t* __restrict, uint8_t* __restrict, size_t);
+
+// Where a stream kernel's output goes. Cached stores pull every output line
+// into cache (read-for-ownership) even though a filter pass never reads it
+// back; NonTemporal runs the kernel into an L1-resident staging tile and
+// streams each full 64-byte line past the cache (stnp on ARM, movntdq on
+// x86), which frees that read traffic and keeps the input's lines in LLC.
+// Auto picks NonTemporal once the input is far larger than any LLC.
+enum class OutputPolicy { Cached, NonTemporal, Auto };
+
+constexpr size_t kNonTemporalMinCount = size_t(32) << 20;  // 256 MiB of input
+constexpr size_t kStageBytes = 4096;                        // staging tile, output bytes
+
+OutputPolicy resolve(OutputPolicy policy, size_t count);
+
+// Runs fn (any serial stream kernel above) under `policy`. `bitmap` says
+// whether fn writes one bit or one byte per number. Output is byte-identical
+// to fn(numbers, out, count); the unaligned head and the tail use cached
+// stores.
+void filter_stream(StreamKernel fn, bool bitmap,
+                   const uint64_t* __restrict numbers,
+                   uint8_t*       __restrict out,
+                   size_t count,
+                   OutputPolicy policy = OutputPolicy::Auto);
+
+} // namespace neon_stream
+
+namespace neon_inplace {
+
+// In-place filtering: the caller's array is overwritten with its own
+// survivors, in input order, and the new length is returned. Input is
+// processed in kInplaceTile-number tiles whose bitmap lives on the stack, so
+// no bitmap or second survivor array is allocated. Survivors are moved four
+// lanes at a time with a table-driven vqtbl2q left-pack.
+constexpr size_t kInplaceTile = 4096;   // 32 KiB of input, 512-byte bitmap
+
+// Any bitmap stream kernel (neon_stream::StreamKernel writing one bit per number).
+size_t filter_inplace(neon_stream::StreamKernel fn, uint64_t* numbers, size_t count);
+
+size_t filter_inplace_barrett16(uint64_t* numbers, size_t count);
+size_t filter_inplace_wheel(uint64_t* numbers, size_t count);
+size_t filter_inplace_wheel210(uint64_t* numbers, size_t count);
+size_t filter_inplace_sieve(uint64_t* numbers, size_t count);
+
+// Copies src[i] for every set bit i of bitmap to dst, in order, and returns
+// how many. dst may equal src, start below it, or not overlap it at all;
+// stores are whole 4-lane groups but never reach past dst + count.
+size_t left_pack(const uint64_t* src, const uint8_t* bitmap, size_t count, uint64_t* dst);
+
+} // namespace neon_inplace
+
+namespace neon_parallel {
+
+// Multi-threaded variants of the stream kernels above. The input is split into
+// kParallelChunk-number chunks (a multiple of 64, so bitmap bytes never
+// straddle threads) which run on the shared work-stealing pool; output is
+// byte-identical to the serial kernel. Thread count: see thread_pool.hpp.
+constexpr size_t kParallelChunk = 32768;   // 256 KiB of input per chunk
+
+void parallel_filter_stream_u64_barrett16(const uint64_t* __restrict numbers,
+                                          uint8_t*       __restrict out,
+                                          size_t count);
+
+void parallel_filter_stream_u64_barrett16_bitmap(const uint64_t* __restrict numbers,
+                                                 uint8_t*       __restrict bitmap,
+                                                 size_t count);
+
+void parallel_filter_stream_u64_barrett16_ultra(const uint64_t* __restrict numbers,
+                                                uint8_t*       __restrict out,
+                                                size_t count);
+
+void parallel_filter_stream_u64_wheel(const uint64_t* __restrict numbers,
+                                      uint8_t*       __restrict out,
+                                      size_t count);
+
+void parallel_filter_stream_u64_wheel_bitmap(const uint64_t* __restrict numbers,
+                                             uint8_t*       __restrict bitmap,
+                                             size_t count);
+
+void parallel_filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numbers,
+                                                          uint8_t*       __restrict bitmap,
+                                                          size_t count);
+
+// neon_stream::filter_stream over the pool: the same kParallelChunk split
+// as the kernels above, each chunk written under `policy` (resolved once for
+// the whole input).
+void parallel_filter_stream(neon_stream::StreamKernel fn, bool bitmap,
+                            const uint64_t* __restrict numbers,
+                            uint8_t*       __restrict out,
+                            size_t count,
+                            neon_stream::OutputPolicy policy = neon_stream::OutputPolicy::Auto);
+
+// neon_inplace::filter_inplace over the pool: every kParallelChunk chunk is
+// compacted in place to its own front, then the chunks' survivor runs are
+// slid down in order to close the gaps (one serial memmove of the survivors).
+size_t parallel_filter_inplace(neon_stream::StreamKernel fn, uint64_t* numbers, size_t count);
+
+// Page-aligned buffers sized for `count` numbers whose pages are first
+// touched (zeroed) by the pool slot seeded with that chunk, so on NUMA hosts
+// with a pinned pool each chunk's input and output live on the node of the
+// worker seeded with it (the one that filters it unless it is stolen).
+// `bitmap` selects count/8 output bytes instead of count. Release with
+// free_first_touch().
+uint64_t* alloc_numbers_first_touch(size_t count);
+uint8_t*  alloc_output_first_touch(size_t count, bool bitmap);
+void      free_first_touch(void* p);
+
+} // namespace neon_parallel
@@ -2,6 +2,7 @@
 // Copyright (c) 2025 Justin Guida
 #include "simd_fast.hpp"
 #include "primes_tables.hpp"
+#include "stats.hpp"
 #include <arm_neon.h>
 #include <cstdint>
 #include <cstddef>
@@ -51,7 +52,7 @@ void barrett_modq_u32_dual(uint32x4_t n1, uint32x4_t n2,
 // === Strategy 3: Pack-level early-out divisibility check ===
 __attribute__((always_inline)) inline
 void divisible_mask_dual16_earlyout(uint32x4_t n1, uint32x4_t n2,
-                                    uint32x4_t& m1, uint32x4_t& m2) {
+                                    uint32x4_t& m1, uint32x4_t& m2 PRIME8_STATS_PARAM) {
   const uint32x4_t zero = vdupq_n_u32(0);
   const uint32x4_t all_ones = vdupq_n_u32(0xFFFFFFFF);
 
@@ -61,6 +62,7 @@ void divisible_mask_dual16_earlyout(uint32x4_t n1, uint32x4_t n2,
   // Track which lanes are still "alive" (not yet marked composite)
   uint32x4_t alive1 = all_ones;
   uint32x4_t alive2 = all_ones;
+  PRIME8_STAT(steps, 1);
 
   // Check small primes first (most likely to eliminate composites)
   // Process in pairs and check for early-out every 2 primes
@@ -84,7 +86,11 @@ void divisible_mask_dual16_earlyout(uint32x4_t n1, uint32x4_t n2,
   }
 
   // Check if all lanes are dead
-  if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) return;
+  if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) {
+    PRIME8_STAT(early_out[0], 1);
+    return;
+  }
+  PRIME8_STATS_ONLY(neon_stats::group_alive(stats, 0, alive1, alive2);)
 
   // Primes 5, 7
   for (int i = 2; i < 4; ++i) {
@@ -104,12 +110,20 @@ void divisible_mask_dual16_earlyout(uint32x4_t n1, uint32x4_t n2,
     alive2 = vandq_u32(alive2, vmvnq_u32(d2));
   }
 
-  if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) return;
+  if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) {
+    PRIME8_STAT(early_out[1], 1);
+    return;
+  }
+  PRIME8_STATS_ONLY(neon_stats::group_alive(stats, 1, alive1, alive2);)
 
   // Continue with remaining primes
   for (int i = 4; i < 16; ++i) {
     if (i == 8 || i == 12) {  // Check every 4 primes
-      if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) return;
+      if ((vmaxvq_u32(alive1) | vmaxvq_u32(alive2)) == 0) {
+        PRIME8_STAT(early_out[i / 4], 1);
+        return;
+      }
+      PRIME8_STATS_ONLY(neon_stats::group_alive(stats, i / 4, alive1, alive2);)
     }
 
     uint32x4_t r1, r2;
@@ -127,6 +141,7 @@ void divisible_mask_dual16_earlyout(uint32x4_t n1, uint32x4_t n2,
     alive1 = vandq_u32(alive1, vmvnq_u32(d1));
     alive2 = vandq_u32(alive2, vmvnq_u32(d2));
   }
+  PRIME8_STATS_ONLY(neon_stats::group_alive(stats, 4, alive1, alive2);)
 }
 
 // === Strategy 4: Wheel prefilter (mod 30 = 2×3×5) ===
@@ -137,7 +152,7 @@ bool wheel30_prefilter(uint32x4_t n1, uint32x4_t n2) {
   // then entire pack is composite
 
   const uint32x4_t thirty = vdupq_n_u32(30);
-  const uint32x4_t mu30 = vdupq_n_u32(2863311531u); // ceil(2^32/30)
+  const uint32x4_t mu30 = vdupq_n_u32(143165576u); // floor(2^32/30)
 
   // Compute n % 30 using Barrett
   uint64x2_t lo1 = vmull_u32(vget_low_u32(n1), vget_low_u32(mu30));
@@ -150,6 +165,8 @@ bool wheel30_prefilter(uint32x4_t n1, uint32x4_t n2) {
 
   uint32x4_t r1 = vsubq_u32(n1, vmulq_u32(q1, thirty));
   uint32x4_t r2 = vsubq_u32(n2, vmulq_u32(q2, thirty));
+  r1 = vsubq_u32(r1, vandq_u32(vcgeq_u32(r1, thirty), thirty));
+  r2 = vsubq_u32(r2, vandq_u32(vcgeq_u32(r2, thirty), thirty));
 
   // Check if any residue is coprime to 30
   // Coprime residues: 1,7,11,13,17,19,23,29
@@ -184,6 +201,11 @@ bool wheel30_prefilter(uint32x4_t n1, uint32x4_t n2) {
   coprime2 = vorrq_u32(coprime2, vceqq_u32(r2, twentythree));
   coprime2 = vorrq_u32(coprime2, vceqq_u32(r2, twentynine));
 
+  // 2, 3 and 5 are prime but not coprime to 30
+  const uint32x4_t five = vdupq_n_u32(5);
+  coprime1 = vorrq_u32(coprime1, vcgeq_u32(five, n1));
+  coprime2 = vorrq_u32(coprime2, vcgeq_u32(five, n2));
+
   // Return true if ANY lane might be prime (has coprime residue)
   return (vmaxvq_u32(coprime1) | vmaxvq_u32(coprime2)) != 0;
 }
@@ -191,7 +213,7 @@ bool wheel30_prefilter(uint32x4_t n1, uint32x4_t n2) {
 // === Main filter with all optimizations ===
 __attribute__((always_inline)) inline
 void filter8_u64_barrett16_final(const uint64_t* __restrict ptr,
-                                 uint8_t*       __restrict out) {
+                                 uint8_t*       __restrict out PRIME8_STATS_PARAM) {
   // Load 8×u64
   uint64x2_t a0 = vld1q_u64(ptr + 0);
   uint64x2_t a1 = vld1q_u64(ptr + 2);
@@ -205,6 +227,8 @@ void filter8_u64_barrett16_final(const uint64_t* __restrict ptr,
   uint64x2_t h3 = vshrq_n_u64(a3, 32);
   uint64x2_t any = vorrq_u64(vorrq_u64(h0, h1), vorrq_u64(h2, h3));
   const bool all32 = ((vgetq_lane_u64(any,0) | vgetq_lane_u64(any,1)) == 0ULL);
+  PRIME8_STAT(lanes, 8);
+  PRIME8_STATS_ONLY(if (!all32) PRIME8_STAT(wide, neon_stats::wide(ptr, 8));)
 
   // Narrow to 32-bit
   uint32x4_t n1 = vcombine_u32(vmovn_u64(a0), vmovn_u64(a1));
@@ -213,13 +237,15 @@ void filter8_u64_barrett16_final(const uint64_t* __restrict ptr,
   // Wheel prefilter - skip full Barrett if all composite by mod 30
   if (all32 && !wheel30_prefilter(n1, n2)) {
     // All lanes divisible by 2, 3, or 5
+    PRIME8_STAT(wheel_skips, 1);
+    PRIME8_STAT(wheel, 8);
     vst1_u8(out, vdup_n_u8(0));
     return;
   }
 
   // Full Barrett with early-out
   uint32x4_t m1, m2;
-  divisible_mask_dual16_earlyout(n1, n2, m1, m2);
+  divisible_mask_dual16_earlyout(n1, n2, m1, m2 PRIME8_STATS_ARG);
 
   // Invert masks (0 = composite, 0xFFFFFFFF = survives)
   const uint32x4_t zero = vdupq_n_u32(0);
@@ -230,6 +256,7 @@ void filter8_u64_barrett16_final(const uint64_t* __restrict ptr,
   if (!all32) {
     uint32x4_t en_lo = vceqq_u32(vcombine_u32(vmovn_u64(h0), vmovn_u64(h1)), zero);
     uint32x4_t en_hi = vceqq_u32(vcombine_u32(vmovn_u64(h2), vmovn_u64(h3)), zero);
+    PRIME8_STATS_ONLY(neon_stats::drop_wide(stats, sv1, sv2, en_lo, en_hi);)
     sv1 = vandq_u32(sv1, en_lo);
     sv2 = vandq_u32(sv2, en_hi);
   }
@@ -242,11 +269,16 @@ void filter8_u64_barrett16_final(const uint64_t* __restrict ptr,
 }
 
 // === Strategy 5: Software pipelined 32-element processing ===
+// Inlined in stats builds only, so the call's Tally stays in registers
+// rather than being loaded and stored at every hook.
+PRIME8_STATS_ONLY(__attribute__((always_inline)) inline)
 void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
-                                      uint8_t*       __restrict out) {
+                                      uint8_t*       __restrict out PRIME8_STATS_PARAM) {
   // Process 32 elements with software pipelining
   // Load next batch while processing current batch
 
+  PRIME8_STAT(lanes, 32);
+
   // Load first 8
   uint64x2_t a0 = vld1q_u64(ptr + 0);
   uint64x2_t a1 = vld1q_u64(ptr + 2);
@@ -265,7 +297,7 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
 
   // Process first 8
   uint32x4_t m1_a, m2_a;
-  divisible_mask_dual16_earlyout(n1_a, n2_a, m1_a, m2_a);
+  divisible_mask_dual16_earlyout(n1_a, n2_a, m1_a, m2_a PRIME8_STATS_ARG);
 
   // Start second 8
   uint32x4_t n1_b = vcombine_u32(vmovn_u64(b0), vmovn_u64(b1));
@@ -279,7 +311,7 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
 
   // Process second 8
   uint32x4_t m1_b, m2_b;
-  divisible_mask_dual16_earlyout(n1_b, n2_b, m1_b, m2_b);
+  divisible_mask_dual16_earlyout(n1_b, n2_b, m1_b, m2_b PRIME8_STATS_ARG);
 
   // Start third 8
   uint32x4_t n1_c = vcombine_u32(vmovn_u64(c0), vmovn_u64(c1));
@@ -293,13 +325,13 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
 
   // Process third 8
   uint32x4_t m1_c, m2_c;
-  divisible_mask_dual16_earlyout(n1_c, n2_c, m1_c, m2_c);
+  divisible_mask_dual16_earlyout(n1_c, n2_c, m1_c, m2_c PRIME8_STATS_ARG);
 
   // Process fourth 8
   uint32x4_t n1_d = vcombine_u32(vmovn_u64(d0), vmovn_u64(d1));
   uint32x4_t n2_d = vcombine_u32(vmovn_u64(d2), vmovn_u64(d3));
   uint32x4_t m1_d, m2_d;
-  divisible_mask_dual16_earlyout(n1_d, n2_d, m1_d, m2_d);
+  divisible_mask_dual16_earlyout(n1_d, n2_d, m1_d, m2_d PRIME8_STATS_ARG);
 
   // Convert all results to bytes and store
   const uint32x4_t zero = vdupq_n_u32(0);
@@ -314,8 +346,10 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
     uint64x2_t h3 = vshrq_n_u64(a3, 32);
     uint64x2_t any = vorrq_u64(vorrq_u64(h0, h1), vorrq_u64(h2, h3));
     if ((vgetq_lane_u64(any,0) | vgetq_lane_u64(any,1)) != 0) {
+      PRIME8_STAT(wide, neon_stats::wide(ptr + 0, 8));
       uint32x4_t en_lo = vceqq_u32(vcombine_u32(vmovn_u64(h0), vmovn_u64(h1)), zero);
       uint32x4_t en_hi = vceqq_u32(vcombine_u32(vmovn_u64(h2), vmovn_u64(h3)), zero);
+      PRIME8_STATS_ONLY(neon_stats::drop_wide(stats, sv1, sv2, en_lo, en_hi);)
       sv1 = vandq_u32(sv1, en_lo);
       sv2 = vandq_u32(sv2, en_hi);
     }
@@ -333,8 +367,10 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
     uint64x2_t h3 = vshrq_n_u64(b3, 32);
     uint64x2_t any = vorrq_u64(vorrq_u64(h0, h1), vorrq_u64(h2, h3));
     if ((vgetq_lane_u64(any,0) | vgetq_lane_u64(any,1)) != 0) {
+      PRIME8_STAT(wide, neon_stats::wide(ptr + 8, 8));
       uint32x4_t en_lo = vceqq_u32(vcombine_u32(vmovn_u64(h0), vmovn_u64(h1)), zero);
       uint32x4_t en_hi = vceqq_u32(vcombine_u32(vmovn_u64(h2), vmovn_u64(h3)), zero);
+      PRIME8_STATS_ONLY(neon_stats::drop_wide(stats, sv1, sv2, en_lo, en_hi);)
       sv1 = vandq_u32(sv1, en_lo);
       sv2 = vandq_u32(sv2, en_hi);
     }
@@ -352,8 +388,10 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
     uint64x2_t h3 = vshrq_n_u64(c3, 32);
     uint64x2_t any = vorrq_u64(vorrq_u64(h0, h1), vorrq_u64(h2, h3));
     if ((vgetq_lane_u64(any,0) | vgetq_lane_u64(any,1)) != 0) {
+      PRIME8_STAT(wide, neon_stats::wide(ptr + 16, 8));
       uint32x4_t en_lo = vceqq_u32(vcombine_u32(vmovn_u64(h0), vmovn_u64(h1)), zero);
       uint32x4_t en_hi = vceqq_u32(vcombine_u32(vmovn_u64(h2), vmovn_u64(h3)), zero);
+      PRIME8_STATS_ONLY(neon_stats::drop_wide(stats, sv1, sv2, en_lo, en_hi);)
       sv1 = vandq_u32(sv1, en_lo);
       sv2 = vandq_u32(sv2, en_hi);
     }
@@ -370,8 +408,10 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
     uint64x2_t h3 = vshrq_n_u64(d3, 32);
     uint64x2_t any = vorrq_u64(vorrq_u64(h0, h1), vorrq_u64(h2, h3));
     if ((vgetq_lane_u64(any,0) | vgetq_lane_u64(any,1)) != 0) {
+      PRIME8_STAT(wide, neon_stats::wide(ptr + 24, 8));
       uint32x4_t en_lo = vceqq_u32(vcombine_u32(vmovn_u64(h0), vmovn_u64(h1)), zero);
       uint32x4_t en_hi = vceqq_u32(vcombine_u32(vmovn_u64(h2), vmovn_u64(h3)), zero);
+      PRIME8_STATS_ONLY(neon_stats::drop_wide(stats, sv1, sv2, en_lo, en_hi);)
       sv1 = vandq_u32(sv1, en_lo);
       sv2 = vandq_u32(sv2, en_hi);
     }
@@ -384,22 +424,19 @@ void filter32_u64_barrett16_pipelined(const uint64_t* __restrict ptr,
 void filter_stream_u64_barrett16_final(const uint64_t* __restrict numbers,
                                        uint8_t*       __restrict out,
                                        size_t count) {
-  // Alignment hints
-  numbers = (const uint64_t*)__builtin_assume_aligned(numbers, 16);
-  out = (uint8_t*)__builtin_assume_aligned(out, 8);
-
+  PRIME8_STATS_SCOPE
   size_t i = 0;
 
   // Process 32 at a time with software pipelining
   for (; i + 32 <= count; i += 32) {
     __builtin_prefetch(numbers + i + 64, 0, 1);  // Prefetch 2 cache lines ahead
     __builtin_prefetch(numbers + i + 72, 0, 1);
-    filter32_u64_barrett16_pipelined(numbers + i, out + i);
+    filter32_u64_barrett16_pipelined(numbers + i, out + i PRIME8_STATS_ARG);
   }
 
   // Process remaining 8 at a time
   for (; i + 8 <= count; i += 8) {
-    filter8_u64_barrett16_final(numbers + i, out + i);
+    filter8_u64_barrett16_final(numbers + i, out + i PRIME8_STATS_ARG);
   }
 
   // Scalar tail
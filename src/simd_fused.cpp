@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace neon_fused {
+
+// === Tile engine ===
+// Each tile is filtered, compacted and confirmed before the next one is
+// loaded: the 16 KiB of input, its 256-byte bitmap and the 4 KiB index list
+// all stay in L1, so Miller-Rabin reads its candidates from cache instead of
+// streaming the array a second time.
+static_assert(kFusedTile % 64 == 0 && kFusedTile <= 65536, "tile must be whole u64 words");
+
+constexpr size_t kTileWords = kFusedTile / 64;
+
+// Runs the fused pipeline and hands emit(base, len, idx, nprimes) the
+// ascending tile-relative indices of the primes in each tile.
+template <class Emit>
+static void run_tiles(const uint64_t* __restrict numbers, size_t count, Emit&& emit) {
+  alignas(64) uint64_t words[kTileWords];
+  alignas(64) uint16_t idx[kFusedTile];
+
+  for (size_t base = 0; base < count; base += kFusedTile) {
+    const size_t len = std::min(kFusedTile, count - base);
+    const uint64_t* tile = numbers + base;
+
+    // Stage 1: wheel-30 + Barrett prefilter into the tile bitmap.
+    if (len < kFusedTile) std::memset(words, 0, sizeof(words));
+    neon_wheel::filter_stream_u64_wheel_bitmap(tile, reinterpret_cast<uint8_t*>(words), len);
+    if (len % 64) words[len / 64] &= (1ull << (len % 64)) - 1;
+
+    // Values above 32 bits get a 0 from the filter and are rare; only mark
+    // them (for is_prime_64) when the tile has any.
+    uint64_t high = 0;
+    for (size_t i = 0; i < len; ++i) high |= tile[i];
+    if (high >> 32) {
+      for (size_t i = 0; i < len; ++i) {
+        if (tile[i] >> 32) words[i / 64] |= 1ull << (i % 64);
+      }
+    }
+
+    // Stage 2: compact survivors to tile-relative indices.
+    size_t nsurv = 0;
+    for (size_t w = 0; w < kTileWords; ++w) {
+      uint64_t bits = words[w];
+      while (bits) {
+        idx[nsurv++] = (uint16_t)(w * 64 + __builtin_ctzll(bits));
+        bits &= bits - 1;
+      }
+    }
+
+    // Stage 3: confirm in place; the list stays in input order.
+    size_t nprimes = 0;
+    for (size_t k = 0; k < nsurv; ++k) {
+      const uint64_t n = tile[idx[k]];
+      const bool prime = (n >> 32) ? neon_mr::is_prime_64(n) : neon_mr::miller_rabin_32((uint32_t)n);
+      idx[nprimes] = idx[k];
+      nprimes += prime;
+    }
+
+    emit(base, len, idx, nprimes);
+  }
+}
+
+// === Output sinks ===
+
+size_t fused_prime_flags(const uint64_t* __restrict numbers,
+                         uint8_t*       __restrict flags,
+                         size_t count) {
+  size_t total = 0;
+  run_tiles(numbers, count, [&](size_t base, size_t len, const uint16_t* idx, size_t np) {
+    std::memset(flags + base, 0, len);
+    for (size_t k = 0; k < np; ++k) flags[base + idx[k]] = 1;
+    total += np;
+  });
+  return total;
+}
+
+size_t fused_prime_bitmap(const uint64_t* __restrict numbers,
+                          uint8_t*       __restrict bitmap,
+                          size_t count) {
+  size_t total = 0;
+  run_tiles(numbers, count, [&](size_t base, size_t len, const uint16_t* idx, size_t np) {
+    alignas(64) uint64_t words[kTileWords] = {};
+    for (size_t k = 0; k < np; ++k) words[idx[k] / 64] |= 1ull << (idx[k] % 64);
+    std::memcpy(bitmap + (base >> 3), words, (len + 7) / 8);
+    total += np;
+  });
+  return total;
+}
+
+size_t fused_prime_list(const uint64_t* __restrict numbers,
+                        uint64_t*       __restrict primes,
+                        size_t count) {
+  size_t total = 0;
+  run_tiles(numbers, count, [&](size_t base, size_t, const uint16_t* idx, size_t np) {
+    for (size_t k = 0; k < np; ++k) primes[total + k] = numbers[base + idx[k]];
+    total += np;
+  });
+  return total;
+}
+
+size_t fused_prime_count(const uint64_t* __restrict numbers, size_t count) {
+  size_t total = 0;
+  run_tiles(numbers, count, [&](size_t, size_t, const uint16_t*, size_t np) { total += np; });
+  return total;
+}
+
+} // namespace neon_fused
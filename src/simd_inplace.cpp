@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace neon_inplace {
+
+static_assert(kInplaceTile % 64 == 0, "tile must be whole bitmap words");
+
+// === Left-pack table ===
+// Entry m holds vqtbl2q byte indices that gather the lanes selected by the
+// 4-bit mask m out of two q registers {n0 n1}{n2 n3} into the front of two
+// output registers, in order. Unused output lanes read index 0xFF (zero).
+struct PackTable {
+  uint8_t idx[16][32];
+};
+
+constexpr PackTable make_pack_table() {
+  PackTable t{};
+  for (unsigned m = 0; m < 16; ++m) {
+    unsigned slot = 0;
+    for (unsigned lane = 0; lane < 4; ++lane) {
+      if (!(m >> lane & 1)) continue;
+      for (unsigned b = 0; b < 8; ++b) t.idx[m][slot * 8 + b] = uint8_t(lane * 8 + b);
+      ++slot;
+    }
+    for (unsigned b = slot * 8; b < 32; ++b) t.idx[m][b] = 0xFF;
+  }
+  return t;
+}
+
+alignas(64) constexpr PackTable kPack = make_pack_table();
+
+// Moves the survivors among src[0..4) to dst[0..popcount(mask)). All four
+// lanes are loaded before the (unconditional, 32-byte) store, and dst <= src,
+// so the store never clobbers a number that has not been read yet.
+__attribute__((always_inline)) inline
+size_t pack4(const uint64_t* src, unsigned mask, uint64_t* dst) {
+  uint8x16x2_t lanes;
+  lanes.val[0] = vreinterpretq_u8_u64(vld1q_u64(src));
+  lanes.val[1] = vreinterpretq_u8_u64(vld1q_u64(src + 2));
+  const uint8x16_t lo = vqtbl2q_u8(lanes, vld1q_u8(kPack.idx[mask]));
+  const uint8x16_t hi = vqtbl2q_u8(lanes, vld1q_u8(kPack.idx[mask] + 16));
+  vst1q_u64(dst, vreinterpretq_u64_u8(lo));
+  vst1q_u64(dst + 2, vreinterpretq_u64_u8(hi));
+  return __builtin_popcount(mask);
+}
+
+// === Compaction ===
+
+size_t left_pack(const uint64_t* src, const uint8_t* bitmap, size_t count, uint64_t* dst) {
+  size_t k = 0;
+  size_t i = 0;
+  // Whole bitmap words; composite runs (zero words) cost one branch.
+  for (; i + 64 <= count; i += 64) {
+    uint64_t word;
+    std::memcpy(&word, bitmap + i / 8, sizeof(word));
+    if (!word) continue;
+    for (unsigned g = 0; g < 64; g += 4) {
+      k += pack4(src + i + g, unsigned(word >> g) & 15u, dst + k);
+    }
+  }
+  for (; i + 4 <= count; i += 4) {
+    k += pack4(src + i, (bitmap[i >> 3] >> (i & 7)) & 15u, dst + k);
+  }
+  // Tail (<4): branchless scalar, dst[k] may be overwritten by the next one.
+  for (; i < count; ++i) {
+    dst[k] = src[i];
+    k += (bitmap[i >> 3] >> (i & 7)) & 1u;
+  }
+  return k;
+}
+
+// Each tile is filtered into an L1 bitmap before any of it is overwritten;
+// survivors of tile t land at or below tile t's own start, so the kernel
+// always reads untouched input.
+size_t filter_inplace(neon_stream::StreamKernel fn, uint64_t* numbers, size_t count) {
+  alignas(64) uint64_t words[kInplaceTile / 64];
+  size_t k = 0;
+  for (size_t base = 0; base < count; base += kInplaceTile) {
+    const size_t len = std::min(kInplaceTile, count - base);
+    fn(numbers + base, reinterpret_cast<uint8_t*>(words), len);
+    k += left_pack(numbers + base, reinterpret_cast<const uint8_t*>(words), len, numbers + k);
+  }
+  return k;
+}
+
+size_t filter_inplace_barrett16(uint64_t* numbers, size_t count) {
+  return filter_inplace(neon_fast::filter_stream_u64_barrett16_bitmap, numbers, count);
+}
+
+size_t filter_inplace_wheel(uint64_t* numbers, size_t count) {
+  return filter_inplace(neon_wheel::filter_stream_u64_wheel_bitmap, numbers, count);
+}
+
+size_t filter_inplace_wheel210(uint64_t* numbers, size_t count) {
+  return filter_inplace(neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+                        numbers, count);
+}
+
+size_t filter_inplace_sieve(uint64_t* numbers, size_t count) {
+  return filter_inplace(
+      static_cast<neon_stream::StreamKernel>(neon_block_sieve::filter_stream_u64_sieve_bitmap),
+      numbers, count);
+}
+
+} // namespace neon_inplace
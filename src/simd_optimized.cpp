@@ -31,7 +31,7 @@ uint8_t movemask8_from_u32(uint32x4_t sv1, uint32x4_t sv2) {
     uint16x4_t s2 = vmovn_u32(sv2);
     uint8x8_t b = vmovn_u16(vcombine_u16(s1, s2));
     const uint8x8_t w = {1,2,4,8,16,32,64,128};
-    uint8x8_t t = vand_u8(vshr_n_u8(b, 7), w);
+    uint8x8_t t = vand_u8(b, w);
     t = vpadd_u8(t, t); t = vpadd_u8(t, t); t = vpadd_u8(t, t);
     return vget_lane_u8(t, 0);
 }
@@ -108,9 +108,6 @@ void barrett_modq_u32_quad_interleaved(
 // === Optimized wheel-30 kernel ===
 __attribute__((always_inline, flatten)) inline
 uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
-    // Assume aligned for better loads
-    ptr = (const uint64_t*)__builtin_assume_aligned(ptr, 16);
-
     // Load with prefetch hint
     uint64x2_t a0 = vld1q_u64(ptr + 0);
     uint64x2_t a1 = vld1q_u64(ptr + 2);
@@ -135,9 +132,9 @@ uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
     uint32x4_t n3 = vcombine_u32(vmovn_u64(a4), vmovn_u64(a5));
     uint32x4_t n4 = vcombine_u32(vmovn_u64(a6), vmovn_u64(a7));
 
-    // Wheel-30 prefilter with Barrett MU30
+    // Wheel-30 prefilter with Barrett MU30 = floor(2^32/30)
     const uint32x4_t thirty = vdupq_n_u32(30);
-    const uint32x4_t mu30 = vdupq_n_u32(2863311531u);
+    const uint32x4_t mu30 = vdupq_n_u32(143165576u);
 
     // Apply wheel mask (optimized)
     auto apply_wheel = [&](uint32x4_t n) -> uint32x4_t {
@@ -145,6 +142,7 @@ uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
         uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu30));
         uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
         uint32x4_t r = vsubq_u32(n, vmulq_u32(q, thirty));
+        r = vsubq_u32(r, vandq_u32(vcgeq_u32(r, thirty), thirty));
 
         // Check coprime residues
         const uint32x4_t r1 = vdupq_n_u32(1);
@@ -166,6 +164,11 @@ uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
         mask = vorrq_u32(mask, vceqq_u32(r, r23));
         mask = vorrq_u32(mask, vceqq_u32(r, r29));
 
+        // 2, 3 and 5 themselves are prime
+        mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(2)));
+        mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(3)));
+        mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(5)));
+
         return mask;
     };
 
@@ -200,9 +203,10 @@ uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
     const uint32x4_t zero = vdupq_n_u32(0);
     uint32x4_t m1 = zero, m2 = zero, m3 = zero, m4 = zero;
 
-    // Skip 2,3,5 since wheel handled them - start from index 3*2=6
+    // Skip 2,3,5 since wheel handled them: the even slots below 6
     #pragma unroll 4
-    for (int i = 6; i < 16; ++i) {
+    for (int i = 1; i < 16; ++i) {
+        if (i < 6 && !(i & 1)) continue;
         uint32x4_t r1, r2, r3, r4;
         barrett_modq_u32_quad_interleaved(n1, n2, n3, n4,
                                           INTERLEAVED_PRIMES.mu[i],
@@ -241,9 +245,6 @@ uint16_t filter16_u64_wheel_optimized(const uint64_t* __restrict ptr) {
 void filter_stream_u64_wheel_optimized(const uint64_t* __restrict numbers,
                                        uint8_t*       __restrict bitmap,
                                        size_t count) {
-    // Assume bitmap is 4-byte aligned for better stores
-    bitmap = (uint8_t*)__builtin_assume_aligned(bitmap, 4);
-
     size_t i = 0;
 
     // Process 32 at a time with shorter prefetch distance
@@ -312,7 +313,6 @@ void filter_stream_u64_wheel_optimized(const uint64_t* __restrict numbers,
     if (i < count) {
         const size_t base = i;
         uint8_t last = 0;
-        unsigned mask = 0;
         for (unsigned bit = 0; i < count; ++bit, ++i) {
             uint64_t n = numbers[i];
             if (n > 0xffffffffu) continue;
@@ -344,10 +344,9 @@ void filter_stream_u64_wheel_optimized(const uint64_t* __restrict numbers,
             }
 
             if (survive) last |= 1 << bit;
-            mask |= (1u << bit);
         }
         const size_t byte_off = base >> 3;
-        bitmap[byte_off] = (bitmap[byte_off] & ~uint8_t(mask)) | (last & uint8_t(mask));
+        bitmap[byte_off] = last;  // padding bits past count stay zero
     }
 }
 
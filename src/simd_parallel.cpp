@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace neon_parallel {
+
+using StreamKernel = void (*)(const uint64_t* __restrict, uint8_t* __restrict, size_t);
+
+// === Chunked dispatch ===
+// Chunks are multiples of 64 numbers, so every chunk starts on a whole
+// bitmap byte (in fact a whole u64 word) and no output byte is shared by two
+// threads. Each chunk runs the unmodified serial kernel; only the final chunk
+// sees a tail, and it sees exactly the tail the serial call would have seen,
+// which keeps the output byte-identical.
+static_assert(kParallelChunk % 64 == 0, "chunks must be 64-number aligned");
+
+static void run_chunked(StreamKernel fn, const uint64_t* numbers, uint8_t* out,
+                        size_t count, unsigned out_shift) {
+  const size_t chunks = (count + kParallelChunk - 1) / kParallelChunk;
+  WorkStealingPool& pool = default_pool();
+  if (pool.size() == 1 || chunks < 2) {
+    fn(numbers, out, count);
+    return;
+  }
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t begin = c * kParallelChunk;
+    const size_t len = std::min(kParallelChunk, count - begin);
+    fn(numbers + begin, out + (begin >> out_shift), len);
+  });
+}
+
+void parallel_filter_stream_u64_barrett16(const uint64_t* __restrict numbers,
+                                          uint8_t*       __restrict out,
+                                          size_t count) {
+  run_chunked(neon_fast::filter_stream_u64_barrett16, numbers, out, count, 0);
+}
+
+void parallel_filter_stream_u64_barrett16_bitmap(const uint64_t* __restrict numbers,
+                                                 uint8_t*       __restrict bitmap,
+                                                 size_t count) {
+  run_chunked(neon_fast::filter_stream_u64_barrett16_bitmap, numbers, bitmap, count, 3);
+}
+
+void parallel_filter_stream_u64_barrett16_ultra(const uint64_t* __restrict numbers,
+                                                uint8_t*       __restrict out,
+                                                size_t count) {
+  run_chunked(neon_ultra::filter_stream_u64_barrett16_ultra, numbers, out, count, 0);
+}
+
+void parallel_filter_stream_u64_wheel(const uint64_t* __restrict numbers,
+                                      uint8_t*       __restrict out,
+                                      size_t count) {
+  run_chunked(neon_wheel::filter_stream_u64_wheel, numbers, out, count, 0);
+}
+
+void parallel_filter_stream_u64_wheel_bitmap(const uint64_t* __restrict numbers,
+                                             uint8_t*       __restrict bitmap,
+                                             size_t count) {
+  run_chunked(neon_wheel::filter_stream_u64_wheel_bitmap, numbers, bitmap, count, 3);
+}
+
+void parallel_filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numbers,
+                                                          uint8_t*       __restrict bitmap,
+                                                          size_t count) {
+  run_chunked(neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+              numbers, bitmap, count, 3);
+}
+
+void parallel_filter_stream(neon_stream::StreamKernel fn, bool bitmap,
+                            const uint64_t* __restrict numbers,
+                            uint8_t*       __restrict out,
+                            size_t count,
+                            neon_stream::OutputPolicy policy) {
+  const unsigned shift = bitmap ? 3 : 0;
+  if (neon_stream::resolve(policy, count) == neon_stream::OutputPolicy::Cached) {
+    run_chunked(fn, numbers, out, count, shift);
+    return;
+  }
+  const size_t chunks = (count + kParallelChunk - 1) / kParallelChunk;
+  WorkStealingPool& pool = default_pool();
+  if (pool.size() == 1 || chunks < 2) {
+    neon_stream::filter_stream(fn, bitmap, numbers, out, count,
+                               neon_stream::OutputPolicy::NonTemporal);
+    return;
+  }
+  // Chunk outputs are 4 KiB (bitmap) or 32 KiB (bytes): whole staging tiles,
+  // so with an aligned `out` only the final chunk has a cached tail.
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t begin = c * kParallelChunk;
+    const size_t len = std::min(kParallelChunk, count - begin);
+    neon_stream::filter_stream(fn, bitmap, numbers + begin, out + (begin >> shift), len,
+                               neon_stream::OutputPolicy::NonTemporal);
+  });
+}
+
+size_t parallel_filter_inplace(neon_stream::StreamKernel fn, uint64_t* numbers, size_t count) {
+  const size_t chunks = (count + kParallelChunk - 1) / kParallelChunk;
+  WorkStealingPool& pool = default_pool();
+  if (pool.size() == 1 || chunks < 2) return neon_inplace::filter_inplace(fn, numbers, count);
+  std::vector<size_t> kept(chunks);
+  pool.parallel_for(chunks, [&](size_t c) {
+    const size_t begin = c * kParallelChunk;
+    kept[c] = neon_inplace::filter_inplace(fn, numbers + begin,
+                                           std::min(kParallelChunk, count - begin));
+  });
+  // Run c's destination lies at or below its own source and past every run
+  // already moved, so sliding front to back never clobbers a waiting run.
+  size_t k = kept[0];
+  for (size_t c = 1; c < chunks; ++c) {
+    std::memmove(numbers + k, numbers + c * kParallelChunk, kept[c] * sizeof(uint64_t));
+    k += kept[c];
+  }
+  return k;
+}
+
+// === First-touch allocation ===
+// Linux places a page on the node of the thread that first writes it. Chunk
+// c's bytes are zeroed, with stealing off, by seed_owner(chunks, c): the slot
+// run_chunked seeds with chunk c. Filtering still steals, so a stolen chunk
+// is read across nodes; placement matches the seed slices, not each run.
+// The 256 KiB input chunks and 32 KiB byte-output chunks are whole pages, so
+// only the 4 KiB bitmap chunks can share a page with a neighbour.
+static constexpr size_t kPage = 4096;
+
+static void* alloc_touched(size_t count, size_t bytes, unsigned shift, bool wide) {
+  const size_t size = std::max(kPage, (bytes + kPage - 1) & ~(kPage - 1));
+  uint8_t* p = static_cast<uint8_t*>(std::aligned_alloc(kPage, size));
+  if (!p) return nullptr;
+  const size_t chunks = (count + kParallelChunk - 1) / kParallelChunk;
+  default_pool().parallel_for(chunks, [&](size_t c) {
+    const size_t begin = c * kParallelChunk;
+    const size_t len = std::min(kParallelChunk, count - begin);
+    const size_t lo = wide ? begin * 8 : (begin >> shift);
+    const size_t hi = wide ? (begin + len) * 8 : std::min(bytes, (begin + len + (1u << shift) - 1) >> shift);
+    std::memset(p + lo, 0, hi - lo);
+  }, /*steal=*/false);
+  // Rounding slack past the last chunk.
+  const size_t used = wide ? count * 8 : bytes;
+  std::memset(p + used, 0, size - used);
+  return p;
+}
+
+uint64_t* alloc_numbers_first_touch(size_t count) {
+  return static_cast<uint64_t*>(alloc_touched(count, count * sizeof(uint64_t), 0, true));
+}
+
+uint8_t* alloc_output_first_touch(size_t count, bool bitmap) {
+  const unsigned shift = bitmap ? 3 : 0;
+  return static_cast<uint8_t*>(alloc_touched(count, (count + (1u << shift) - 1) >> shift, shift, false));
+}
+
+void free_first_touch(void* p) {
+  std::free(p);
+}
+
+} // namespace neon_parallel
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include "wheel_core.hpp"
+#include <arm_neon.h>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+namespace neon_small {
+
+namespace {
+
+// Lanes with a nonzero high word never survive.
+__attribute__((always_inline)) inline
+uint32x4_t narrow_enabled(uint64x2_t a, uint64x2_t b, uint32x4_t& n) {
+  n = vcombine_u32(vmovn_u64(a), vmovn_u64(b));
+  const uint32x4_t high = vcombine_u32(vmovn_u64(vshrq_n_u64(a, 32)),
+                                       vmovn_u64(vshrq_n_u64(b, 32)));
+  return vceqq_u32(high, vdupq_n_u32(0));
+}
+
+// === One 16-lane step: wheel-30 + Barrett, branch-free lane enable ===
+// `lanes` is only for the stats hooks: the first `lanes` values are real.
+__attribute__((always_inline)) inline
+uint16_t step16(const uint64_t* __restrict p, [[maybe_unused]] uint32_t lanes
+                PRIME8_STATS_PARAM) {
+  uint32x4_t n1, n2, n3, n4;
+  const uint32x4_t en1 = narrow_enabled(vld1q_u64(p + 0), vld1q_u64(p + 2), n1);
+  const uint32x4_t en2 = narrow_enabled(vld1q_u64(p + 4), vld1q_u64(p + 6), n2);
+  const uint32x4_t en3 = narrow_enabled(vld1q_u64(p + 8), vld1q_u64(p + 10), n3);
+  const uint32x4_t en4 = narrow_enabled(vld1q_u64(p + 12), vld1q_u64(p + 14), n4);
+  const uint32x4_t w1 = vandq_u32(neon_wheel::wheel30_lanes(n1), en1);
+  const uint32x4_t w2 = vandq_u32(neon_wheel::wheel30_lanes(n2), en2);
+  const uint32x4_t w3 = vandq_u32(neon_wheel::wheel30_lanes(n3), en3);
+  const uint32x4_t w4 = vandq_u32(neon_wheel::wheel30_lanes(n4), en4);
+  PRIME8_STATS_ONLY(
+      neon_stats::wheel_step(stats, lanes, en1, en2, en3, en4, w1, w2, w3, w4);)
+  return neon_wheel::sieve16_u32(n1, n2, n3, n4, w1, w2, w3, w4 PRIME8_STATS_ARG);
+}
+
+// The last rem (< 16) numbers, run through the same vector step from a
+// zero-padded copy; bits past rem are cleared.
+__attribute__((always_inline)) inline
+uint16_t step16_partial(const uint64_t* __restrict p, size_t rem PRIME8_STATS_PARAM) {
+  alignas(16) uint64_t pad[16] = {};
+  std::memcpy(pad, p, rem * sizeof(uint64_t));
+  return step16(pad, static_cast<uint32_t>(rem) PRIME8_STATS_ARG) & static_cast<uint16_t>((1u << rem) - 1);
+}
+
+// 16 survivor bits to 16 bytes of 1/0.
+__attribute__((always_inline)) inline
+uint8x16_t expand16(uint16_t bits) {
+  const uint8x16_t sel = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x16_t v = vcombine_u8(vdup_n_u8(static_cast<uint8_t>(bits)),
+                                   vdup_n_u8(static_cast<uint8_t>(bits >> 8)));
+  return vshrq_n_u8(vceqq_u8(vandq_u8(v, sel), sel), 7);
+}
+
+} // namespace
+
+void filter_small_u64_wheel_bitmap(const uint64_t* __restrict numbers,
+                                   uint8_t*       __restrict bitmap,
+                                   size_t count) {
+  PRIME8_STATS_SCOPE
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    const uint16_t bits = step16(numbers + i, 16 PRIME8_STATS_ARG);
+    std::memcpy(bitmap + (i >> 3), &bits, 2);
+  }
+  if (i < count) {
+    const size_t rem = count - i;
+    const uint16_t bits = step16_partial(numbers + i, rem PRIME8_STATS_ARG);
+    std::memcpy(bitmap + (i >> 3), &bits, (rem + 7) / 8);  // little-endian byte order
+  }
+}
+
+void filter_small_u64_wheel(const uint64_t* __restrict numbers,
+                            uint8_t*       __restrict out,
+                            size_t count) {
+  PRIME8_STATS_SCOPE
+  size_t i = 0;
+  for (; i + 16 <= count; i += 16) {
+    vst1q_u8(out + i, expand16(step16(numbers + i, 16 PRIME8_STATS_ARG)));
+  }
+  if (i < count) {
+    alignas(16) uint8_t bytes[16];
+    vst1q_u8(bytes, expand16(step16_partial(numbers + i, count - i PRIME8_STATS_ARG)));
+    std::memcpy(out + i, bytes, count - i);
+  }
+}
+
+} // namespace neon_small
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "simd_fast.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace neon_stream {
+
+static_assert(kStageBytes % 64 == 0, "staging tile must be whole cache lines");
+
+// === Line streaming ===
+// Copies whole 64-byte lines from the L1 staging tile to dst (64-aligned)
+// with non-temporal stores: the line is loaded into four q registers and
+// written without fetching the destination line first.
+__attribute__((always_inline)) inline
+void stream_lines(uint8_t* __restrict dst, const uint8_t* __restrict src, size_t bytes) {
+#if defined(__aarch64__)
+  for (size_t o = 0; o < bytes; o += 64) {
+    const uint8x16_t a = vld1q_u8(src + o);
+    const uint8x16_t b = vld1q_u8(src + o + 16);
+    const uint8x16_t c = vld1q_u8(src + o + 32);
+    const uint8x16_t d = vld1q_u8(src + o + 48);
+    asm volatile("stnp %q0, %q1, [%2]\n\t"
+                 "stnp %q3, %q4, [%2, #32]"
+                 :
+                 : "w"(a), "w"(b), "r"(dst + o), "w"(c), "w"(d)
+                 : "memory");
+  }
+#elif defined(__SSE2__)
+  for (size_t o = 0; o < bytes; o += 64) {
+    const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(src + o));
+    const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(src + o + 16));
+    const __m128i c = _mm_load_si128(reinterpret_cast<const __m128i*>(src + o + 32));
+    const __m128i d = _mm_load_si128(reinterpret_cast<const __m128i*>(src + o + 48));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + o), a);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + o + 16), b);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + o + 32), c);
+    _mm_stream_si128(reinterpret_cast<__m128i*>(dst + o + 48), d);
+  }
+#else
+  std::memcpy(dst, src, bytes);
+#endif
+}
+
+// x86 streaming stores are weakly ordered; fence them before the caller (or
+// the pool's completion signal) publishes the output. ARM's stnp only hints
+// at the cache and is ordered by the usual barriers.
+__attribute__((always_inline)) inline
+void stream_fence() {
+#if defined(__SSE2__) && !defined(__aarch64__)
+  _mm_sfence();
+#endif
+}
+
+OutputPolicy resolve(OutputPolicy policy, size_t count) {
+  if (policy != OutputPolicy::Auto) return policy;
+  return count >= kNonTemporalMinCount ? OutputPolicy::NonTemporal : OutputPolicy::Cached;
+}
+
+// Head and tail go straight to out. Every tile and the head end on a
+// multiple of 8 numbers, so no bitmap byte is split between two calls and
+// the last call sees the same tail the single call would have.
+void filter_stream(StreamKernel fn, bool bitmap,
+                   const uint64_t* __restrict numbers,
+                   uint8_t*       __restrict out,
+                   size_t count,
+                   OutputPolicy policy) {
+  if (resolve(policy, count) == OutputPolicy::Cached) {
+    fn(numbers, out, count);
+    return;
+  }
+  const unsigned shift = bitmap ? 3 : 0;
+  const size_t misalign = reinterpret_cast<uintptr_t>(out) & 63;
+  const size_t head = std::min(count, misalign ? (64 - misalign) << shift : 0);
+  if (head) fn(numbers, out, head);
+
+  alignas(64) uint8_t stage[kStageBytes];
+  const size_t tile = kStageBytes << shift;
+  size_t i = head;
+  for (; i + tile <= count; i += tile) {
+    fn(numbers + i, stage, tile);
+    stream_lines(out + (i >> shift), stage, kStageBytes);
+  }
+  // Whole lines of a partial tile still stream; only the last <64 bytes don't.
+  const size_t lines = ((count - i) >> shift) / 64 * 64;
+  if (lines) {
+    fn(numbers + i, stage, lines << shift);
+    stream_lines(out + (i >> shift), stage, lines);
+    i += lines << shift;
+  }
+  if (i < count) fn(numbers + i, out + (i >> shift), count - i);
+  stream_fence();
+}
+
+} // namespace neon_stream
@@ -17,7 +17,7 @@ uint8_t movemask8_from_u32(uint32x4_t sv1, uint32x4_t sv2) {
   uint8x8_t  b  = vmovn_u16(vcombine_u16(s1, s2)); // 0xFF/0x00 per lane
   // turn bytes into bits and horizontally sum
   const uint8x8_t w = {1,2,4,8,16,32,64,128};
-  uint8x8_t t = vand_u8(vshr_n_u8(b, 7), w);
+  uint8x8_t t = vand_u8(b, w);
   t = vpadd_u8(t, t); t = vpadd_u8(t, t); t = vpadd_u8(t, t);
   return vget_lane_u8(t, 0);
 }
@@ -170,14 +170,10 @@ void filter16_u64_barrett16_ultra(const uint64_t* __restrict ptr,
   vst1q_u8(out, result);
 }
 
-// === Strategy 4: Aligned memory access with hints ===
+// === Strategy 4: 32-wide unroll with prefetch (vld1q/vst1q take any alignment) ===
 void filter_stream_u64_barrett16_ultra(const uint64_t* __restrict numbers,
                                        uint8_t*       __restrict out,
                                        size_t count) {
-  // Assume aligned for better loads
-  numbers = (const uint64_t*)__builtin_assume_aligned(numbers, 16);
-  out = (uint8_t*)__builtin_assume_aligned(out, 16);
-
   size_t i = 0;
 
   // Process 32 at a time for maximum throughput
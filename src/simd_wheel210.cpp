@@ -22,19 +22,21 @@ static const uint8_t WHEEL210_RESIDUES[48] = {
     191, 193, 197, 199, 209
 };
 
-// Precomputed lookup table: is residue coprime to 210?
-static uint8_t WHEEL210_COPRIME[210] = {0};
-
-// Initialize lookup table
-__attribute__((constructor))
-static void init_wheel210() {
-    for (int i = 0; i < 48; i++) {
-        WHEEL210_COPRIME[WHEEL210_RESIDUES[i]] = 1;
+// Lookup table: is residue coprime to 210? Built at compile time, so there
+// is no load-time constructor and no first-call warmup.
+struct Wheel210Coprime {
+    uint8_t v[210] = {};
+    constexpr Wheel210Coprime() {
+        for (int r = 0; r < 210; r++) {
+            v[r] = (r % 2 && r % 3 && r % 5 && r % 7) ? 1 : 0;
+        }
     }
-}
+    constexpr uint8_t operator[](uint32_t r) const { return v[r]; }
+};
+static constexpr Wheel210Coprime WHEEL210_COPRIME{};
 
 // Barrett constant for mod 210
-static const uint32_t MU210 = 20456360u; // ceil(2^32/210)
+static const uint32_t MU210 = 20452225u; // floor(2^32/210)
 
 // === SIMD bitpack helpers ===
 __attribute__((always_inline)) inline
@@ -43,7 +45,7 @@ uint8_t movemask8_from_u32(uint32x4_t sv1, uint32x4_t sv2) {
     uint16x4_t s2 = vmovn_u32(sv2);
     uint8x8_t b = vmovn_u16(vcombine_u16(s1, s2));
     const uint8x8_t w = {1,2,4,8,16,32,64,128};
-    uint8x8_t t = vand_u8(vshr_n_u8(b, 7), w);
+    uint8x8_t t = vand_u8(b, w);
     t = vpadd_u8(t, t); t = vpadd_u8(t, t); t = vpadd_u8(t, t);
     return vget_lane_u8(t, 0);
 }
@@ -97,6 +99,7 @@ uint32x4_t wheel210_mask(uint32x4_t n) {
     uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu));
     uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
     uint32x4_t r = vsubq_u32(n, vmulq_u32(q, two_ten));
+    r = vsubq_u32(r, vandq_u32(vcgeq_u32(r, two_ten), two_ten));
 
     // For small mod 210, we can check all 48 residues efficiently
     // by grouping them into ranges and using SIMD comparisons
@@ -127,14 +130,18 @@ uint32x4_t wheel210_mask(uint32x4_t n) {
         mask = vorrq_u32(mask, vceqq_u32(r, res));
     }
 
+    // 2, 3, 5 and 7 themselves are prime
+    mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(2)));
+    mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(3)));
+    mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(5)));
+    mask = vorrq_u32(mask, vceqq_u32(n, vdupq_n_u32(7)));
+
     return mask; // 0xFFFFFFFF if possibly prime, 0 if definitely composite
 }
 
 // === Process 16 numbers with Wheel-210 + Barrett ===
 __attribute__((always_inline, flatten)) inline
 uint16_t filter16_u64_wheel210_bitmap(const uint64_t* __restrict ptr) {
-    ptr = (const uint64_t*)__builtin_assume_aligned(ptr, 16);
-
     // Load 16 numbers
     uint64x2_t a0 = vld1q_u64(ptr + 0);
     uint64x2_t a1 = vld1q_u64(ptr + 2);
@@ -251,8 +258,6 @@ uint16_t filter16_u64_wheel210_bitmap(const uint64_t* __restrict ptr) {
 void filter_stream_u64_wheel210_bitmap(const uint64_t* __restrict numbers,
                                        uint8_t*       __restrict bitmap,
                                        size_t count) {
-    bitmap = (uint8_t*)__builtin_assume_aligned(bitmap, 4);
-
     size_t i = 0;
 
     // Process 32 at a time
@@ -288,7 +293,7 @@ void filter_stream_u64_wheel210_bitmap(const uint64_t* __restrict numbers,
             // Quick Wheel-210 check
             uint32_t r210 = n32 - (uint64_t(n32) * MU210 >> 32) * 210;
             if (r210 >= 210) r210 -= 210;
-            if (!WHEEL210_COPRIME[r210]) continue;
+            if (!WHEEL210_COPRIME[r210] && !(n32 <= 7 && (0xACu >> n32 & 1))) continue;
 
             // Full Barrett check (skip 2,3,5,7)
             bool survive = true;
@@ -321,7 +326,6 @@ void filter_stream_u64_wheel210_bitmap(const uint64_t* __restrict numbers,
     if (i < count) {
         const size_t base = i;
         uint8_t last = 0;
-        unsigned mask = 0;
         for (unsigned bit = 0; i < count; ++bit, ++i) {
             uint64_t n = numbers[i];
             if (n > 0xffffffffu) continue;
@@ -329,7 +333,7 @@ void filter_stream_u64_wheel210_bitmap(const uint64_t* __restrict numbers,
             uint32_t n32 = (uint32_t)n;
             uint32_t r210 = n32 - (uint64_t(n32) * MU210 >> 32) * 210;
             if (r210 >= 210) r210 -= 210;
-            if (!WHEEL210_COPRIME[r210]) continue;
+            if (!WHEEL210_COPRIME[r210] && !(n32 <= 7 && (0xACu >> n32 & 1))) continue;
 
             bool survive = true;
             for (int k = 4; k < 8; ++k) {
@@ -353,10 +357,9 @@ void filter_stream_u64_wheel210_bitmap(const uint64_t* __restrict numbers,
             }
 
             if (survive) last |= 1 << bit;
-            mask |= (1u << bit);
         }
         const size_t byte_off = base >> 3;
-        bitmap[byte_off] = (bitmap[byte_off] & ~uint8_t(mask)) | (last & uint8_t(mask));
+        bitmap[byte_off] = last;  // padding bits past count stay zero
     }
 }
 
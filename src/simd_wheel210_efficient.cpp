@@ -23,7 +23,7 @@ uint8_t movemask8_from_u32(uint32x4_t sv1, uint32x4_t sv2) {
     uint16x4_t s2 = vmovn_u32(sv2);
     uint8x8_t b = vmovn_u16(vcombine_u16(s1, s2));
     const uint8x8_t w = {1,2,4,8,16,32,64,128};
-    uint8x8_t t = vand_u8(vshr_n_u8(b, 7), w);
+    uint8x8_t t = vand_u8(b, w);
     t = vpadd_u8(t, t); t = vpadd_u8(t, t); t = vpadd_u8(t, t);
     return vget_lane_u8(t, 0);
 }
@@ -112,8 +112,6 @@ void barrett_modq_u32_quad(uint32x4_t n1, uint32x4_t n2, uint32x4_t n3, uint32x4
 // === Process 16 numbers with efficient Wheel-210 ===
 __attribute__((always_inline, flatten)) inline
 uint16_t filter16_u64_wheel210_efficient(const uint64_t* __restrict ptr) {
-    ptr = (const uint64_t*)__builtin_assume_aligned(ptr, 16);
-
     // Load 16 numbers
     uint64x2_t a0 = vld1q_u64(ptr + 0);
     uint64x2_t a1 = vld1q_u64(ptr + 2);
@@ -178,7 +176,7 @@ uint16_t filter16_u64_wheel210_efficient(const uint64_t* __restrict ptr) {
         uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu));
         uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
         uint32x4_t r = vsubq_u32(n, vmulq_u32(q, p));
-        r = vsubq_u32(r, vmulq_u32(vcgeq_u32(r, p), p));
+        r = vsubq_u32(r, vandq_u32(vcgeq_u32(r, p), p));
         uint32x4_t nz = vmvnq_u32(vceqq_u32(r, vdupq_n_u32(0)));
         return vorrq_u32(nz, vceqq_u32(n, p));
     };
@@ -270,8 +268,6 @@ uint16_t filter16_u64_wheel210_efficient(const uint64_t* __restrict ptr) {
 void filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numbers,
                                                  uint8_t*       __restrict bitmap,
                                                  size_t count) {
-    bitmap = (uint8_t*)__builtin_assume_aligned(bitmap, 4);
-
     size_t i = 0;
 
     // Process 32 at a time
@@ -294,7 +290,9 @@ void filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numb
         i += 16;
     }
 
-    // Scalar tail
+    // Scalar tail. i is a multiple of 16 here, so the tail owns whole bytes:
+    // write them fresh, leaving the padding bits past count zero.
+    if (i < count) std::memset(bitmap + (i >> 3), 0, ((count + 7) >> 3) - (i >> 3));
     for (; i < count; ++i) {
         uint64_t n = numbers[i];
         bool survive = false;
@@ -307,7 +305,8 @@ void filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numb
             if (r30 >= 30) r30 -= 30;
 
             bool wheel30 = (r30 == 1) || (r30 == 7) || (r30 == 11) || (r30 == 13) ||
-                           (r30 == 17) || (r30 == 19) || (r30 == 23) || (r30 == 29);
+                           (r30 == 17) || (r30 == 19) || (r30 == 23) || (r30 == 29) ||
+                           (n32 == 2) || (n32 == 3) || (n32 == 5);
 
             if (wheel30) {
                 // Additional mod 7 check for Wheel-210
@@ -339,14 +338,7 @@ void filter_stream_u64_wheel210_efficient_bitmap(const uint64_t* __restrict numb
             }
         }
 
-        // Set bit
-        size_t byte_idx = i >> 3;
-        size_t bit_idx = i & 7;
-        if (survive) {
-            bitmap[byte_idx] |= (1u << bit_idx);
-        } else {
-            bitmap[byte_idx] &= ~(1u << bit_idx);
-        }
+        if (survive) bitmap[i >> 3] |= uint8_t(1u << (i & 7));
     }
 }
 
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "stats.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace neon_stats {
+
+namespace {
+
+using Block = Fields<std::atomic<uint64_t>>;
+
+void accumulate(Snapshot& sum, const Block& b) {
+  each(sum, b, [](uint64_t& s, const std::atomic<uint64_t>& c) {
+    s += c.load(std::memory_order_relaxed);
+  });
+}
+
+void clear(Block& b) {
+  each(b, b, [](std::atomic<uint64_t>& c, std::atomic<uint64_t>&) {
+    c.store(0, std::memory_order_relaxed);
+  });
+}
+
+// Live blocks plus the totals of threads that have exited. Leaked so it
+// outlives the thread_local destructors that run at process exit.
+struct Registry {
+  std::mutex mu;
+  std::vector<Block*> live;
+  Snapshot retired;
+};
+
+Registry& registry() {
+  static Registry* r = new Registry;
+  return *r;
+}
+
+struct Slot {
+  Block block;
+  Slot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mu);
+    r.live.push_back(&block);
+  }
+  ~Slot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mu);
+    accumulate(r.retired, block);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), &block));
+  }
+};
+
+} // namespace
+
+const char* group_name(int g) {
+  static const char* const kNames[kGroups] = {"2-3", "5-7", "11-19", "23-37", "41-53"};
+  return g >= 0 && g < kGroups ? kNames[g] : "?";
+}
+
+Fields<std::atomic<uint64_t>>& local() {
+  thread_local Slot slot;
+  return slot.block;
+}
+
+Snapshot snapshot() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mu);
+  Snapshot sum = r.retired;
+  for (const Block* b : r.live) accumulate(sum, *b);
+  return sum;
+}
+
+void reset() {
+  Registry& r = registry();
+  std::lock_guard<std::mutex> lock(r.mu);
+  r.retired = Snapshot{};
+  for (Block* b : r.live) clear(*b);
+}
+
+} // namespace neon_stats
@@ -0,0 +1,237 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef PRIME8_STATS
+#define PRIME8_STATS 0
+#endif
+
+#if PRIME8_STATS
+#include <arm_neon.h>
+#endif
+
+// Per-stage lane counters for the filter hot paths: how many lanes the
+// >32-bit fallback, the wheel and each prime group eliminate, and where
+// barrett16_final's early-out leaves. They show whether the input mix
+// matches what the kernels were tuned for.
+//
+// Compiled in with -DPRIME8_STATS=ON (the PRIME8_STATS macro). Otherwise the
+// hooks below expand to nothing and snapshot() is all zeros. Each thread
+// counts into its own block; snapshot() sums every live thread plus those
+// that have exited. A kernel call tallies into a local Tally and folds it
+// into the thread's block when it returns.
+//
+// Instrumented: the vector steps of neon_wheel, neon_small, the delta block
+// filter and neon_final. Scalar tails and the other kernels are not counted.
+// neon_final runs wide values' low halves through the prime groups before
+// masking them, so its group counts include lanes already counted as wide.
+namespace neon_stats {
+
+constexpr bool kEnabled = PRIME8_STATS != 0;
+
+// Prime groups, matching barrett16_final's early-out checkpoints:
+// {2,3}, {5,7}, {11..19}, {23..37}, {41..53}. The wheel kernels test 2, 3
+// and 5 in the wheel, so their groups 0 and 1 cover only 7.
+constexpr int kGroups = 5;
+const char* group_name(int g);  // "2-3", "5-7", ...
+
+template <class T>
+struct Fields {
+  T lanes{};                    // numbers entering an instrumented vector step
+  T wide{};                     // of those, above 32 bits: dropped by the fallback
+  T wheel{};                    // dropped by the wheel-30 prefilter
+  T group[kGroups]{};           // dropped by each prime group (the first that divides)
+  T survivors{};
+  T steps{};                    // 8-lane divisible_mask_dual16_earlyout calls
+  T early_out[kGroups - 1]{};   // of those, left after group g with every lane dead
+  T wheel_skips{};              // 8-lane barrett16_final steps the wheel skipped whole
+};
+
+using Snapshot = Fields<uint64_t>;
+
+// Applies f to each pair of matching counters.
+template <class A, class B, class F>
+__attribute__((always_inline)) inline
+void each(A& a, B& b, F&& f) {
+  f(a.lanes, b.lanes);
+  f(a.wide, b.wide);
+  f(a.wheel, b.wheel);
+  for (int g = 0; g < kGroups; ++g) f(a.group[g], b.group[g]);
+  f(a.survivors, b.survivors);
+  f(a.steps, b.steps);
+  for (int g = 0; g < kGroups - 1; ++g) f(a.early_out[g], b.early_out[g]);
+  f(a.wheel_skips, b.wheel_skips);
+}
+
+// Sum over every thread since the last reset(). Cheap enough to poll, but
+// counts from calls still running are not in it yet.
+Snapshot snapshot();
+
+// Zeroes every thread's counters. Call while no kernel is running.
+void reset();
+
+// This thread's block. Only the owning thread writes it, so flush() adds
+// with a plain relaxed load + store: no locked instructions.
+Fields<std::atomic<uint64_t>>& local();
+
+// Adds t to this thread's block: once per kernel call, not per hook. Inline,
+// so the counters a kernel never bumps drop out of its flush.
+__attribute__((always_inline)) inline
+void flush(const Snapshot& t) {
+  Fields<std::atomic<uint64_t>>& b = local();
+  each(b, t, [](std::atomic<uint64_t>& c, const uint64_t& n) {
+    if (n) c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  });
+}
+
+#if PRIME8_STATS
+// m1 + m2 + m3 + m4, lane by lane.
+__attribute__((always_inline)) inline
+uint32x4_t sum(uint32x4_t m1, uint32x4_t m2, uint32x4_t m3, uint32x4_t m4) {
+  return vaddq_u32(vaddq_u32(m1, m2), vaddq_u32(m3, m4));
+}
+
+// Sum of the four lanes, widened.
+inline uint64_t total(uint32x4_t v) {
+  const uint64x2_t p = vpaddlq_u32(v);
+  return vgetq_lane_u64(p, 0) + vgetq_lane_u64(p, 1);
+}
+
+// Values above 32 bits among p[0, n).
+inline uint32_t wide(const uint64_t* p, size_t n) {
+  uint32_t w = 0;
+  for (size_t i = 0; i < n; ++i) w += p[i] > 0xffffffffu;
+  return w;
+}
+
+// One kernel call's counts. Counters bumped once per step are plain fields
+// the compiler keeps in registers; per-lane counts go into vector
+// accumulators (a lane counts up by subtracting a 0 / 0xFFFFFFFF mask), so a
+// step costs vertical adds only. The destructor reduces them and adds the
+// lot to the thread's block: one TLS lookup and one horizontal add per
+// counter per call. A lane gains at most 4 per 16-lane step, so the
+// accumulators cannot wrap within 2^30 steps (2^34 numbers) in one call.
+struct Tally : Snapshot {
+  uint32x4_t enabled{};             // lanes under 2^32, branch-free steps only
+  uint32x4_t passed{};              // lanes through the wheel
+  uint32x4_t marked[kGroups - 1]{}; // wheel steps: lanes marked by group g's checkpoint
+  uint32x4_t survived{};            // wheel steps: lanes through every group
+  uint32x4_t alive[kGroups]{};      // neon_final: lanes alive at group g's checkpoint
+  uint32x4_t dropped{};             // neon_final: of those alive at the end, wide
+
+  Tally() = default;
+  Tally(const Tally&) = delete;
+  Tally& operator=(const Tally&) = delete;
+  __attribute__((always_inline)) ~Tally() {
+    // Group counts are differences between checkpoints. Only neon_final
+    // counts steps; the other kernels make wheel steps only.
+    if (steps == 0) {
+      const uint64_t on = total(enabled), through = total(passed);
+      wide -= on;
+      wheel += on - through;
+      uint64_t before = 0;
+      for (int g = 1; g < kGroups - 1; ++g) {
+        const uint64_t m = total(marked[g]);
+        group[g] += m - before;
+        before = m;
+      }
+      // The lanes through the wheel that did not survive were marked by the
+      // last checkpoint.
+      const uint64_t left = total(survived);
+      survivors += left;
+      group[kGroups - 1] += through - left - before;
+    } else {
+      // A step starts with 8 alive and has none alive from the checkpoint
+      // it leaves at; the lanes alive at the end survive unless wide.
+      uint64_t before = 8 * steps;
+      for (int g = 0; g < kGroups; ++g) {
+        const uint64_t a = total(alive[g]);
+        group[g] += before - a;
+        before = a;
+      }
+      survivors += before - total(dropped);
+    }
+    flush(*this);
+  }
+};
+
+// One wheel step over `n` lanes, `w` of them wide (counted by the caller,
+// which only does so when the step has any); w1..w4 are the wheel masks
+// after the lane enables (padding lanes must fail the wheel).
+__attribute__((always_inline)) inline
+void wheel_step(Tally& t, uint32_t n, uint32_t w, uint32x4_t w1, uint32x4_t w2,
+                uint32x4_t w3, uint32x4_t w4) {
+  t.lanes += n;
+  t.wide += w;
+  t.wheel += n - w;
+  t.passed = vsubq_u32(t.passed, sum(w1, w2, w3, w4));
+}
+
+// The same for a branch-free step: en1..en4 enable the 16 lanes under 2^32
+// (padding lanes included), so wide = 16 - enabled.
+__attribute__((always_inline)) inline
+void wheel_step(Tally& t, uint32_t n, uint32x4_t en1, uint32x4_t en2, uint32x4_t en3,
+                uint32x4_t en4, uint32x4_t w1, uint32x4_t w2, uint32x4_t w3, uint32x4_t w4) {
+  t.lanes += n;
+  t.wide += 16;
+  t.wheel += uint64_t(n) - 16;  // may wrap; the destructor adds `enabled` back
+  t.enabled = vsubq_u32(t.enabled, sum(en1, en2, en3, en4));
+  t.passed = vsubq_u32(t.passed, sum(w1, w2, w3, w4));
+}
+
+// Lanes marked composite so far (m1..m4 are cumulative), at group g's
+// checkpoint of a wheel step, g < kGroups - 1. Every step reaches each
+// checkpoint, or calls this for the ones it skips once every lane is marked.
+__attribute__((always_inline)) inline
+void group_marked(Tally& t, int g, uint32x4_t m1, uint32x4_t m2, uint32x4_t m3,
+                  uint32x4_t m4) {
+  t.marked[g] = vsubq_u32(t.marked[g], sum(m1, m2, m3, m4));
+}
+
+// A wheel step's survivor masks sv1..sv4: counted here rather than from the
+// packed bits, so the step stays free of horizontal adds.
+__attribute__((always_inline)) inline
+void wheel_survivors(Tally& t, uint32x4_t sv1, uint32x4_t sv2, uint32x4_t sv3,
+                     uint32x4_t sv4) {
+  t.survived = vsubq_u32(t.survived, sum(sv1, sv2, sv3, sv4));
+}
+
+// Lanes still alive (a1, a2) at group g's checkpoint of a neon_final step.
+// A step that leaves there has none, so it need not call this.
+__attribute__((always_inline)) inline
+void group_alive(Tally& t, int g, uint32x4_t a1, uint32x4_t a2) {
+  t.alive[g] = vsubq_u32(t.alive[g], vaddq_u32(a1, a2));
+}
+
+// neon_final's survivor masks sv1, sv2 of a step with wide lanes, before the
+// lane enables en1, en2 drop those.
+inline void drop_wide(Tally& t, uint32x4_t sv1, uint32x4_t sv2, uint32x4_t en1,
+                      uint32x4_t en2) {
+  t.dropped = vsubq_u32(t.dropped, vaddq_u32(vbicq_u32(sv1, en1), vbicq_u32(sv2, en2)));
+}
+#endif
+
+} // namespace neon_stats
+
+// Hot-path hooks. PRIME8_STATS_SCOPE opens the call's Tally `stats` at the
+// top of a kernel entry point; helpers take it as a trailing
+// PRIME8_STATS_PARAM and callers forward it with PRIME8_STATS_ARG.
+// PRIME8_STAT(field, n) adds n to one of its counters; PRIME8_STATS_ONLY(...)
+// keeps a statement only in stats builds. All of them expand to nothing
+// otherwise, and none evaluates its arguments.
+#if PRIME8_STATS
+#define PRIME8_STATS_SCOPE ::neon_stats::Tally stats;
+#define PRIME8_STATS_PARAM , ::neon_stats::Tally& __restrict stats
+#define PRIME8_STATS_ARG , stats
+#define PRIME8_STAT(field, n) (stats.field += (n))
+#define PRIME8_STATS_ONLY(...) __VA_ARGS__
+#else
+#define PRIME8_STATS_SCOPE
+#define PRIME8_STATS_PARAM
+#define PRIME8_STATS_ARG
+#define PRIME8_STAT(field, n) ((void)0)
+#define PRIME8_STATS_ONLY(...)
+#endif
@@ -0,0 +1,302 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace neon_parallel {
+
+namespace {
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+    : WorkStealingPool(PoolOptions{threads, false, false}, Topology{}) {}
+
+WorkStealingPool::WorkStealingPool(const PoolOptions& opts, const Topology& topo)
+    : nslots_(opts.threads ? opts.threads : 1), pin_(opts.pin && !topo.cpus.empty()),
+      slots_(new Slot[nslots_]) {
+  place(topo, opts.topology);
+  start_workers();
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+// === Placement ===
+// Pick CPUs round-robin across nodes (fastest first within each node) so a
+// pool smaller than the machine still spans every node, then order slots by
+// node so each node's seed slices are one contiguous range of the input.
+void WorkStealingPool::place(const Topology& topo, bool topology_aware) {
+  placement_.assign(nslots_, CpuInfo{});
+  if (!topo.cpus.empty()) {
+    std::vector<std::vector<CpuInfo>> by_node(std::max(1u, topo.nodes));
+    for (const CpuInfo& c : topo.cpus) by_node[std::min<size_t>(c.node, by_node.size() - 1)].push_back(c);
+
+    std::vector<CpuInfo> picked;
+    std::vector<size_t> next(by_node.size(), 0);
+    while (picked.size() < nslots_) {
+      bool took = false;
+      for (size_t n = 0; n < by_node.size() && picked.size() < nslots_; ++n) {
+        if (next[n] < by_node[n].size()) {
+          picked.push_back(by_node[n][next[n]++]);
+          took = true;
+        }
+      }
+      // Oversubscribed: wrap around and reuse CPUs.
+      if (!took) std::fill(next.begin(), next.end(), 0);
+    }
+    std::stable_sort(picked.begin(), picked.end(), [](const CpuInfo& a, const CpuInfo& b) {
+      if (a.node != b.node) return a.node < b.node;
+      return a.capacity > b.capacity;
+    });
+    placement_ = picked;
+  }
+  if (!topology_aware) {
+    for (auto& p : placement_) p.capacity = 1024;
+  }
+
+  weight_prefix_.assign(nslots_ + 1, 0);
+  for (unsigned s = 0; s < nslots_; ++s) {
+    weight_prefix_[s + 1] = weight_prefix_[s] + std::max(1u, placement_[s].capacity);
+  }
+
+  // Steal order: same node first (ring order after self), then the rest.
+  victims_.assign(nslots_, {});
+  for (unsigned s = 0; s < nslots_; ++s) {
+    for (int pass = 0; pass < 2; ++pass) {
+      for (unsigned k = 1; k < nslots_; ++k) {
+        const unsigned v = (s + k) % nslots_;
+        const bool same = !topology_aware || placement_[v].node == placement_[s].node;
+        if (same == (pass == 0)) victims_[s].push_back(v);
+      }
+    }
+  }
+}
+
+void WorkStealingPool::start_workers() {
+  threads_.reserve(nslots_ - 1);
+  for (unsigned s = 1; s < nslots_; ++s) {
+    threads_.emplace_back(&WorkStealingPool::worker_main, this, s);
+  }
+}
+
+size_t WorkStealingPool::seed_begin(size_t chunks, unsigned s) const {
+  return static_cast<size_t>(static_cast<unsigned __int128>(chunks) * weight_prefix_[s] /
+                             weight_prefix_[nslots_]);
+}
+
+unsigned WorkStealingPool::seed_owner(size_t chunks, size_t c) const {
+  if (nslots_ == 1 || chunks < 2) return 0;
+  unsigned s = 0;
+  while (s + 1 < nslots_ && seed_begin(chunks, s + 1) <= c) ++s;
+  return s;
+}
+
+std::vector<WorkerStats> WorkStealingPool::last_run_stats() const {
+  std::vector<WorkerStats> out(nslots_);
+  for (unsigned s = 0; s < nslots_; ++s) {
+    out[s].slot = s;
+    out[s].cpu = placement_[s].cpu;
+    out[s].node = placement_[s].node;
+    out[s].capacity = placement_[s].capacity;
+    out[s].chunks = slots_[s].chunks;
+    out[s].steals = slots_[s].steals;
+    out[s].busy_ms = slots_[s].busy_ns / 1e6;
+  }
+  return out;
+}
+
+// === Job execution ===
+
+void WorkStealingPool::run(size_t chunks, ChunkFn fn, void* ctx, bool steal) {
+  std::lock_guard<std::mutex> serial(run_mutex_);
+  for (unsigned s = 0; s < nslots_; ++s) {
+    slots_[s].chunks = 0;
+    slots_[s].steals = 0;
+    slots_[s].busy_ns = 0;
+  }
+  if (chunks == 0) return;
+
+  // Nothing to share: run inline and keep the workers parked.
+  if (nslots_ == 1 || chunks == 1) {
+    const uint64_t t0 = now_ns();
+    for (size_t c = 0; c < chunks; ++c) fn(ctx, c);
+    slots_[0].chunks = chunks;
+    slots_[0].busy_ns = now_ns() - t0;
+    return;
+  }
+
+  // Seed every slot with a capacity-weighted contiguous slice.
+  for (unsigned s = 0; s < nslots_; ++s) {
+    std::lock_guard<std::mutex> lk(slots_[s].lock);
+    slots_[s].begin = seed_begin(chunks, s);
+    slots_[s].end   = seed_begin(chunks, s + 1);
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(mutex_);
+    fn_ = fn;
+    ctx_ = ctx;
+    steal_ = steal;
+    pending_.store(nslots_ - 1, std::memory_order_relaxed);
+    ++generation_;
+  }
+  wake_.notify_all();
+
+  // The caller acts as slot 0; when pinning, borrow slot 0's CPU for the
+  // duration of the job and give the caller its own mask back afterwards.
+  std::vector<unsigned> saved;
+  if (pin_) {
+    saved = current_affinity();
+    pin_current_thread(placement_[0].cpu);
+  }
+  drain(0);
+  if (pin_ && !saved.empty()) set_current_affinity(saved);
+
+  std::unique_lock<std::mutex> lk(mutex_);
+  done_.wait(lk, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+void WorkStealingPool::worker_main(unsigned self) {
+  if (pin_) pin_current_thread(placement_[self].cpu);
+
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lk(mutex_);
+      wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+
+    drain(self);
+
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> lk(mutex_);
+      done_.notify_one();
+    }
+  }
+}
+
+void WorkStealingPool::drain(unsigned self) {
+  const uint64_t t0 = now_ns();
+  size_t chunk, done = 0;
+  while (pop(self, chunk) || (steal_ && steal(self, chunk))) {
+    fn_(ctx_, chunk);
+    ++done;
+  }
+  slots_[self].chunks = done;
+  slots_[self].busy_ns = now_ns() - t0;
+}
+
+bool WorkStealingPool::pop(unsigned self, size_t& chunk) {
+  Slot& s = slots_[self];
+  std::lock_guard<std::mutex> lk(s.lock);
+  if (s.begin == s.end) return false;
+  chunk = s.begin++;
+  return true;
+}
+
+bool WorkStealingPool::steal(unsigned self, size_t& chunk) {
+  for (unsigned v : victims_[self]) {
+    Slot& victim = slots_[v];
+    size_t first, last;
+    {
+      std::lock_guard<std::mutex> lk(victim.lock);
+      const size_t remaining = victim.end - victim.begin;
+      if (remaining == 0) continue;
+      // Take the back half: the victim keeps walking forward through
+      // the chunks it has already started prefetching.
+      last = victim.end;
+      victim.end -= (remaining + 1) / 2;
+      first = victim.end;
+    }
+    chunk = first;
+    ++slots_[self].steals;
+    if (last - first > 1) {
+      Slot& mine = slots_[self];
+      std::lock_guard<std::mutex> lk(mine.lock);
+      mine.begin = first + 1;
+      mine.end = last;
+    }
+    return true;
+  }
+  return false;
+}
+
+// === Shared pool ===
+
+namespace {
+
+std::mutex g_pool_mutex;
+std::unique_ptr<WorkStealingPool> g_pool;
+bool g_pin = false;
+bool g_pin_init = false;
+
+unsigned resolve_threads(unsigned threads) {
+  if (threads) return threads;
+  if (const char* env = std::getenv("PRIME8_THREADS")) {
+    const unsigned long n = std::strtoul(env, nullptr, 10);
+    if (n) return static_cast<unsigned>(n);
+  }
+  const unsigned hw = std::thread::hardware_concurrency();
+  return hw ? hw : 1;
+}
+
+bool default_pin() {
+  if (!g_pin_init) {
+    const char* env = std::getenv("PRIME8_PIN");
+    g_pin = env && env[0] == '1';
+    g_pin_init = true;
+  }
+  return g_pin;
+}
+
+void rebuild_locked(PoolOptions opts) {
+  opts.threads = resolve_threads(opts.threads);
+  g_pin = opts.pin;
+  g_pin_init = true;
+  g_pool.reset();
+  g_pool = std::make_unique<WorkStealingPool>(opts, read_topology());
+}
+
+} // namespace
+
+WorkStealingPool& default_pool() {
+  std::lock_guard<std::mutex> lk(g_pool_mutex);
+  if (!g_pool) rebuild_locked(PoolOptions{0, default_pin(), true});
+  return *g_pool;
+}
+
+void configure(const PoolOptions& opts) {
+  std::lock_guard<std::mutex> lk(g_pool_mutex);
+  rebuild_locked(opts);
+}
+
+void set_thread_count(unsigned threads) {
+  std::lock_guard<std::mutex> lk(g_pool_mutex);
+  rebuild_locked(PoolOptions{threads, default_pin(), true});
+}
+
+unsigned thread_count() {
+  return default_pool().size();
+}
+
+std::vector<WorkerStats> last_run_stats() {
+  return default_pool().last_run_stats();
+}
+
+} // namespace neon_parallel
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "topology.hpp"
+
+namespace neon_parallel {
+
+struct PoolOptions {
+  unsigned threads = 0;   // 0 = $PRIME8_THREADS or hardware concurrency
+  bool pin = false;       // pin each slot to its CPU (Linux; no-op elsewhere)
+  bool topology = true;   // capacity-weighted seeding + same-node stealing first
+};
+
+// Per-slot accounting for the most recent run().
+struct WorkerStats {
+  unsigned slot = 0;
+  unsigned cpu = 0;
+  unsigned node = 0;
+  unsigned capacity = 1024;
+  size_t chunks = 0;      // chunks this slot executed
+  size_t steals = 0;      // successful steals (each grabs half a victim slice)
+  double busy_ms = 0.0;   // wall time from wake-up until the slot ran dry
+};
+
+// Persistent work-stealing pool used by the parallel_filter_* entry points.
+//
+// Slot 0 is the calling thread; slots 1..N-1 are long-lived workers that park
+// on a condition variable between jobs, so repeated calls pay no thread
+// creation cost. Each job is a range of chunk indices: every slot is seeded
+// with a contiguous slice, pops from the front of its own slice, and steals
+// the back half of a victim's slice once it runs dry.
+//
+// Slots are spread round-robin over NUMA nodes and then grouped by node, so
+// the contiguous seed slices of one node are adjacent in memory. Seed slices
+// are sized by core capacity (P-cores start with more work than E-cores),
+// and stealing tries same-node victims before crossing the interconnect, so
+// whichever cores finish first keep claiming chunks until nothing is left.
+class WorkStealingPool {
+public:
+  using ChunkFn = void (*)(void* ctx, size_t chunk);
+
+  explicit WorkStealingPool(unsigned threads);
+  WorkStealingPool(const PoolOptions& opts, const Topology& topo);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  unsigned size() const { return nslots_; }
+  bool pinned() const { return pin_; }
+
+  // Runs fn(ctx, c) for every c in [0, chunks) and blocks until all finish.
+  // Calls from different threads are serialized. With `steal` false every
+  // slot runs exactly its own seed slice, so chunk c runs on
+  // seed_owner(chunks, c) whatever the timing.
+  void run(size_t chunks, ChunkFn fn, void* ctx, bool steal = true);
+
+  template <class F>
+  void parallel_for(size_t chunks, F&& f, bool steal = true) {
+    using Fn = std::remove_reference_t<F>;
+    run(chunks, [](void* ctx, size_t c) { (*static_cast<Fn*>(ctx))(c); },
+        const_cast<void*>(static_cast<const void*>(&f)), steal);
+  }
+
+  // Slot that is seeded with chunk c when a job has `chunks` chunks: the one
+  // that runs it without stealing, and the likeliest to run it with.
+  unsigned seed_owner(size_t chunks, size_t c) const;
+
+  // Stats from the most recent run(); not synchronized with a concurrent run.
+  std::vector<WorkerStats> last_run_stats() const;
+
+private:
+  struct alignas(64) Slot {
+    std::mutex lock;
+    size_t begin = 0;
+    size_t end = 0;
+    // Written only by the owning thread during a run.
+    size_t chunks = 0;
+    size_t steals = 0;
+    uint64_t busy_ns = 0;
+  };
+
+  void place(const Topology& topo, bool topology_aware);
+  void start_workers();
+  void worker_main(unsigned self);
+  void drain(unsigned self);
+  bool pop(unsigned self, size_t& chunk);
+  bool steal(unsigned self, size_t& chunk);
+  size_t seed_begin(size_t chunks, unsigned s) const;
+
+  unsigned nslots_;
+  bool pin_ = false;
+  std::unique_ptr<Slot[]> slots_;
+  std::vector<CpuInfo> placement_;              // per slot
+  std::vector<uint64_t> weight_prefix_;         // nslots_ + 1 capacity prefix sums
+  std::vector<std::vector<unsigned>> victims_;  // per slot steal order
+  std::vector<std::thread> threads_;
+
+  std::mutex run_mutex_;           // serializes run() callers
+  std::mutex mutex_;               // guards generation_/stop_/job fields
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+  ChunkFn fn_ = nullptr;
+  void* ctx_ = nullptr;
+  bool steal_ = true;
+  std::atomic<unsigned> pending_{0};
+};
+
+// Process-wide pool shared by the parallel filters. Created on first use with
+// $PRIME8_THREADS threads (default: std::thread::hardware_concurrency()),
+// pinned when $PRIME8_PIN=1, using the topology read from /sys.
+WorkStealingPool& default_pool();
+
+// Rebuilds the shared pool. Must not be called while a parallel filter runs.
+void configure(const PoolOptions& opts);
+
+// Rebuilds the shared pool with `threads` threads (0 = the same default as
+// first use), keeping the current pinning choice.
+void set_thread_count(unsigned threads);
+unsigned thread_count();
+
+// Per-worker stats of the last parallel filter call on the shared pool.
+std::vector<WorkerStats> last_run_stats();
+
+} // namespace neon_parallel
@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#include "topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace neon_parallel {
+
+namespace {
+
+bool read_first_line(const std::string& path, std::string& line) {
+  std::ifstream in(path);
+  return in && std::getline(in, line);
+}
+
+bool read_unsigned(const std::string& path, unsigned long& value) {
+  std::string line;
+  if (!read_first_line(path, line) || line.empty()) return false;
+  char* end = nullptr;
+  value = std::strtoul(line.c_str(), &end, 10);
+  return end != line.c_str();
+}
+
+std::string trim(const std::string& s) {
+  const size_t b = s.find_first_not_of(" \t\r\n");
+  const size_t e = s.find_last_not_of(" \t\r\n");
+  return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+} // namespace
+
+std::string cpu_model() {
+#if defined(__APPLE__)
+  char buf[256] = {};
+  size_t len = sizeof(buf);
+  if (::sysctlbyname("machdep.cpu.brand_string", buf, &len, nullptr, 0) == 0) return buf;
+#else
+  // x86 has "model name"; most arm64 kernels only have the implementer/part ids.
+  std::ifstream in("/proc/cpuinfo");
+  std::string line, implementer, part;
+  while (std::getline(in, line)) {
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    const std::string key = trim(line.substr(0, colon));
+    const std::string value = trim(line.substr(colon + 1));
+    if (key == "model name" || key == "Hardware") return value;
+    if (key == "CPU implementer" && implementer.empty()) implementer = value;
+    if (key == "CPU part" && part.empty()) part = value;
+  }
+  if (!implementer.empty()) return "arm64 implementer " + implementer + " part " + part;
+#endif
+  return "unknown";
+}
+
+std::vector<unsigned> parse_cpulist(const std::string& list) {
+  std::vector<unsigned> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t comma = list.find(',', pos);
+    if (comma == std::string::npos) comma = list.size();
+    const std::string item = list.substr(pos, comma - pos);
+    pos = comma + 1;
+    if (item.empty() || item[0] < '0' || item[0] > '9') continue;
+    char* end = nullptr;
+    const unsigned long lo = std::strtoul(item.c_str(), &end, 10);
+    unsigned long hi = lo;
+    if (*end == '-') hi = std::strtoul(end + 1, nullptr, 10);
+    for (unsigned long c = lo; c <= hi; ++c) cpus.push_back(static_cast<unsigned>(c));
+  }
+  return cpus;
+}
+
+Topology read_topology(const std::string& sysfs_root) {
+  Topology topo;
+  const std::string cpu_dir = sysfs_root + "/devices/system/cpu/";
+  const std::string node_dir = sysfs_root + "/devices/system/node/";
+
+  // CPU universe: the online list, restricted to our affinity mask when
+  // looking at the live system.
+  std::string line;
+  std::vector<unsigned> online;
+  if (read_first_line(cpu_dir + "online", line)) online = parse_cpulist(line);
+  if (online.empty()) {
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned c = 0; c < hw; ++c) topo.cpus.push_back({c, 0, 1024});
+    return topo;
+  }
+#if defined(__linux__)
+  if (sysfs_root == "/sys") {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+      online.erase(std::remove_if(online.begin(), online.end(),
+                                  [&](unsigned c) { return !CPU_ISSET(c, &mask); }),
+                   online.end());
+    }
+  }
+#endif
+
+  // Node membership.
+  std::map<unsigned, unsigned> node_of;
+  unsigned max_node = 0;
+  std::vector<unsigned> node_ids;
+  if (read_first_line(node_dir + "online", line)) node_ids = parse_cpulist(line);
+  for (unsigned node : node_ids) {
+    if (!read_first_line(node_dir + "node" + std::to_string(node) + "/cpulist", line)) continue;
+    for (unsigned c : parse_cpulist(line)) node_of[c] = node;
+    max_node = std::max(max_node, node);
+  }
+
+  // Core class: cpu_capacity (arm64, hybrid x86 kernels) or max frequency.
+  std::vector<unsigned long> raw(online.size(), 0);
+  unsigned long best = 0;
+  for (size_t i = 0; i < online.size(); ++i) {
+    const std::string base = cpu_dir + "cpu" + std::to_string(online[i]) + "/";
+    unsigned long v = 0;
+    if (!read_unsigned(base + "cpu_capacity", v)) {
+      read_unsigned(base + "cpufreq/cpuinfo_max_freq", v);
+    }
+    raw[i] = v;
+    best = std::max(best, v);
+  }
+
+  for (size_t i = 0; i < online.size(); ++i) {
+    CpuInfo info;
+    info.cpu = online[i];
+    auto it = node_of.find(online[i]);
+    info.node = (it != node_of.end()) ? it->second : 0;
+    info.capacity = (best && raw[i]) ? static_cast<unsigned>(raw[i] * 1024 / best) : 1024;
+    if (info.capacity == 0) info.capacity = 1;
+    topo.cpus.push_back(info);
+  }
+
+  std::stable_sort(topo.cpus.begin(), topo.cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+    if (a.node != b.node) return a.node < b.node;
+    return a.capacity > b.capacity;
+  });
+  topo.nodes = node_of.empty() ? 1 : max_node + 1;
+  return topo;
+}
+
+bool pin_current_thread(unsigned cpu) {
+  return set_current_affinity({cpu});
+}
+
+std::vector<unsigned> current_affinity() {
+  std::vector<unsigned> cpus;
+#if defined(__linux__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask) == 0) {
+    for (unsigned c = 0; c < CPU_SETSIZE; ++c) {
+      if (CPU_ISSET(c, &mask)) cpus.push_back(c);
+    }
+  }
+#endif
+  return cpus;
+}
+
+bool set_current_affinity(const std::vector<unsigned>& cpus) {
+#if defined(__linux__)
+  if (cpus.empty()) return false;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (unsigned c : cpus) {
+    if (c < CPU_SETSIZE) CPU_SET(c, &mask);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+#else
+  (void)cpus;  // macOS has no hard affinity; the scheduler places threads
+  return false;
+#endif
+}
+
+} // namespace neon_parallel
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neon_parallel {
+
+// One schedulable CPU as seen by this process.
+struct CpuInfo {
+  unsigned cpu = 0;          // kernel CPU id (what pthread affinity takes)
+  unsigned node = 0;         // NUMA node
+  unsigned capacity = 1024;  // relative speed; 1024 = fastest core class
+};
+
+struct Topology {
+  std::vector<CpuInfo> cpus; // grouped by node, fastest cores first per node
+  unsigned nodes = 1;
+};
+
+// Reads NUMA nodes from <root>/devices/system/node/node*/cpulist and core
+// capacity from <root>/devices/system/cpu/cpu*/cpu_capacity (falling back to
+// cpufreq/cpuinfo_max_freq, scaled so the fastest core is 1024). Only CPUs in
+// the process affinity mask are returned when reading the live /sys. Hosts
+// without /sys report hardware_concurrency CPUs on a single node.
+Topology read_topology(const std::string& sysfs_root = "/sys");
+
+// CPU model name: machdep.cpu.brand_string on macOS, /proc/cpuinfo "model
+// name" elsewhere (implementer/part ids on arm64 Linux), else "unknown".
+std::string cpu_model();
+
+// Parses the kernel cpulist format ("0-3,8,10-11").
+std::vector<unsigned> parse_cpulist(const std::string& list);
+
+// Pins the calling thread to one CPU. Returns false where unsupported.
+bool pin_current_thread(unsigned cpu);
+
+// Save/restore the calling thread's CPU set (empty where unsupported).
+std::vector<unsigned> current_affinity();
+bool set_current_affinity(const std::vector<unsigned>& cpus);
+
+} // namespace neon_parallel
@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+#pragma once
+#include <arm_neon.h>
+#include <cstdint>
+#include "primes_tables.hpp"
+#include "stats.hpp"
+
+// Register-level pieces of the wheel-30 + Barrett filter, shared by the
+// neon_wheel stream kernels and kernels that produce their lanes in registers
+// (e.g. the delta-block decoder) instead of loading them from memory.
+namespace neon_wheel {
+
+// === SIMD bitpack helper for ARM NEON ===
+__attribute__((always_inline)) inline
+uint8_t movemask8_from_u32(uint32x4_t sv1, uint32x4_t sv2) {
+  uint16x4_t s1 = vmovn_u32(sv1);
+  uint16x4_t s2 = vmovn_u32(sv2);
+  uint8x8_t  b  = vmovn_u16(vcombine_u16(s1, s2)); // 0xFF/0x00 per lane
+
+  // Extract each byte's MSB and build mask
+  uint8_t mask = 0;
+  mask |= (vget_lane_u8(b, 0) & 0x80) ? 0x01 : 0;
+  mask |= (vget_lane_u8(b, 1) & 0x80) ? 0x02 : 0;
+  mask |= (vget_lane_u8(b, 2) & 0x80) ? 0x04 : 0;
+  mask |= (vget_lane_u8(b, 3) & 0x80) ? 0x08 : 0;
+  mask |= (vget_lane_u8(b, 4) & 0x80) ? 0x10 : 0;
+  mask |= (vget_lane_u8(b, 5) & 0x80) ? 0x20 : 0;
+  mask |= (vget_lane_u8(b, 6) & 0x80) ? 0x40 : 0;
+  mask |= (vget_lane_u8(b, 7) & 0x80) ? 0x80 : 0;
+  return mask;
+}
+
+__attribute__((always_inline)) inline
+uint16_t bitpack16_from_u32_masks(uint32x4_t sv1, uint32x4_t sv2,
+                                  uint32x4_t sv3, uint32x4_t sv4) {
+  const uint8_t lo = movemask8_from_u32(sv1, sv2);
+  const uint8_t hi = movemask8_from_u32(sv3, sv4);
+  return (uint16_t)lo | ((uint16_t)hi << 8);
+}
+
+// === Wheel-30 (2×3×5) prefilter ===
+// Only 8 residues mod 30 can be prime: {1,7,11,13,17,19,23,29}
+// This eliminates 22/30 = 73.3% of numbers before Barrett
+constexpr uint32_t MU30 = 143165576u; // floor(2^32 / 30)
+
+// === Quad Barrett reduction (from Ultra) ===
+__attribute__((always_inline)) inline
+void barrett_modq_u32_quad(uint32x4_t n1, uint32x4_t n2, uint32x4_t n3, uint32x4_t n4,
+                           uint32x4_t mu, uint32x4_t p,
+                           uint32x4_t& r1, uint32x4_t& r2, uint32x4_t& r3, uint32x4_t& r4) {
+  // Multiply all 4 vectors with mu
+  uint64x2_t lo1 = vmull_u32(vget_low_u32(n1), vget_low_u32(mu));
+  uint64x2_t hi1 = vmull_u32(vget_high_u32(n1), vget_high_u32(mu));
+  uint64x2_t lo2 = vmull_u32(vget_low_u32(n2), vget_low_u32(mu));
+  uint64x2_t hi2 = vmull_u32(vget_high_u32(n2), vget_high_u32(mu));
+  uint64x2_t lo3 = vmull_u32(vget_low_u32(n3), vget_low_u32(mu));
+  uint64x2_t hi3 = vmull_u32(vget_high_u32(n3), vget_high_u32(mu));
+  uint64x2_t lo4 = vmull_u32(vget_low_u32(n4), vget_low_u32(mu));
+  uint64x2_t hi4 = vmull_u32(vget_high_u32(n4), vget_high_u32(mu));
+
+  // Extract quotients
+  uint32x4_t q1 = vcombine_u32(vshrn_n_u64(lo1, 32), vshrn_n_u64(hi1, 32));
+  uint32x4_t q2 = vcombine_u32(vshrn_n_u64(lo2, 32), vshrn_n_u64(hi2, 32));
+  uint32x4_t q3 = vcombine_u32(vshrn_n_u64(lo3, 32), vshrn_n_u64(hi3, 32));
+  uint32x4_t q4 = vcombine_u32(vshrn_n_u64(lo4, 32), vshrn_n_u64(hi4, 32));
+
+  // Compute remainders
+  r1 = vsubq_u32(n1, vmulq_u32(q1, p));
+  r2 = vsubq_u32(n2, vmulq_u32(q2, p));
+  r3 = vsubq_u32(n3, vmulq_u32(q3, p));
+  r4 = vsubq_u32(n4, vmulq_u32(q4, p));
+
+  // Conditional subtraction for exact modulo
+  r1 = vsubq_u32(r1, vandq_u32(vcgeq_u32(r1, p), p));
+  r2 = vsubq_u32(r2, vandq_u32(vcgeq_u32(r2, p), p));
+  r3 = vsubq_u32(r3, vandq_u32(vcgeq_u32(r3, p), p));
+  r4 = vsubq_u32(r4, vandq_u32(vcgeq_u32(r4, p), p));
+}
+
+// === Wheel-30 prefilter for 16 lanes ===
+__attribute__((always_inline)) inline
+uint32x4_t wheel30_mask(uint32x4_t n) {
+  // Compute n % 30 using Barrett
+  const uint32x4_t thirty = vdupq_n_u32(30);
+  const uint32x4_t mu30 = vdupq_n_u32(MU30);
+
+  uint64x2_t lo = vmull_u32(vget_low_u32(n), vget_low_u32(mu30));
+  uint64x2_t hi = vmull_u32(vget_high_u32(n), vget_high_u32(mu30));
+  uint32x4_t q = vcombine_u32(vshrn_n_u64(lo, 32), vshrn_n_u64(hi, 32));
+  uint32x4_t r = vsubq_u32(n, vmulq_u32(q, thirty));
+  r = vsubq_u32(r, vandq_u32(vcgeq_u32(r, thirty), thirty)); // if (r>=30) r-=30
+
+  // Check coprime residues: 1,7,11,13,17,19,23,29
+  const uint32x4_t r1  = vdupq_n_u32(1);
+  const uint32x4_t r7  = vdupq_n_u32(7);
+  const uint32x4_t r11 = vdupq_n_u32(11);
+  const uint32x4_t r13 = vdupq_n_u32(13);
+  const uint32x4_t r17 = vdupq_n_u32(17);
+  const uint32x4_t r19 = vdupq_n_u32(19);
+  const uint32x4_t r23 = vdupq_n_u32(23);
+  const uint32x4_t r29 = vdupq_n_u32(29);
+
+  uint32x4_t mask = vceqq_u32(r, r1);
+  mask = vorrq_u32(mask, vceqq_u32(r, r7));
+  mask = vorrq_u32(mask, vceqq_u32(r, r11));
+  mask = vorrq_u32(mask, vceqq_u32(r, r13));
+  mask = vorrq_u32(mask, vceqq_u32(r, r17));
+  mask = vorrq_u32(mask, vceqq_u32(r, r19));
+  mask = vorrq_u32(mask, vceqq_u32(r, r23));
+  mask = vorrq_u32(mask, vceqq_u32(r, r29));
+
+  return mask; // 0xFFFFFFFF if possibly prime, 0 if definitely composite
+}
+
+// Wheel-30 candidates among 16 lanes; 2, 3 and 5 themselves pass.
+__attribute__((always_inline)) inline
+uint32x4_t wheel30_lanes(uint32x4_t n) {
+  uint32x4_t w = wheel30_mask(n);
+  w = vorrq_u32(w, vceqq_u32(n, vdupq_n_u32(2)));
+  w = vorrq_u32(w, vceqq_u32(n, vdupq_n_u32(3)));
+  w = vorrq_u32(w, vceqq_u32(n, vdupq_n_u32(5)));
+  return w;
+}
+
+// Barrett stage for 16 lanes n1..n4 whose wheel masks are wheel1..wheel4
+// (lanes out of range already cleared). Returns the 16-bit survivor mask.
+// With EarlyOut, returns 0 after 7..19 when every lane is already out,
+// skipping 23..53: a branch per step that pays off on composite-heavy input.
+template <bool EarlyOut = false>
+__attribute__((always_inline)) inline
+uint16_t sieve16_u32(uint32x4_t n1, uint32x4_t n2, uint32x4_t n3, uint32x4_t n4,
+                     uint32x4_t wheel1, uint32x4_t wheel2,
+                     uint32x4_t wheel3, uint32x4_t wheel4 PRIME8_STATS_PARAM) {
+  // Quick check: if no lanes pass wheel (after special cases), all are composite
+  if ((vmaxvq_u32(wheel1) | vmaxvq_u32(wheel2) |
+       vmaxvq_u32(wheel3) | vmaxvq_u32(wheel4)) == 0) {
+    return 0;
+  }
+
+  // Full Barrett reduction for lanes that passed wheel
+  const uint32x4_t zero = vdupq_n_u32(0);
+  uint32x4_t m1 = zero, m2 = zero, m3 = zero, m4 = zero;
+
+  // Marks lanes divisible by primes[from, to) (r==0 and n!=p), among those
+  // that passed the wheel. Split at the stats checkpoints, so the hooks sit
+  // between loops rather than behind a branch in each iteration.
+  auto mark = [&](const uint32_t* primes, const uint32_t* mus, int from, int to) {
+    for (int i = from; i < to; ++i) {
+      const uint32x4_t p = vdupq_n_u32(primes[i]);
+      const uint32x4_t mu = vdupq_n_u32(mus[i]);
+
+      uint32x4_t r1, r2, r3, r4;
+      barrett_modq_u32_quad(n1, n2, n3, n4, mu, p, r1, r2, r3, r4);
+
+      uint32x4_t d1 = vandq_u32(vceqq_u32(r1, zero), vmvnq_u32(vceqq_u32(n1, p)));
+      uint32x4_t d2 = vandq_u32(vceqq_u32(r2, zero), vmvnq_u32(vceqq_u32(n2, p)));
+      uint32x4_t d3 = vandq_u32(vceqq_u32(r3, zero), vmvnq_u32(vceqq_u32(n3, p)));
+      uint32x4_t d4 = vandq_u32(vceqq_u32(r4, zero), vmvnq_u32(vceqq_u32(n4, p)));
+
+      d1 = vandq_u32(d1, wheel1);
+      d2 = vandq_u32(d2, wheel2);
+      d3 = vandq_u32(d3, wheel3);
+      d4 = vandq_u32(d4, wheel4);
+
+      m1 = vorrq_u32(m1, d1);
+      m2 = vorrq_u32(m2, d2);
+      m3 = vorrq_u32(m3, d3);
+      m4 = vorrq_u32(m4, d4);
+    }
+  };
+
+  // Remaining small primes: skip 2,3,5 since the wheel handled them
+  mark(SMALL_PRIMES, SMALL_MU, 3, 4);  // 7
+  PRIME8_STATS_ONLY(neon_stats::group_marked(stats, 1, m1, m2, m3, m4);)
+  mark(SMALL_PRIMES, SMALL_MU, 4, 8);  // 11..19
+  PRIME8_STATS_ONLY(neon_stats::group_marked(stats, 2, m1, m2, m3, m4);)
+
+  if constexpr (EarlyOut) {
+    const uint32x4_t a12 = vorrq_u32(vbicq_u32(wheel1, m1), vbicq_u32(wheel2, m2));
+    const uint32x4_t a34 = vorrq_u32(vbicq_u32(wheel3, m3), vbicq_u32(wheel4, m4));
+    if (vmaxvq_u32(vorrq_u32(a12, a34)) == 0) {
+      PRIME8_STATS_ONLY(neon_stats::group_marked(stats, 3, m1, m2, m3, m4);)
+      return 0;
+    }
+  }
+
+  // Extended primes
+  mark(EXT_PRIMES, EXT_MU, 0, 4);  // 23..37
+  PRIME8_STATS_ONLY(neon_stats::group_marked(stats, 3, m1, m2, m3, m4);)
+  mark(EXT_PRIMES, EXT_MU, 4, 8);  // 41..53
+
+  // Survivors = passed wheel AND not marked composite
+  uint32x4_t sv1 = vandq_u32(wheel1, vceqq_u32(m1, zero));
+  uint32x4_t sv2 = vandq_u32(wheel2, vceqq_u32(m2, zero));
+  uint32x4_t sv3 = vandq_u32(wheel3, vceqq_u32(m3, zero));
+  uint32x4_t sv4 = vandq_u32(wheel4, vceqq_u32(m4, zero));
+
+  // The stats derive group 4 (41..53) from this.
+  PRIME8_STATS_ONLY(neon_stats::wheel_survivors(stats, sv1, sv2, sv3, sv4);)
+  return bitpack16_from_u32_masks(sv1, sv2, sv3, sv4);
+}
+
+} // namespace neon_wheel
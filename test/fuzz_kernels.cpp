@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "harness.hpp"
+
+// Differential fuzz target over every kernel in prime8_bench's registry.
+// Built as a libFuzzer target with -DPRIME8_FUZZ=ON (clang), and linked into
+// fuzz_replay, which replays corpus files or random inputs without it.
+//
+// Input layout:
+//   byte 0  bits 0-3: input start, in u64s past the allocation's start
+//           bit 4:    run through neon_stream::filter_stream, non-temporal
+//   byte 1  output start, in bytes past a 64-byte aligned base (0..63)
+//   byte 2  value shape, see shape()
+//   rest    little-endian u64 values; a short last value is zero-padded
+//
+// Each kernel's output must match its scalar reference, agree with every
+// other kernel of the same depth, and leave the bytes around it untouched.
+// Bitmap kernels own the whole last byte: its padding bits past n must be
+// zero whatever the buffer held before, so callers can popcount bytes.
+// Any failure prints the case and aborts.
+namespace {
+
+using namespace prime8_bench;
+
+constexpr size_t kHeader = 3;
+constexpr size_t kMaxValues = 8192;
+constexpr size_t kSlack = 64;
+constexpr uint8_t kGuard = 0xA5;
+
+// Raw bytes rarely land on the values kernels special-case, so most inputs
+// are folded into a narrower range first.
+uint64_t shape(uint8_t kind, uint64_t v) {
+  switch (kind % 5) {
+    case 1: return v & 0xffffffffu;                        // u32
+    case 2: return v & 0xffff;                             // dense small values
+    case 3: return (uint64_t(1) << 32) - 128 + (v & 0xff); // straddles 2^32
+    case 4: return v & 0x3f;                               // the filter primes themselves
+    default: return v;
+  }
+}
+
+[[noreturn]] void fail(const char* what, const Kernel& k, size_t n, size_t in_off,
+                       size_t out_off, bool nt, size_t i, uint64_t v) {
+  std::fprintf(stderr,
+               "fuzz_kernels: %s: kernel=%s n=%zu in_off=%zu out_off=%zu nt=%d i=%zu "
+               "value=%llu\n",
+               what, k.name, n, in_off, out_off, nt ? 1 : 0, i,
+               static_cast<unsigned long long>(v));
+  std::abort();
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size < kHeader) return 0;
+  const size_t in_off = data[0] & 15;
+  const bool nt = (data[0] >> 4) & 1;
+  const size_t out_off = data[1] & 63;
+  const uint8_t kind = data[2];
+  data += kHeader;
+  size -= kHeader;
+
+  const size_t n = std::min((size + 7) / 8, kMaxValues);
+  // Sized exactly, so a sanitizer build catches reads past the last value.
+  std::vector<uint64_t> input(in_off + n);
+  uint64_t* values = input.data() + in_off;
+  for (size_t i = 0; i < n; ++i) {
+    uint8_t b[8] = {};
+    std::memcpy(b, data + 8 * i, std::min<size_t>(8, size - 8 * i));
+    uint64_t v = 0;
+    for (int j = 7; j >= 0; --j) v = (v << 8) | b[j];
+    values[i] = shape(kind, v);
+  }
+
+  // Survivor flags of the first kernel of each depth, for the cross-check.
+  std::vector<std::vector<uint8_t>> anchor(17);
+  std::vector<const Kernel*> anchor_kernel(17, nullptr);
+  alignas(64) static uint8_t storage[kMaxValues + 2 * kSlack];
+
+  for (const Kernel& k : kernels()) {
+    const bool bitmap = k.output == Output::Bitmap;
+    const size_t out_size = bitmap ? (n + 7) / 8 : n;
+    std::memset(storage, kGuard, out_off + out_size + kSlack);
+    uint8_t* out = storage + out_off;
+    if (nt) {
+      neon_stream::filter_stream(k.fn, bitmap, values, out, n,
+                                 neon_stream::OutputPolicy::NonTemporal);
+    } else {
+      k.fn(values, out, n);
+    }
+
+    for (size_t i = 0; i < out_off; ++i) {
+      if (storage[i] != kGuard) fail("wrote before the output", k, n, in_off, out_off, nt, i, 0);
+    }
+    for (size_t i = out_size; i < out_size + kSlack; ++i) {
+      if (out[i] != kGuard) fail("wrote past the output", k, n, in_off, out_off, nt, i, 0);
+    }
+    if (bitmap && (n & 7) && (out[out_size - 1] >> (n & 7))) {
+      fail("left padding bits set in the last bitmap byte", k, n, in_off, out_off, nt, n, 0);
+    }
+
+    std::vector<uint8_t> flags(n);
+    for (size_t i = 0; i < n; ++i) flags[i] = survives(k, out, i);
+
+    if (!anchor_kernel[k.depth]) {
+      anchor_kernel[k.depth] = &k;
+      anchor[k.depth] = flags;
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        if (flags[i] != anchor[k.depth][i]) {
+          std::fprintf(stderr, "fuzz_kernels: %s and %s disagree\n", anchor_kernel[k.depth]->name,
+                       k.name);
+          fail("kernels disagree", k, n, in_off, out_off, nt, i, values[i]);
+        }
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (flags[i] != k.expect(values[i])) {
+        fail(flags[i] ? "kept a value the reference drops" : "dropped a value the reference keeps",
+             k, n, in_off, out_off, nt, i, values[i]);
+      }
+    }
+  }
+  return 0;
+}
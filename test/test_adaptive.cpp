@@ -0,0 +1,122 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+
+namespace {
+
+const uint32_t kPrimes[16] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+
+bool survives(uint64_t n, int depth) {
+  if (n > 0xffffffffu) return false;
+  for (int i = 0; i < depth; ++i) {
+    if (n != kPrimes[i] && n % kPrimes[i] == 0) return false;
+  }
+  return true;
+}
+
+bool reference_is_prime(uint64_t n) {
+  if (n < 2) return false;
+  if (n % 2 == 0) return n == 2;
+  for (uint64_t d = 3; d * d <= n; d += 2) {
+    if (n % d == 0) return false;
+  }
+  return true;
+}
+
+bool check_depth(neon_adaptive::Depth depth, const std::vector<uint64_t>& values) {
+  const size_t n = values.size();
+  std::vector<uint8_t> bitmap((n + 7) / 8 + 1, 0xA5);
+  neon_adaptive::filter_stream_u64_depth_bitmap(depth, values.data(), bitmap.data(), n);
+  for (size_t i = 0; i < n; ++i) {
+    const bool got = (bitmap[i >> 3] >> (i & 7)) & 1;
+    if (got != survives(values[i], static_cast<int>(depth))) {
+      std::printf("depth %d: n=%zu index %zu value %llu got %d\n", static_cast<int>(depth), n,
+                  i, static_cast<unsigned long long>(values[i]), int(got));
+      return false;
+    }
+  }
+  if (bitmap[(n + 7) / 8] != 0xA5) {
+    std::printf("depth %d: wrote past the end (n=%zu)\n", static_cast<int>(depth), n);
+    return false;
+  }
+  return true;
+}
+
+// `n` values of a shared dataset (datasets.hpp).
+std::vector<uint64_t> dataset(const char* name, size_t n, uint64_t seed) {
+  std::vector<uint64_t> v(n);
+  neon_data::generate(*neon_data::find(name), v.data(), n, seed);
+  return v;
+}
+
+} // namespace
+
+int main() {
+  uint64_t seed = 11;
+
+  // Kernels: every depth against the scalar definition, small values and
+  // 32/64-bit edges included.
+  for (size_t n : {size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), size_t(1000),
+                   size_t(4099)}) {
+    std::vector<uint64_t> values = dataset("uniform32", n, ++seed);
+    for (size_t i = 0; i < n; ++i) {
+      switch (i % 5) {
+        case 0: values[i] = i; break;
+        case 1: values[i] = 0xffffffffull - i; break;
+        case 2: values[i] = 0x100000000ull + i; break;
+        default: break;
+      }
+    }
+    for (auto d : {neon_adaptive::Depth::Wheel, neon_adaptive::Depth::Wheel8,
+                   neon_adaptive::Depth::Full16}) {
+      if (!check_depth(d, values)) return 1;
+    }
+  }
+
+  // Engine: exact flags on an input that drifts between composite-heavy,
+  // random and odd-only regimes; small resample interval so it probes often.
+  std::vector<uint64_t> values;
+  for (int segment = 0; segment < 6; ++segment) {
+    static const char* const kRegimes[] = {"composite80", "uniform32", "odd32"};
+    const auto part = dataset(kRegimes[segment % 3], 20000, ++seed);
+    values.insert(values.end(), part.begin(), part.end());
+  }
+
+  neon_adaptive::AdaptiveOptions opts;
+  opts.resample_tiles = 4;
+  neon_adaptive::AdaptiveEngine engine(opts);
+  std::vector<uint8_t> flags(values.size(), 0xA5);
+  const size_t primes = engine.prime_flags(values.data(), flags.data(), values.size());
+
+  size_t want = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const bool p = reference_is_prime(values[i]);
+    want += p;
+    if (flags[i] != p) {
+      std::printf("engine: index %zu value %llu flag %u\n", i,
+                  static_cast<unsigned long long>(values[i]), flags[i]);
+      return 1;
+    }
+  }
+
+  const auto& s = engine.stats();
+  const size_t tiles = s.tiles[0] + s.tiles[1] + s.tiles[2];
+  const size_t expect_tiles = (values.size() + neon_adaptive::kAdaptiveTile - 1) /
+                              neon_adaptive::kAdaptiveTile;
+  if (primes != want || s.primes != want || s.numbers != values.size() ||
+      tiles != expect_tiles || s.probes < expect_tiles / 5) {
+    std::printf("engine: primes %zu/%zu want %zu, numbers %zu, tiles %zu/%zu, probes %zu\n",
+                primes, s.primes, want, s.numbers, tiles, expect_tiles, s.probes);
+    return 1;
+  }
+  if (engine.prime_count(values.data(), values.size()) != want) {
+    std::printf("engine: prime_count mismatch\n");
+    return 1;
+  }
+
+  std::puts("OK");
+  return 0;
+}
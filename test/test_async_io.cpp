@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "async_io.hpp"
+
+namespace {
+
+using neon_io::AsyncOptions;
+using neon_io::Backend;
+
+// Files live in the working directory (usually a real disk, so O_DIRECT is
+// exercised) rather than /tmp, which is often tmpfs.
+struct TempFile {
+  char path[64];
+  int fd;
+  TempFile() {
+    std::strcpy(path, "test_async_io.XXXXXX");
+    fd = ::mkstemp(path);
+  }
+  ~TempFile() {
+    if (fd >= 0) ::close(fd);
+    ::unlink(path);
+  }
+};
+
+bool check_read(Backend backend, bool direct, size_t bytes) {
+  const char* label = backend == Backend::Uring ? "uring" : "threads";
+  std::mt19937_64 rng(bytes);
+  std::vector<uint8_t> data(bytes);
+  for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+  TempFile f;
+  if (f.fd < 0 || ::write(f.fd, data.data(), bytes) != static_cast<ssize_t>(bytes)) {
+    std::printf("%s: cannot create temp file\n", label);
+    return false;
+  }
+  const int fd = ::open(f.path, O_RDONLY);
+  AsyncOptions opts;
+  opts.buffer_bytes = 8192;
+  opts.depth = 3;
+  opts.direct = direct;
+  opts.backend = backend;
+
+  std::vector<uint8_t> got;
+  {
+    neon_io::AsyncReader reader(fd, bytes, opts);
+    const uint8_t* p = nullptr;
+    size_t len = 0;
+    while (reader.next(p, len)) {
+      if (len != std::min<size_t>(opts.buffer_bytes, bytes - got.size())) {
+        std::printf("%s: bytes=%zu direct=%d unexpected buffer length %zu\n", label, bytes,
+                    int(direct), len);
+        ::close(fd);
+        return false;
+      }
+      got.insert(got.end(), p, p + len);
+    }
+    if (reader.error()) {
+      std::printf("%s: bytes=%zu read error %s\n", label, bytes, std::strerror(reader.error()));
+      ::close(fd);
+      return false;
+    }
+  }
+  ::close(fd);
+  if (got != data) {
+    std::printf("%s: bytes=%zu direct=%d content mismatch\n", label, bytes, int(direct));
+    return false;
+  }
+  return true;
+}
+
+bool check_write(Backend backend, bool direct, size_t bytes) {
+  const char* label = backend == Backend::Uring ? "uring" : "threads";
+  std::mt19937_64 rng(~bytes);
+  std::vector<uint8_t> data(bytes);
+  for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+  TempFile f;
+  AsyncOptions opts;
+  opts.buffer_bytes = 8192;
+  opts.depth = 2;
+  opts.direct = direct;
+  opts.backend = backend;
+  {
+    neon_io::AsyncWriter writer(f.fd, opts);
+    for (size_t off = 0; off < bytes; off += writer.capacity()) {
+      const size_t n = std::min(writer.capacity(), bytes - off);
+      std::memcpy(writer.buffer(), data.data() + off, n);
+      writer.submit(n);
+    }
+    if (!writer.finish()) {
+      std::printf("%s: bytes=%zu write error %s\n", label, bytes, std::strerror(writer.error()));
+      return false;
+    }
+  }
+  struct stat st;
+  ::fstat(f.fd, &st);
+  std::vector<uint8_t> back(bytes);
+  if (static_cast<size_t>(st.st_size) != bytes ||
+      ::pread(f.fd, back.data(), bytes, 0) != static_cast<ssize_t>(bytes) || back != data) {
+    std::printf("%s: bytes=%zu direct=%d file size %lld / content mismatch\n", label, bytes,
+                int(direct), static_cast<long long>(st.st_size));
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  {
+    neon_io::IoQueue q(Backend::Auto, 4);
+    std::printf("auto backend: %s\n", q.name());
+  }
+  const size_t sizes[] = {0, 8, 4096, 8192, 8192 * 5, 8192 * 7 + 4096 + 24};
+  for (Backend backend : {Backend::Uring, Backend::Threads}) {
+    for (bool direct : {false, true}) {
+      for (size_t bytes : sizes) {
+        if (!check_read(backend, direct, bytes)) return 1;
+        if (!check_write(backend, direct, bytes)) return 1;
+      }
+    }
+  }
+  std::printf("OK\n");
+  return 0;
+}
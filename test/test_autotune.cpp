@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "autotune.hpp"
+#include "datasets.hpp"
+#include "prime8.h"
+#include "simd_fast.hpp"
+#include "topology.hpp"
+
+namespace {
+
+// Every tuning against the default kernel at one offset and count.
+bool check_tunings(const char* label, const uint64_t* values, size_t n) {
+  const size_t bytes = (n + 7) / 8;
+  std::vector<uint8_t> want(bytes + 8, 0);
+  neon_wheel::filter_stream_u64_wheel_bitmap(values, want.data(), n);
+  for (unsigned steps : {1u, 2u, 4u}) {
+    for (unsigned prefetch : {0u, 64u, 512u}) {
+      for (bool early_out : {false, true}) {
+        const neon_wheel::WheelTuning t{steps, prefetch, early_out};
+        std::vector<uint8_t> got(bytes + 8, 0xA5);
+        neon_wheel::filter_stream_u64_wheel_bitmap_tuned(t, values, got.data(), n);
+        if (std::memcmp(want.data(), got.data(), bytes) != 0) {
+          std::printf("%s: n=%zu steps=%u prefetch=%u early_out=%d differs\n", label, n, steps,
+                      prefetch, early_out ? 1 : 0);
+          return false;
+        }
+        for (size_t i = bytes; i < got.size(); ++i) {
+          if (got[i] != 0xA5) {
+            std::printf("%s: n=%zu steps=%u written past the bitmap\n", label, n, steps);
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  const char* sets[] = {"mixed", "dense", "composite80", "primes32"};
+  for (const char* name : sets) {
+    std::vector<uint64_t> values(5000);
+    neon_data::generate(*neon_data::find(name), values.data(), values.size(), 11);
+    for (size_t n = 0; n <= 200; ++n) {
+      if (!check_tunings(name, values.data(), n) || !check_tunings(name, values.data() + 1, n))
+        return 1;
+    }
+    if (!check_tunings(name, values.data(), values.size())) return 1;
+  }
+
+  // Round trip, then the same file as the process's profile. The profile is
+  // read once, on first use, so PRIME8_PROFILE is set before any filter call.
+  const std::string path = "test_autotune.profile";
+  neon_tune::Profile p;
+  p.cpu = neon_parallel::cpu_model();
+  p.dataset = "mixed";
+  p.n = 4096;
+  p.date = "2025-01-01T00:00:00Z";
+  p.wheel = {4, 128, true};
+  if (!neon_tune::write_profile(path, p)) {
+    std::printf("cannot write %s\n", path.c_str());
+    return 1;
+  }
+  neon_tune::Profile q;
+  std::string error;
+  if (!neon_tune::read_profile(path, q, error) || q.cpu != p.cpu || q.n != p.n ||
+      q.wheel.steps != 4 || q.wheel.prefetch != 128 || !q.wheel.early_out) {
+    std::printf("profile round trip failed: %s\n", error.c_str());
+    return 1;
+  }
+
+  // Another CPU's profile, and one with settings out of range.
+  neon_tune::Profile other = p;
+  other.cpu = "some other cpu";
+  other.wheel = {3, 64, false};
+  neon_tune::write_profile(path + ".bad", other);
+  if (neon_tune::read_profile(path + ".bad", q, error)) {
+    std::printf("accepted wheel_steps=3\n");
+    return 1;
+  }
+  std::remove((path + ".bad").c_str());
+
+  setenv("PRIME8_PROFILE", path.c_str(), 1);
+  const std::string status = prime8_profile();
+  if (status != "loaded " + path || neon_tune::active().wheel.steps != 4) {
+    std::printf("profile not loaded: %s\n", status.c_str());
+    return 1;
+  }
+
+  // The C API runs wheel30 under it with unchanged results.
+  std::vector<uint64_t> values(100000);
+  neon_data::generate(*neon_data::find("mixed"), values.data(), values.size(), 5);
+  std::vector<uint8_t> want((values.size() + 7) / 8), got(want.size());
+  neon_wheel::filter_stream_u64_wheel_bitmap(values.data(), want.data(), values.size());
+  if (prime8_filter_bitmap(PRIME8_WHEEL30, values.data(), values.size(), got.data(), 0) !=
+          PRIME8_OK ||
+      want != got) {
+    std::printf("prime8_filter_bitmap differs under the profile\n");
+    return 1;
+  }
+  std::remove(path.c_str());
+
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+
+namespace {
+
+using neon_block_sieve::Layout;
+
+bool survives(uint64_t n, const std::vector<uint32_t>& primes) {
+  if (n > 0xffffffffu) return false;
+  for (uint32_t p : {2u, 3u, 5u}) {
+    if (n != p && n % p == 0) return false;
+  }
+  for (uint32_t p : primes) {
+    if (n != p && n % p == 0) return false;
+  }
+  return true;
+}
+
+bool check(const char* label, const std::vector<uint64_t>& values,
+           const std::vector<uint32_t>& primes, Layout layout) {
+  const size_t n = values.size();
+  std::vector<uint8_t> bitmap((n + 7) / 8 + 1, 0xA5);
+  neon_block_sieve::filter_stream_u64_sieve_bitmap(values.data(), bitmap.data(), n,
+                                                   primes.data(), primes.size(), layout);
+  for (size_t i = 0; i < n; ++i) {
+    const bool got = (bitmap[i >> 3] >> (i & 7)) & 1;
+    if (got != survives(values[i], primes)) {
+      std::printf("%s: n=%zu index %zu value %llu got %d\n", label, n, i,
+                  static_cast<unsigned long long>(values[i]), int(got));
+      return false;
+    }
+  }
+  if (n % 8 && (bitmap[n / 8] >> (n % 8)) != 0) {
+    std::printf("%s: stray bits past the end (n=%zu)\n", label, n);
+    return false;
+  }
+  if (bitmap[(n + 7) / 8] != 0xA5) {
+    std::printf("%s: wrote past the end (n=%zu)\n", label, n);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  uint64_t seed = 30;
+  const std::vector<uint32_t> default_set = {7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+  std::vector<uint32_t> large_set;
+  for (uint32_t p = 7; p < 400; p += 2) {
+    bool prime = true;
+    for (uint32_t d = 3; d * d <= p; d += 2) prime &= (p % d != 0);
+    if (prime) large_set.push_back(p);
+  }
+
+  constexpr size_t B = neon_block_sieve::kSieveBlock;
+  for (size_t n : {size_t(0), size_t(1), size_t(15), size_t(16), size_t(17), B - 1, B, B + 1,
+                   3 * B + 45}) {
+    // Edge values and multiples of 7 * 397 among the shared uniform32 set.
+    std::vector<uint64_t> values(n);
+    neon_data::generate(*neon_data::find("uniform32"), values.data(), n, ++seed);
+    for (size_t i = 0; i < n; ++i) {
+      switch (i % 6) {
+        case 0: values[i] = i; break;
+        case 1: values[i] = 0xffffffffull - i; break;
+        case 2: values[i] = 0x100000000ull + i; break;
+        case 3: values[i] = 7ull * 397 * (1 + (values[i] & 0xffff)); break;
+        default: break;
+      }
+    }
+    for (Layout layout : {Layout::Auto, Layout::LaneMajor, Layout::PrimeMajor}) {
+      if (!check("default-set", values, default_set, layout)) return 1;
+      if (!check("large-set", values, large_set, layout)) return 1;
+    }
+
+    // The default overload matches the lane-major wheel kernel bit for bit.
+    std::vector<uint8_t> ours((n + 7) / 8, 0), wheel((n + 7) / 8, 0);
+    neon_block_sieve::filter_stream_u64_sieve_bitmap(values.data(), ours.data(), n);
+    neon_wheel::filter_stream_u64_wheel_bitmap(values.data(), wheel.data(), n);
+    if (ours != wheel) {
+      std::printf("default overload differs from neon_wheel (n=%zu)\n", n);
+      return 1;
+    }
+  }
+
+  if (neon_block_sieve::choose_layout(default_set.size()) != Layout::LaneMajor ||
+      neon_block_sieve::choose_layout(large_set.size()) != Layout::PrimeMajor) {
+    std::printf("choose_layout thresholds wrong\n");
+    return 1;
+  }
+
+  std::puts("OK");
+  return 0;
+}
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "buffer.hpp"
+#include "simd_fast.hpp"
+
+namespace {
+
+bool aligned(const void* p) { return reinterpret_cast<uintptr_t>(p) % neon_mem::kAlign == 0; }
+
+// Every size class (heap below kHugePage, mapped above) in every mode comes
+// back 64-byte aligned and writable end to end.
+bool check_allocate() {
+  const neon_mem::HugePages modes[] = {neon_mem::HugePages::Off,
+                                       neon_mem::HugePages::Transparent,
+                                       neon_mem::HugePages::Explicit};
+  const size_t sizes[] = {1, 63, 4096, neon_mem::kHugePage - 1, neon_mem::kHugePage,
+                          neon_mem::kHugePage * 3 + 5};
+  for (auto mode : modes) {
+    for (size_t bytes : sizes) {
+      auto* p = static_cast<uint8_t*>(neon_mem::allocate(bytes, mode));
+      if (!aligned(p)) {
+        std::printf("allocate(%zu, %s) misaligned\n", bytes, neon_mem::huge_pages_name(mode));
+        return false;
+      }
+      std::memset(p, 0x5A, bytes);
+      neon_mem::deallocate(p, bytes);
+    }
+  }
+  return true;
+}
+
+// resize() on a neon_mem::vector must not zero-fill, but (n, 0) must.
+bool check_vector() {
+  neon_mem::vector<uint8_t> v(1 << 16, 0);
+  if (!aligned(v.data())) return false;
+  for (uint8_t b : v) {
+    if (b) return false;
+  }
+  neon_mem::vector<uint64_t> big(neon_mem::kHugePage / 8 + 1);
+  if (!aligned(big.data())) return false;
+  big.back() = 7;
+  return big.back() == 7;
+}
+
+// A pass that outgrows the arena chains blocks; after reset() the same pass
+// fits in one block and hands out the same addresses again.
+bool check_arena() {
+  neon_mem::Arena arena(1024);
+  uint8_t* first[4];
+  for (int pass = 0; pass < 3; ++pass) {
+    arena.reset();
+    for (int i = 0; i < 4; ++i) {
+      uint8_t* p = arena.alloc<uint8_t>(100000 + i);
+      if (!aligned(p)) {
+        std::printf("arena block misaligned\n");
+        return false;
+      }
+      std::memset(p, i, 100000 + i);
+      if (pass == 1) first[i] = p;
+      if (pass == 2 && p != first[i]) {
+        std::printf("arena pass %d alloc %d moved after reset\n", pass, i);
+        return false;
+      }
+    }
+  }
+  if (arena.used() < 4 * 100000) return false;
+  return arena.capacity() >= arena.used();
+}
+
+// Kernels read and write through arena memory like any other buffer.
+bool check_kernel_in_arena() {
+  const size_t n = 4099;
+  neon_mem::Arena arena;
+  uint64_t* in = arena.alloc<uint64_t>(n);
+  uint8_t* a = arena.alloc<uint8_t>((n + 7) / 8);
+  for (size_t i = 0; i < n; ++i) in[i] = i * 2654435761u & 0xffffffffu;
+  std::memset(a, 0, (n + 7) / 8);
+  neon_fast::filter_stream_u64_barrett16_bitmap(in, a, n);
+  neon_mem::vector<uint8_t> b((n + 7) / 8, 0);
+  neon_fast::filter_stream_u64_barrett16_bitmap(in, b.data(), n);
+  return std::memcmp(a, b.data(), b.size()) == 0;
+}
+
+} // namespace
+
+int main() {
+  bool ok = check_allocate();
+  ok = check_vector() && ok;
+  ok = check_arena() && ok;
+  ok = check_kernel_in_arena() && ok;
+  std::puts(ok ? "OK" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+#include "datasets.hpp"
+#include "prime8.h"
+
+namespace {
+
+// The C ABI comes from libprime8.so alone, so only exported symbols are
+// reachable through it and the references are independent scalar code. The
+// static library is linked only for the shared datasets (datasets.hpp).
+bool survives(uint64_t n) {
+  if (n > 0xffffffffu) return false;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53}) {
+    if (n != p && n % p == 0) return false;
+  }
+  return true;
+}
+
+bool reference_is_prime(uint64_t n) {
+  if (n < 2) return false;
+  if (n % 2 == 0) return n == 2;
+  for (uint64_t d = 3; d * d <= n; d += 2) {
+    if (n % d == 0) return false;
+  }
+  return true;
+}
+
+bool check(int kernel, const std::vector<uint64_t>& values, unsigned flags) {
+  const size_t n = values.size();
+  std::vector<uint8_t> expect((n + 7) / 8 + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const uint64_t v = values[i];
+    const bool keep = kernel == PRIME8_PRIME ? reference_is_prime(v) : survives(v);
+    if (keep) expect[i >> 3] |= uint8_t(1u << (i & 7));
+  }
+  std::vector<uint64_t> survivors;
+  for (size_t i = 0; i < n; ++i) {
+    if ((expect[i >> 3] >> (i & 7)) & 1) survivors.push_back(values[i]);
+  }
+  const char* name = prime8_kernel_name(kernel);
+
+  std::vector<uint8_t> bitmap((n + 7) / 8 + 1, 0xA5);
+  if (prime8_filter_bitmap(kernel, values.data(), n, bitmap.data(), flags) != PRIME8_OK ||
+      std::memcmp(bitmap.data(), expect.data(), (n + 7) / 8) != 0 ||
+      bitmap[(n + 7) / 8] != 0xA5) {
+    std::printf("%s: filter_bitmap mismatch (n=%zu flags=%u)\n", name, n, flags);
+    return false;
+  }
+  const int64_t c = prime8_count(kernel, values.data(), n, flags);
+  if (c != static_cast<int64_t>(survivors.size())) {
+    std::printf("%s: count %lld, expected %zu (n=%zu flags=%u)\n", name,
+                static_cast<long long>(c), survivors.size(), n, flags);
+    return false;
+  }
+  std::vector<uint64_t> out(n + 1, 0);
+  const int64_t k = prime8_compact(kernel, values.data(), n, out.data(), flags);
+  std::vector<uint64_t> inplace = values;
+  const int64_t k2 = prime8_compact(kernel, inplace.data(), n, inplace.data(), flags);
+  if (k != c || k2 != c || out[n] != 0 ||
+      !std::equal(survivors.begin(), survivors.end(), out.begin()) ||
+      !std::equal(survivors.begin(), survivors.end(), inplace.begin())) {
+    std::printf("%s: compact mismatch (n=%zu flags=%u)\n", name, n, flags);
+    return false;
+  }
+  inplace = values;
+  const int64_t k3 = prime8_filter_inplace(kernel, inplace.data(), n, flags);
+  if (k3 != c || !std::equal(survivors.begin(), survivors.end(), inplace.begin())) {
+    std::printf("%s: filter_inplace mismatch (n=%zu flags=%u)\n", name, n, flags);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (prime8_abi_version() != PRIME8_ABI_VERSION) {
+    std::printf("ABI version %d, header says %d\n", prime8_abi_version(), PRIME8_ABI_VERSION);
+    return 1;
+  }
+
+  // Spans the serial (16384) and parallel (1 << 20) block sizes, with tails.
+  // The trial-division reference for PRIME8_PRIME is too slow for mixed's
+  // values far above 2^32, so that kernel runs on semiprimes only.
+  uint64_t seed = 34;
+  for (const char* name : {"mixed", "semiprimes"}) {
+    const bool wide = std::strcmp(name, "mixed") == 0;
+    for (size_t n : {size_t(0), size_t(1), size_t(63), size_t(16384), size_t(16384 * 3 + 5),
+                     (size_t(1) << 20) + 77}) {
+      std::vector<uint64_t> values(n);
+      neon_data::generate(*neon_data::find(name), values.data(), n, ++seed);
+      for (int kernel : {PRIME8_WHEEL30, PRIME8_WHEEL210, PRIME8_BARRETT16, PRIME8_SIEVE,
+                         PRIME8_PRIME}) {
+        if (kernel == PRIME8_PRIME && (wide || n > 65536)) continue;
+        for (unsigned flags : {0u, PRIME8_PARALLEL, PRIME8_NONTEMPORAL,
+                               PRIME8_PARALLEL | PRIME8_NONTEMPORAL}) {
+          if (!check(kernel, values, flags)) return 1;
+        }
+      }
+    }
+  }
+
+  // Counts reuse one block bitmap per call: a short count after a full block
+  // of survivors must not pick up that block's bits past its own length.
+  const std::vector<uint64_t> primes(16384, 101), fours(13, 4);
+  for (int kernel = 0; prime8_kernel_name(kernel); ++kernel) {
+    for (size_t n : {size_t(3), size_t(5), size_t(13)}) {
+      prime8_count(kernel, primes.data(), primes.size(), 0);
+      const int64_t c = prime8_count(kernel, fours.data(), n, 0);
+      if (c != 0) {
+        std::printf("%s: count %lld of %zu fours after a block of primes\n",
+                    prime8_kernel_name(kernel), static_cast<long long>(c), n);
+        return 1;
+      }
+    }
+  }
+
+  const uint64_t mixed[] = {0, 1, 2, 97, 561, 4294967291ull, 2305843009213693951ull,
+                            18446744073709551557ull, 18446744073709551615ull};
+  const uint8_t want[] = {0, 0, 1, 1, 0, 1, 1, 1, 0};
+  uint8_t got[9];
+  if (prime8_confirm(mixed, 9, got) != 5 || std::memcmp(got, want, 9) != 0) {
+    std::printf("confirm mismatch\n");
+    return 1;
+  }
+  for (size_t i = 0; i < 9; ++i) {
+    if (prime8_is_prime(mixed[i]) != want[i]) {
+      std::printf("is_prime(%llu) mismatch\n", static_cast<unsigned long long>(mixed[i]));
+      return 1;
+    }
+  }
+
+  uint8_t byte = 0;
+  if (prime8_filter_bitmap(99, mixed, 9, &byte, 0) != PRIME8_EKERNEL ||
+      prime8_count(-1, mixed, 9, 0) != PRIME8_EKERNEL ||
+      prime8_compact(PRIME8_WHEEL30, nullptr, 9, nullptr, 0) != PRIME8_ENULL ||
+      prime8_filter_inplace(PRIME8_WHEEL30, nullptr, 9, 0) != PRIME8_ENULL ||
+      prime8_filter_inplace(99, nullptr, 0, 0) != PRIME8_EKERNEL ||
+      prime8_confirm(nullptr, 0, nullptr) != 0 ||
+      prime8_kernel_name(99) != nullptr) {
+    std::printf("argument checks failed\n");
+    return 1;
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+std::vector<uint64_t> make(const neon_data::Dataset& d, size_t n, uint64_t seed) {
+  std::vector<uint64_t> v(n);
+  neon_data::generate(d, v.data(), n, seed);
+  return v;
+}
+
+uint64_t smallest_factor(uint64_t v) {
+  for (uint64_t p = 2; p * p <= v; ++p) {
+    if (v % p == 0) return p;
+  }
+  return v;
+}
+
+// Property every value of the named dataset must have; nullptr if it has
+// only a statistical shape (checked separately).
+const char* violates(const std::string& name, uint64_t v, uint64_t prev, size_t i) {
+  if (name == "uniform32" && v > 0xffffffffu) return "above 2^32";
+  if (name == "odd32" && (v > 0xffffffffu || v % 2 == 0)) return "not an odd u32";
+  if (name == "mult6" && (v > 0xffffffffu || v % 6)) return "not a multiple of 6";
+  if (name == "rsa32" && (v < 0xc0000000u || v > 0xffffffffu || v % 2 == 0)) return "not rsa-shaped";
+  if (name == "primes32" && (v < 0x80000000u || v > 0xffffffffu || !neon_mr::is_prime_64(v))) {
+    return "not a prime in [2^31, 2^32)";
+  }
+  if (name == "semiprimes" && i % 64 == 0) {  // trial division is slow; sample
+    const uint64_t p = smallest_factor(v);
+    if (p <= (1u << 15) || p >= (1u << 16) || v / p <= (1u << 15) || v / p >= (1u << 16) ||
+        !neon_mr::is_prime_64(v / p)) {
+      return "not a product of two 16-bit primes";
+    }
+  }
+  if (name == "wheel30" && (v % 2 == 0 || v % 3 == 0 || v % 5 == 0)) return "not coprime to 30";
+  if (name == "ap_odd" && (v % 2 == 0 || (i && v != prev + 2))) return "not consecutive odds";
+  if (name == "dense" && i && v != prev + 1) return "not consecutive";
+  return nullptr;
+}
+
+bool check_properties(const neon_data::Dataset& d, const std::vector<uint64_t>& v) {
+  for (size_t i = 0; i < v.size(); ++i) {
+    if (const char* why = violates(d.name, v[i], i ? v[i - 1] : 0, i)) {
+      std::printf("%s[%zu] = %llu: %s\n", d.name, i, static_cast<unsigned long long>(v[i]), why);
+      return false;
+    }
+    if (d.sorted && i && v[i] < v[i - 1]) {
+      std::printf("%s: not sorted at %zu\n", d.name, i);
+      return false;
+    }
+  }
+  if (std::strcmp(d.name, "composite80") == 0 && v.size() >= 10000) {
+    size_t hits = 0;
+    for (uint64_t x : v) hits += x % 2 == 0 || x % 3 == 0 || x % 5 == 0;
+    // 80% by construction plus 20% * 22/30 of the uniform part: 0.947.
+    const double frac = double(hits) / v.size();
+    if (frac < 0.92 || frac > 0.96) {
+      std::printf("composite80: %.3f divisible by 2/3/5\n", frac);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  constexpr size_t C = neon_data::kGenChunk;
+  const size_t sizes[] = {0, 1, 7, C - 1, C, C + 1, 3 * C + 11};
+
+  if (!neon_data::find("uniform32") || neon_data::find("nope")) return 1;
+
+  for (const neon_data::Dataset& d : neon_data::all()) {
+    for (size_t n : sizes) {
+      neon_parallel::set_thread_count(1);
+      const auto serial = make(d, n, 42);
+      std::vector<uint64_t> direct(n);
+      neon_data::generate_serial(d, direct.data(), n, 42);
+      neon_parallel::set_thread_count(3);
+      const auto pooled = make(d, n, 42);
+
+      // Same values whatever the thread count or entry point.
+      if (serial != direct || serial != pooled) {
+        std::printf("%s: n=%zu depends on the thread count\n", d.name, n);
+        return 1;
+      }
+      // A prefix of a longer set is the shorter set.
+      if (n && !std::equal(serial.begin(), serial.end(), make(d, n + C, 42).begin())) {
+        std::printf("%s: n=%zu is not a prefix of n+%zu\n", d.name, n, C);
+        return 1;
+      }
+      if (!check_properties(d, serial)) return 1;
+    }
+    // Another seed gives another set.
+    if (make(d, 1000, 1) == make(d, 1000, 2)) {
+      std::printf("%s: seed has no effect\n", d.name);
+      return 1;
+    }
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
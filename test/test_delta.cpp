@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "delta.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+// `n` values of a shared dataset (datasets.hpp).
+std::vector<uint64_t> dataset(const char* name, size_t n, uint64_t seed) {
+  std::vector<uint64_t> v(n);
+  neon_data::generate(*neon_data::find(name), v.data(), n, seed);
+  return v;
+}
+
+enum class Shape { Wheel, Sparse, Dense, Flat, Wide, Straddle };
+
+// Wheel: wheel-30 candidates (3-bit gaps); Sparse: sorted uniform 32-bit;
+// Dense: consecutive integers (1-bit gaps); Flat: runs of equal values
+// (width 0); Wide: gaps past 2^30 (raw blocks); Straddle: a dense run
+// crossing 2^32. The synthetic shapes draw their randomness from uniform32.
+std::vector<uint64_t> make_values(size_t n, Shape shape, uint64_t seed) {
+  switch (shape) {
+    case Shape::Wheel: return dataset("wheel30", n, seed);
+    case Shape::Dense: return dataset("dense", n, seed);
+    case Shape::Sparse: {
+      std::vector<uint64_t> v = dataset("uniform32", n, seed);
+      std::sort(v.begin(), v.end());
+      return v;
+    }
+    default: break;
+  }
+  const std::vector<uint64_t> r = dataset("uniform32", n + 1, seed);
+  std::vector<uint64_t> v(n);
+  uint64_t x = r[n] & 0xffffff;
+  for (size_t i = 0; i < n; ++i) {
+    switch (shape) {
+      case Shape::Flat: v[i] = x + i / 300; break;
+      case Shape::Wide: v[i] = x += (i % 200 == 77) ? (uint64_t(1) << 31) + r[i] % 5 : r[i] % 64; break;
+      default: v[i] = 0xffffffffull - n / 2 + i; break;
+    }
+  }
+  return v;
+}
+
+std::vector<uint8_t> encode(const std::vector<uint64_t>& values) {
+  std::vector<uint8_t> buf(neon_delta::encoded_bound(values.size()));
+  buf.resize(neon_delta::encode(values.data(), values.size(), buf.data()));
+  return buf;
+}
+
+bool check(const std::vector<uint64_t>& values, const char* what) {
+  const size_t n = values.size();
+  const auto buf = encode(values);
+  neon_delta::View view;
+  if (buf.empty() || neon_delta::open(buf.data(), buf.size(), view) || view.bytes != buf.size() ||
+      view.count != n) {
+    std::printf("%s: n=%zu did not encode/open\n", what, n);
+    return false;
+  }
+
+  std::vector<uint64_t> decoded(n + 1, 0xDEADBEEF);
+  neon_delta::decode(view, decoded.data());
+  if (!std::equal(values.begin(), values.end(), decoded.begin()) || decoded[n] != 0xDEADBEEF) {
+    std::printf("%s: n=%zu round trip failed\n", what, n);
+    return false;
+  }
+
+  // The fused kernel must agree bit for bit with the raw wheel kernel.
+  const size_t bytes = (n + 7) / 8;
+  std::vector<uint8_t> want(bytes + 1, 0), serial(bytes + 1, 0xAA), pool(bytes + 1, 0xAA);
+  neon_wheel::filter_stream_u64_wheel_bitmap(values.data(), want.data(), n);
+  if (n % 8) want[bytes - 1] &= uint8_t((1u << (n % 8)) - 1);
+  size_t kept = 0;
+  for (size_t i = 0; i < bytes; ++i) kept += __builtin_popcount(want[i]);
+
+  const size_t s = neon_delta::filter_wheel_bitmap(view, serial.data());
+  const size_t p = neon_delta::parallel_filter_wheel_bitmap(view, pool.data());
+  if (s != kept || p != kept || !std::equal(want.begin(), want.begin() + bytes, serial.begin()) ||
+      !std::equal(want.begin(), want.begin() + bytes, pool.begin()) || serial[bytes] != 0xAA ||
+      pool[bytes] != 0xAA) {
+    std::printf("%s: n=%zu filter mismatch (kept %zu/%zu, expected %zu)\n", what, n, s, p, kept);
+    return false;
+  }
+  return true;
+}
+
+bool check_rejects(uint64_t seed) {
+  std::vector<uint64_t> values = make_values(1000, Shape::Wheel, seed);
+  const auto good = encode(values);
+  neon_delta::View view;
+
+  // Unsorted input, inside a block and across a block boundary.
+  for (size_t at : {size_t(5), size_t(128)}) {
+    auto bad = values;
+    std::swap(bad[at - 1], bad[at]);
+    std::vector<uint8_t> buf(neon_delta::encoded_bound(bad.size()));
+    if (neon_delta::encode(bad.data(), bad.size(), buf.data()) != 0) {
+      std::printf("encode accepted unsorted input at %zu\n", at);
+      return false;
+    }
+  }
+
+  // Every truncation fails cleanly.
+  for (size_t len = 0; len < good.size(); len += 7) {
+    if (!neon_delta::open(good.data(), len, view)) {
+      std::printf("open accepted %zu of %zu bytes\n", len, good.size());
+      return false;
+    }
+  }
+
+  auto corrupt = [&](size_t offset, uint8_t value, const char* what) {
+    auto bad = good;
+    bad[offset] = value;
+    if (neon_delta::open(bad.data(), bad.size(), view)) return true;
+    std::printf("open accepted %s\n", what);
+    return false;
+  };
+  // A bare file header claiming `count` values in `blocks` blocks.
+  auto forged = [&](uint64_t count, uint64_t blocks, const char* what) {
+    neon_delta::FileHeader fh;
+    std::memcpy(&fh, good.data(), sizeof(fh));
+    fh.count = count;
+    fh.blocks = blocks;
+    std::vector<uint8_t> bad(sizeof(fh));
+    std::memcpy(bad.data(), &fh, sizeof(fh));
+    if (neon_delta::open(bad.data(), bad.size(), view)) return true;
+    std::printf("open accepted %s\n", what);
+    return false;
+  };
+  const size_t block0 = sizeof(neon_delta::FileHeader);
+  return corrupt(0, 'X', "bad magic") && corrupt(4, 9, "bad version") &&
+         corrupt(16, 0xff, "bad block count") &&
+         corrupt(block0 + 8, 3, "short middle block") &&
+         corrupt(block0 + 10, 31, "width 31") && corrupt(block0 + 10, 63, "width 63") &&
+         forged(~uint64_t(0), 0, "count 2^64-1 in 0 blocks") &&
+         forged(uint64_t(1) << 62, uint64_t(1) << 55, "2^55 blocks in an empty file");
+}
+
+} // namespace
+
+int main() {
+  uint64_t seed = 40;
+  if (!check_rejects(seed)) return 1;
+
+  constexpr size_t B = neon_delta::kBlock;
+  constexpr size_t C = neon_delta::kChunkBlocks * B;
+  const size_t sizes[] = {0, 1, 2, 5, B - 1, B, B + 1, 7 * B + 3, C, C + 9, 3 * C + 250};
+  for (unsigned threads : {1u, 3u}) {
+    neon_parallel::set_thread_count(threads);
+    for (size_t n : sizes) {
+      ++seed;
+      if (!check(make_values(n, Shape::Wheel, seed), "wheel") ||
+          !check(make_values(n, Shape::Sparse, seed), "sparse") ||
+          !check(make_values(n, Shape::Dense, seed), "dense") ||
+          !check(make_values(n, Shape::Flat, seed), "flat") ||
+          !check(make_values(n, Shape::Wide, seed), "wide") ||
+          !check(make_values(n, Shape::Straddle, seed), "straddle")) {
+        return 1;
+      }
+    }
+  }
+
+  // Widths 0..30 each, plus 31 (first raw width).
+  for (unsigned w = 0; w <= neon_delta::kMaxPackedWidth + 1; ++w) {
+    const std::vector<uint64_t> r = dataset("uniform32", 3 * B + 17, ++seed);
+    std::vector<uint64_t> v(r.size());
+    uint64_t x = 1000;
+    for (size_t i = 0; i < v.size(); ++i) {
+      v[i] = x;
+      x += w ? (uint64_t(1) << (w - 1)) + r[i] % (uint64_t(1) << (w - 1)) : 0;
+    }
+    if (!check(v, "width")) return 1;
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+
+namespace {
+
+// Plain trial division; slow but independent of the library's Miller-Rabin.
+bool reference_is_prime(uint64_t n) {
+  if (n < 2) return false;
+  if (n % 2 == 0) return n == 2;
+  for (uint64_t d = 3; d * d <= n; d += 2) {
+    if (n % d == 0) return false;
+  }
+  return true;
+}
+
+bool check(const char* label, const std::vector<uint64_t>& values,
+           const std::vector<bool>& expected) {
+  const size_t n = values.size();
+  std::vector<uint8_t> flags(n + 1, 0xA5);
+  std::vector<uint8_t> bitmap((n + 7) / 8 + 1, 0xA5);
+  std::vector<uint64_t> list(n + 1, 0);
+
+  const size_t c_flags = neon_fused::fused_prime_flags(values.data(), flags.data(), n);
+  const size_t c_bitmap = neon_fused::fused_prime_bitmap(values.data(), bitmap.data(), n);
+  const size_t c_list = neon_fused::fused_prime_list(values.data(), list.data(), n);
+  const size_t c_count = neon_fused::fused_prime_count(values.data(), n);
+
+  size_t want = 0, k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const bool bit = (bitmap[i >> 3] >> (i & 7)) & 1;
+    if (flags[i] != expected[i] || bit != expected[i]) {
+      std::printf("%s: n=%zu index %zu value %llu flag=%u bit=%u expected=%d\n", label, n, i,
+                  static_cast<unsigned long long>(values[i]), flags[i], bit, int(expected[i]));
+      return false;
+    }
+    if (expected[i]) {
+      if (k >= c_list || list[k] != values[i]) {
+        std::printf("%s: list entry %zu wrong\n", label, k);
+        return false;
+      }
+      ++k;
+      ++want;
+    }
+  }
+  if (c_flags != want || c_bitmap != want || c_list != want || c_count != want) {
+    std::printf("%s: counts %zu/%zu/%zu/%zu expected %zu\n", label, c_flags, c_bitmap,
+                c_list, c_count, want);
+    return false;
+  }
+  if (flags[n] != 0xA5 || bitmap[(n + 7) / 8] != 0xA5) {
+    std::printf("%s: wrote past the end (n=%zu)\n", label, n);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  // Miller-Rabin against trial division, including strong pseudoprimes to
+  // small bases and 64-bit semiprimes.
+  const uint64_t mr_cases[] = {
+    0, 1, 2, 3, 4, 61, 2047, 1373653, 25326001, 3215031751ull, 4294967291ull,
+    4294967295ull, 4294967297ull, 4294967311ull, 2305843009213693951ull,
+    18446744073709551557ull, 4294967291ull * 4294967279ull, 3825123056546413051ull,
+  };
+  for (uint64_t v : mr_cases) {
+    const bool want = (v == 3825123056546413051ull || v == 4294967291ull * 4294967279ull)
+                          ? false
+                          : (v == 2305843009213693951ull || v == 18446744073709551557ull)
+                                ? true
+                                : reference_is_prime(v);
+    if (neon_mr::miller_rabin_64(v) != want) {
+      std::printf("miller_rabin_64(%llu) != %d\n", static_cast<unsigned long long>(v), int(want));
+      return 1;
+    }
+  }
+
+  // Every value below 200 000 (all small-prime edge cases) across tile sizes.
+  {
+    std::vector<uint64_t> values(200000);
+    std::vector<bool> expected(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = i;
+      expected[i] = reference_is_prime(i);
+    }
+    if (!check("sequential", values, expected)) return 1;
+  }
+
+  // Shared datasets at sizes around the tile boundary: odd 32-bit values,
+  // semiprimes (every one passes the prefilter and fails Miller-Rabin) and
+  // 32-bit values mixed with > 32-bit ones.
+  uint64_t seed = 7;
+  constexpr size_t T = neon_fused::kFusedTile;
+  for (const char* name : {"odd32", "semiprimes", "mixed"}) {
+    for (size_t n : {size_t(0), size_t(1), size_t(63), size_t(64), size_t(65), T - 1, T, T + 1,
+                     3 * T + 77}) {
+      std::vector<uint64_t> values(n);
+      neon_data::generate(*neon_data::find(name), values.data(), n, ++seed);
+      std::vector<bool> expected(n);
+      for (size_t i = 0; i < n; ++i) expected[i] = reference_is_prime(values[i]);
+      if (!check(name, values, expected)) return 1;
+    }
+  }
+
+  std::puts("OK");
+  return 0;
+}
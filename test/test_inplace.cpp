@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct Kernel {
+  const char* name;
+  neon_stream::StreamKernel bitmap;
+  size_t (*inplace)(uint64_t*, size_t);
+};
+
+const Kernel kKernels[] = {
+  {"barrett16", neon_fast::filter_stream_u64_barrett16_bitmap,
+   neon_inplace::filter_inplace_barrett16},
+  {"wheel", neon_wheel::filter_stream_u64_wheel_bitmap, neon_inplace::filter_inplace_wheel},
+  {"wheel210eff", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+   neon_inplace::filter_inplace_wheel210},
+  {"sieve",
+   static_cast<neon_stream::StreamKernel>(neon_block_sieve::filter_stream_u64_sieve_bitmap),
+   neon_inplace::filter_inplace_sieve},
+};
+
+// `n` values of a shared dataset (datasets.hpp).
+std::vector<uint64_t> make_values(const char* dataset, size_t n, uint64_t seed) {
+  std::vector<uint64_t> v(n);
+  neon_data::generate(*neon_data::find(dataset), v.data(), n, seed);
+  return v;
+}
+
+// mixed: random 32-bit with some >32-bit values; mult6: all composite (whole
+// zero bitmap words); primes32: every lane survives.
+const char* const kShapes[] = {"mixed", "mult6", "primes32"};
+
+// Survivors as read off the kernel's own bitmap.
+std::vector<uint64_t> expected(const Kernel& k, const std::vector<uint64_t>& values) {
+  const size_t n = values.size();
+  std::vector<uint8_t> bitmap((n + 7) / 8 + 1, 0);
+  k.bitmap(values.data(), bitmap.data(), n);
+  std::vector<uint64_t> keep;
+  for (size_t i = 0; i < n; ++i) {
+    if ((bitmap[i >> 3] >> (i & 7)) & 1) keep.push_back(values[i]);
+  }
+  return keep;
+}
+
+bool same(const char* what, const Kernel& k, const std::vector<uint64_t>& want,
+          const uint64_t* got, size_t got_n, size_t n) {
+  if (got_n == want.size() && std::equal(want.begin(), want.end(), got)) return true;
+  std::printf("%s %s: n=%zu kept %zu, expected %zu\n", what, k.name, n, got_n, want.size());
+  return false;
+}
+
+bool check(const Kernel& k, const std::vector<uint64_t>& values) {
+  const size_t n = values.size();
+  const auto want = expected(k, values);
+
+  std::vector<uint64_t> a = values;
+  if (!same("serial", k, want, a.data(), k.inplace(a.data(), n), n)) return false;
+
+  // Unaligned start: the 4-lane loads and stores must not assume alignment.
+  std::vector<uint64_t> b(n + 1);
+  std::copy(values.begin(), values.end(), b.begin() + 1);
+  if (!same("unaligned", k, want, b.data() + 1,
+            neon_inplace::filter_inplace(k.bitmap, b.data() + 1, n), n)) {
+    return false;
+  }
+
+  std::vector<uint64_t> c = values;
+  if (!same("parallel", k, want, c.data(),
+            neon_parallel::parallel_filter_inplace(k.bitmap, c.data(), n), n)) {
+    return false;
+  }
+  return true;
+}
+
+// left_pack into a separate buffer never writes past dst + count.
+bool check_left_pack(uint64_t seed) {
+  for (size_t n : {size_t(0), size_t(1), size_t(3), size_t(4), size_t(5), size_t(64),
+                   size_t(67), size_t(200)}) {
+    const std::vector<uint64_t> src = make_values("uniform64", n, seed);
+    const std::vector<uint64_t> bits = make_values("uniform64", (n + 7) / 8 + 1, seed + 1);
+    std::vector<uint8_t> bitmap(bits.size());
+    for (size_t i = 0; i < bits.size(); ++i) bitmap[i] = static_cast<uint8_t>(bits[i]);
+    std::vector<uint64_t> dst(n + 4, 0xDEADBEEF);
+    const size_t k = neon_inplace::left_pack(src.data(), bitmap.data(), n, dst.data());
+    size_t j = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (((bitmap[i >> 3] >> (i & 7)) & 1) && (j >= k || dst[j++] != src[i])) {
+        std::printf("left_pack: wrong survivor at %zu (n=%zu)\n", i, n);
+        return false;
+      }
+    }
+    if (j != k) return false;
+    for (size_t i = n; i < n + 4; ++i) {
+      if (dst[i] != 0xDEADBEEF) {
+        std::printf("left_pack: wrote past count (n=%zu)\n", n);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  uint64_t seed = 39;
+  if (!check_left_pack(seed)) return 1;
+
+  constexpr size_t T = neon_inplace::kInplaceTile;
+  constexpr size_t C = neon_parallel::kParallelChunk;
+  const size_t sizes[] = {0, 1, 3, 4, 7, 63, 64, 65, T - 1, T, T + 5, 3 * T + 130,
+                          C + 1, 3 * C + 77};
+  for (unsigned threads : {1u, 3u, 4u}) {
+    neon_parallel::set_thread_count(threads);
+    for (size_t n : sizes) {
+      for (const char* shape : kShapes) {
+        const auto values = make_values(shape, n, ++seed);
+        for (const Kernel& k : kKernels) {
+          if (!check(k, values)) return 1;
+        }
+      }
+    }
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
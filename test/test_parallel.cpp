@@ -0,0 +1,265 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "buffer.hpp"
+#include "datasets.hpp"
+#include "simd_fast.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+using StreamKernel = void (*)(const uint64_t*, uint8_t*, size_t);
+
+struct KernelPair {
+  const char* name;
+  StreamKernel serial;
+  StreamKernel parallel;
+  bool bitmap;
+};
+
+const KernelPair kKernels[] = {
+  {"barrett16", neon_fast::filter_stream_u64_barrett16,
+   neon_parallel::parallel_filter_stream_u64_barrett16, false},
+  {"barrett16-bitmap", neon_fast::filter_stream_u64_barrett16_bitmap,
+   neon_parallel::parallel_filter_stream_u64_barrett16_bitmap, true},
+  {"ultra", neon_ultra::filter_stream_u64_barrett16_ultra,
+   neon_parallel::parallel_filter_stream_u64_barrett16_ultra, false},
+  {"wheel", neon_wheel::filter_stream_u64_wheel,
+   neon_parallel::parallel_filter_stream_u64_wheel, false},
+  {"wheel-bitmap", neon_wheel::filter_stream_u64_wheel_bitmap,
+   neon_parallel::parallel_filter_stream_u64_wheel_bitmap, true},
+  {"wheel210eff-bitmap", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap,
+   neon_parallel::parallel_filter_stream_u64_wheel210_efficient_bitmap, true},
+};
+
+// The shared "mixed" dataset (datasets.hpp), generated serially so the pool
+// under test runs only the kernels.
+std::vector<uint64_t> make_mixed_values(size_t n, uint64_t seed) {
+  std::vector<uint64_t> values(n);
+  neon_data::generate_serial(*neon_data::find("mixed"), values.data(), n, seed);
+  return values;
+}
+
+// Output buffers start with the same junk pattern so partial tail bytes
+// must also match exactly.
+bool check_identical(const KernelPair& k, const std::vector<uint64_t>& values) {
+  const size_t n = values.size();
+  const size_t out_size = k.bitmap ? (n + 7) / 8 : n;
+  std::vector<uint8_t> serial(out_size + 1, 0xA5), parallel(out_size + 1, 0xA5);
+
+  k.serial(values.data(), serial.data(), n);
+  k.parallel(values.data(), parallel.data(), n);
+
+  if (std::memcmp(serial.data(), parallel.data(), serial.size()) != 0) {
+    for (size_t i = 0; i < serial.size(); ++i) {
+      if (serial[i] != parallel[i]) {
+        std::printf("%s: mismatch n=%zu threads=%u byte=%zu serial=%02x parallel=%02x\n",
+                    k.name, n, neon_parallel::thread_count(), i,
+                    static_cast<unsigned>(serial[i]), static_cast<unsigned>(parallel[i]));
+        break;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+// Non-temporal output policy: serial and pooled, at output offsets that
+// exercise the cached head, whole staging tiles, partial tiles and the tail.
+bool check_nontemporal(const KernelPair& k, const std::vector<uint64_t>& values) {
+  const size_t n = values.size();
+  const size_t out_size = k.bitmap ? (n + 7) / 8 : n;
+  std::vector<uint8_t> ref(out_size + 1, 0xA5);
+  k.serial(values.data(), ref.data(), n);
+  const auto nt = neon_stream::OutputPolicy::NonTemporal;
+  for (size_t offset : {size_t(0), size_t(1), size_t(17), size_t(63)}) {
+    neon_mem::vector<uint8_t> storage(out_size + 1 + 64, 0xA5);  // 64-byte aligned
+    for (int pooled = 0; pooled < 2; ++pooled) {
+      uint8_t* out = storage.data() + offset;
+      std::memset(out, 0xA5, out_size + 1);
+      if (pooled) {
+        neon_parallel::parallel_filter_stream(k.serial, k.bitmap, values.data(), out, n, nt);
+      } else {
+        neon_stream::filter_stream(k.serial, k.bitmap, values.data(), out, n, nt);
+      }
+      if (std::memcmp(ref.data(), out, out_size + 1) != 0) {
+        std::printf("%s: non-temporal mismatch n=%zu offset=%zu pooled=%d\n", k.name, n,
+                    offset, pooled);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void write_file(const std::filesystem::path& path, const std::string& text) {
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream(path) << text << "\n";
+}
+
+// Two nodes with big (1024) and little (512) cores, laid out like
+// /sys/devices/system so read_topology can be pointed at it.
+bool check_fake_topology() {
+  namespace fs = std::filesystem;
+  const fs::path root = fs::temp_directory_path() / "prime8_fake_sysfs";
+  fs::remove_all(root);
+  const fs::path cpu = root / "devices/system/cpu";
+  const fs::path node = root / "devices/system/node";
+  write_file(cpu / "online", "0-5");
+  write_file(node / "online", "0-1");
+  write_file(node / "node0/cpulist", "0-2");
+  write_file(node / "node1/cpulist", "3-5");
+  const unsigned caps[] = {512, 1024, 1024, 1024, 512, 512};
+  for (unsigned c = 0; c < 6; ++c) {
+    write_file(cpu / ("cpu" + std::to_string(c)) / "cpu_capacity", std::to_string(caps[c]));
+  }
+
+  const auto topo = neon_parallel::read_topology(root.string());
+  fs::remove_all(root);
+
+  const unsigned want_cpu[] = {1, 2, 0, 3, 4, 5};
+  const unsigned want_node[] = {0, 0, 0, 1, 1, 1};
+  if (topo.nodes != 2 || topo.cpus.size() != 6) {
+    std::printf("topology: nodes=%u cpus=%zu\n", topo.nodes, topo.cpus.size());
+    return false;
+  }
+  for (size_t i = 0; i < 6; ++i) {
+    if (topo.cpus[i].cpu != want_cpu[i] || topo.cpus[i].node != want_node[i] ||
+        topo.cpus[i].capacity != caps[want_cpu[i]]) {
+      std::printf("topology: entry %zu = cpu%u node%u cap%u\n", i, topo.cpus[i].cpu,
+                  topo.cpus[i].node, topo.cpus[i].capacity);
+      return false;
+    }
+  }
+
+  // Four slots alternate between nodes, fastest first: cpus 1,3,2,4 grouped
+  // by node as 1,2 | 3,4. The little core (cpu 4) gets half a big core's seed.
+  neon_parallel::WorkStealingPool pool(neon_parallel::PoolOptions{4, false, true}, topo);
+  const size_t chunks = 60;
+  std::vector<size_t> seeded(4, 0);
+  for (size_t c = 0; c < chunks; ++c) ++seeded[pool.seed_owner(chunks, c)];
+  const auto stats = pool.last_run_stats();
+  if (stats[0].cpu != 1 || stats[1].cpu != 2 || stats[2].cpu != 3 || stats[3].cpu != 4 ||
+      seeded[0] != 17 || seeded[2] != 17 || seeded[3] != 9) {
+    std::printf("placement: seeded %zu/%zu/%zu/%zu\n", seeded[0], seeded[1], seeded[2], seeded[3]);
+    return false;
+  }
+  return neon_parallel::parse_cpulist("0-1,4,6-7") == std::vector<unsigned>{0, 1, 4, 6, 7};
+}
+
+// Every chunk runs exactly once and the per-slot counts add up.
+bool check_stats(unsigned threads) {
+  neon_parallel::configure(neon_parallel::PoolOptions{threads, true, true});
+  auto& pool = neon_parallel::default_pool();
+  const size_t chunks = 257;
+  std::vector<std::atomic<unsigned>> hits(chunks);
+  pool.parallel_for(chunks, [&](size_t c) { hits[c].fetch_add(1, std::memory_order_relaxed); });
+  size_t total = 0;
+  for (const auto& w : neon_parallel::last_run_stats()) total += w.chunks;
+  for (size_t c = 0; c < chunks; ++c) {
+    if (hits[c].load() != 1) {
+      std::printf("stats: chunk %zu ran %u times\n", c, hits[c].load());
+      return false;
+    }
+  }
+  if (total != chunks) {
+    std::printf("stats: threads=%u counted %zu of %zu chunks\n", threads, total, chunks);
+    return false;
+  }
+  return true;
+}
+
+// Without stealing, chunk c runs on seed_owner(chunks, c) (slot 0 is the
+// caller) whatever the timing; first-touch allocation relies on it.
+bool check_seeded(unsigned threads) {
+  auto& pool = neon_parallel::default_pool();
+  const size_t chunks = 257;
+  std::vector<std::thread::id> ran(chunks);
+  pool.parallel_for(chunks, [&](size_t c) { ran[c] = std::this_thread::get_id(); }, false);
+  std::vector<std::thread::id> slot(pool.size());
+  slot[0] = std::this_thread::get_id();
+  std::vector<size_t> seeded(pool.size(), 0);
+  for (size_t c = 0; c < chunks; ++c) {
+    const unsigned s = pool.seed_owner(chunks, c);
+    ++seeded[s];
+    if (slot[s] == std::thread::id()) slot[s] = ran[c];
+    if (ran[c] != slot[s]) {
+      std::printf("seeded: threads=%u chunk %zu left slot %u\n", threads, c, s);
+      return false;
+    }
+  }
+  const auto stats = neon_parallel::last_run_stats();
+  for (unsigned s = 0; s < pool.size(); ++s) {
+    if (stats[s].steals != 0 || stats[s].chunks != seeded[s]) {
+      std::printf("seeded: threads=%u slot %u ran %zu chunks (%zu steals), seeded %zu\n",
+                  threads, s, stats[s].chunks, stats[s].steals, seeded[s]);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (!check_fake_topology()) return 1;
+  uint64_t seed = 2026;
+  constexpr size_t C = neon_parallel::kParallelChunk;
+  const size_t sizes[] = {0, 1, 7, 63, 64, 65, C - 1, C, C + 1, C + 9,
+                          2 * C + 31, 5 * C + 17, 9 * C};
+
+  for (unsigned threads : {1u, 2u, 3u, 4u, 7u}) {
+    neon_parallel::set_thread_count(threads);
+    for (size_t n : sizes) {
+      auto values = make_mixed_values(n, seed++);
+      for (const auto& k : kKernels) {
+        if (!check_identical(k, values)) return 1;
+      }
+    }
+  }
+
+  neon_parallel::set_thread_count(3);
+  for (size_t n : {size_t(0), size_t(5), size_t(1000), size_t(4096 * 8 + 3), C + 600,
+                   3 * C + 77, 2 * C + 4096 * 9}) {
+    auto values = make_mixed_values(n, seed++);
+    for (const auto& k : kKernels) {
+      if (!check_nontemporal(k, values)) return 1;
+    }
+  }
+
+  // Reuse the same pool across many small calls.
+  neon_parallel::set_thread_count(4);
+  for (int rep = 0; rep < 200; ++rep) {
+    auto values = make_mixed_values(3 * C + static_cast<size_t>(rep), seed++);
+    if (!check_identical(kKernels[1], values)) return 1;
+  }
+
+  // Pinned pools and first-touch buffers.
+  for (unsigned threads : {1u, 3u, 4u}) {
+    if (!check_stats(threads) || !check_seeded(threads)) return 1;
+    const size_t n = 4 * C + 5;
+    auto values = make_mixed_values(n, seed++);
+    uint64_t* in = neon_parallel::alloc_numbers_first_touch(n);
+    uint8_t* out = neon_parallel::alloc_output_first_touch(n, true);
+    std::memcpy(in, values.data(), n * sizeof(uint64_t));
+    std::vector<uint8_t> ref((n + 7) / 8);
+    neon_fast::filter_stream_u64_barrett16_bitmap(values.data(), ref.data(), n);
+    neon_parallel::parallel_filter_stream_u64_barrett16_bitmap(in, out, n);
+    const bool same = std::memcmp(ref.data(), out, ref.size()) == 0;
+    neon_parallel::free_first_touch(in);
+    neon_parallel::free_first_touch(out);
+    if (!same) {
+      std::printf("first-touch: mismatch threads=%u\n", threads);
+      return 1;
+    }
+  }
+
+  std::puts("OK");
+  return 0;
+}
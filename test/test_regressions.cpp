@@ -0,0 +1,208 @@
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "datasets.hpp"
+#include "prime8.h"
+#include "simd_fast.hpp"
+
+// Kernel bugs found by the differential checks, each pinned by the input that
+// showed it.
+namespace {
+
+constexpr uint32_t kPrimes[16] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+
+// Survives trial division by 2..53 (a value equal to one of them survives);
+// values above 32 bits never survive.
+bool survives(uint64_t v) {
+  if (v > 0xffffffffu) return false;
+  for (uint32_t p : kPrimes) {
+    if (v != p && v % p == 0) return false;
+  }
+  return true;
+}
+
+bool bit(const std::vector<uint8_t>& bitmap, size_t i) {
+  return (bitmap[i >> 3] >> (i & 7)) & 1;
+}
+
+// A kernel's output over `values` (a bitmap, or one byte per number) agrees
+// with survives() everywhere.
+bool matches(const char* what, neon_stream::StreamKernel fn,
+             const std::vector<uint64_t>& values, bool bitmap = true) {
+  std::vector<uint8_t> out(bitmap ? (values.size() + 7) / 8 : values.size());
+  fn(values.data(), out.data(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const bool got = bitmap ? bit(out, i) : out[i] != 0;
+    if (got != survives(values[i])) {
+      std::printf("%s: value %llu at index %zu: got %d\n", what,
+                  static_cast<unsigned long long>(values[i]), i, int(got));
+      return false;
+    }
+  }
+  return true;
+}
+
+struct Named {
+  const char* name;
+  neon_stream::StreamKernel fn;
+};
+
+// The bitmap kernels with a scalar tail of their own.
+const Named kTailKernels[] = {
+    {"wheel_optimized", neon_optimized::filter_stream_u64_wheel_optimized},
+    {"wheel210", neon_wheel210::filter_stream_u64_wheel210_bitmap},
+    {"wheel210_efficient", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap},
+};
+
+std::vector<uint64_t> dataset(const char* name, size_t n) {
+  std::vector<uint64_t> values(n);
+  neon_data::generate(*neon_data::find(name), values.data(), n, 1);
+  return values;
+}
+
+// movemask8_from_u32 shifted each lane's 0xFF mask down to 1 before ANDing it
+// with the bit weights, so only lane 0 of every 8 could survive: a block of
+// primes came back as 0x01 bytes.
+bool movemask_lanes() {
+  const std::vector<uint64_t> primes = dataset("primes32", 64);
+  std::vector<uint8_t> bitmap(primes.size() / 8);
+  neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap(
+      primes.data(), bitmap.data(), primes.size());
+  for (size_t i = 0; i < primes.size(); ++i) {
+    if (!bit(bitmap, i)) {
+      std::printf("movemask: prime %llu in lane %zu dropped\n",
+                  static_cast<unsigned long long>(primes[i]), i % 16);
+      return false;
+    }
+  }
+  return true;
+}
+
+// wheel210_efficient's mod-7 step corrected a remainder r >= 7 by subtracting
+// the compare mask times 7 (r + 7) instead of the mask ANDed with 7 (r - 7).
+// Multiples of 7 whose Barrett quotient came out one short survived.
+bool mod7_correction() {
+  const auto fn = neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap;
+  std::vector<uint64_t> sevens = dataset("uniform32", 4096);
+  for (uint64_t& v : sevens) v = 7 * (v / 7);
+  return matches("mod-7 correction", fn, sevens) &&
+         matches("wheel210_efficient", fn, dataset("uniform32", 1 << 16));
+}
+
+// wheel210 used MU210 = ceil(2^32/210), so the quotient could come out one
+// too large and the remainder wrapped: primes were rejected, and the scalar
+// tail indexed its residue table out of bounds. 2, 3, 5 and 7 fail the wheel
+// and were rejected too. Counts are odd so the scalar tail runs.
+bool wheel210_barrett() {
+  const auto fn = neon_wheel210::filter_stream_u64_wheel210_bitmap;
+  std::vector<uint64_t> small(61);
+  for (size_t i = 0; i < small.size(); ++i) small[i] = i;
+  return matches("wheel210 small values", fn, small) &&
+         matches("wheel210", fn, dataset("uniform32", (1 << 16) + 13)) &&
+         matches("wheel210 primes", fn, dataset("primes32", 4096 + 13));
+}
+
+// wheel_optimized and barrett16_final's wheel prefilter used 2863311531 (the
+// /3 magic) as their mod-30 Barrett constant and skipped the correction, so
+// residues were garbage. Both also rejected 2, 3 and 5, and wheel_optimized
+// skipped the trial divisions by 23, 29 and 31.
+bool mod30_barrett() {
+  const auto wheel = neon_optimized::filter_stream_u64_wheel_optimized;
+  std::vector<uint64_t> small(61);
+  for (size_t i = 0; i < small.size(); ++i) small[i] = i;
+  std::vector<uint64_t> multiples = dataset("uniform32", 4096);
+  for (size_t i = 0; i < multiples.size(); ++i) {
+    const uint64_t p = i % 3 == 0 ? 23 : i % 3 == 1 ? 29 : 31;
+    multiples[i] = p * (multiples[i] / p);
+  }
+  if (!matches("wheel_optimized small values", wheel, small) ||
+      !matches("wheel_optimized 23/29/31", wheel, multiples) ||
+      !matches("wheel_optimized", wheel, dataset("uniform32", (1 << 16) + 13)) ||
+      !matches("wheel_optimized primes", wheel, dataset("primes32", 4096 + 13))) {
+    return false;
+  }
+
+  // barrett16_final's 8-number steps (a call's last < 32 numbers) skip a
+  // pack when the prefilter finds no lane coprime to 30. Each pack here holds
+  // one prime among multiples of 30, so the prefilter's verdict on that lane
+  // decides the pack.
+  const auto final16 = neon_final::filter_stream_u64_barrett16_final;
+  const std::vector<uint64_t> primes = dataset("primes32", 24 * 64);
+  for (size_t c = 0; c < primes.size(); c += 24) {
+    std::vector<uint64_t> packs(24);
+    for (size_t i = 0; i < packs.size(); ++i) {
+      packs[i] = i % 8 == c / 24 % 8 ? primes[c + i] : 30 * (i + 1);
+    }
+    if (!matches("barrett16_final packs", final16, packs, false)) return false;
+  }
+  const std::vector<uint64_t> tiny = {2, 30, 60, 90, 120, 150, 180, 210,
+                                      3, 30, 60, 90, 120, 150, 180, 210,
+                                      5, 30, 60, 90, 120, 150, 180, 210};
+  return matches("barrett16_final 2/3/5", final16, tiny, false) &&
+         matches("barrett16_final", final16, dataset("uniform32", (1 << 16) + 13), false);
+}
+
+// The final-tail loops of wheel_optimized and wheel210 skipped their mask
+// update on `continue`, so a value above 32 bits or a wheel reject kept
+// whatever bit the output already held. wheel210_efficient's scalar tail
+// rejected 2, 3 and 5. The output starts all ones here, and the counts leave
+// a scalar tail of every length.
+bool tail_bits() {
+  std::vector<uint64_t> values = dataset("mixed", 64);
+  const uint64_t smalls[] = {2, 3, 5, 7, 4, 9, 25, 49};
+  for (size_t i = 0; i < 8; ++i) values[48 + i] = smalls[i];
+  for (const Named& k : kTailKernels) {
+    for (size_t n = 33; n <= values.size(); ++n) {
+      std::vector<uint8_t> bitmap((n + 7) / 8, 0xFF);
+      k.fn(values.data(), bitmap.data(), n);
+      for (size_t i = 0; i < n; ++i) {
+        if (bit(bitmap, i) != survives(values[i])) {
+          std::printf("%s tail: value %llu at index %zu of %zu: got %d\n", k.name,
+                      static_cast<unsigned long long>(values[i]), i, n, int(bit(bitmap, i)));
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// A bitmap kernel writes its whole last byte, padding bits past count zero
+// (prime8.h). wheel_optimized and wheel210 merged the last byte under a mask,
+// and wheel210_efficient's tail set and cleared single bits, so a reused
+// buffer kept its stale padding bits. The C API kernels are held to the same.
+bool padding_bits() {
+  const std::vector<uint64_t> values = dataset("uniform32", 64);
+  for (size_t n = 1; n < values.size(); ++n) {
+    if (!(n & 7)) continue;
+    const size_t last = (n - 1) / 8;
+    for (const Named& k : kTailKernels) {
+      std::vector<uint8_t> bitmap(last + 1, 0xFF);
+      k.fn(values.data(), bitmap.data(), n);
+      if (bitmap[last] >> (n & 7)) {
+        std::printf("%s: padding bits set at count %zu\n", k.name, n);
+        return false;
+      }
+    }
+    for (int id = 0; prime8_kernel_name(id); ++id) {
+      std::vector<uint8_t> bitmap(last + 1, 0xFF);
+      if (prime8_filter_bitmap(id, values.data(), n, bitmap.data(), 0) != PRIME8_OK ||
+          bitmap[last] >> (n & 7)) {
+        std::printf("prime8 %s: padding bits set at count %zu\n", prime8_kernel_name(id), n);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (!movemask_lanes() || !mod7_correction() || !wheel210_barrett() || !mod30_barrett() ||
+      !tail_bits() || !padding_bits()) {
+    return 1;
+  }
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,316 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "prime8.h"
+#include "prime8_wire.h"
+#include "shm_ring.hpp"
+
+namespace {
+
+bool survives(uint64_t n) {
+  if (n > 0xffffffffu) return false;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53}) {
+    if (n != p && n % p == 0) return false;
+  }
+  return true;
+}
+
+// The ring's bitmap for `values`, checked bit by bit against the reference.
+bool check(const char* what, const std::vector<uint64_t>& values,
+           const neon_shm::RingClient::Result& r) {
+  if (!r.bitmap || r.status != PRIME8_STATUS_OK) {
+    std::printf("%s: status %u\n", what, r.status);
+    return false;
+  }
+  uint64_t expect = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const bool want = survives(values[i]);
+    expect += want;
+    if (((r.bitmap[i >> 3] >> (i & 7)) & 1) != want) {
+      std::printf("%s: bit %zu (value %llu) wrong\n", what, i,
+                  static_cast<unsigned long long>(values[i]));
+      return false;
+    }
+  }
+  if (r.survivors != expect) {
+    std::printf("%s: survivors %llu, expected %llu\n", what,
+                static_cast<unsigned long long>(r.survivors),
+                static_cast<unsigned long long>(expect));
+    return false;
+  }
+  return true;
+}
+
+// Accepts `clients` connections in order and serves each ring on its own
+// thread, so served[c] belongs to the c-th client to connect.
+struct Server {
+  std::string path;
+  int lfd = -1;
+  std::atomic<bool> stop{false};
+  std::atomic<unsigned> accepted{0};
+  std::vector<std::thread> threads;
+  std::vector<int> fds;
+  std::vector<int64_t> served;
+
+  bool start(unsigned clients) {
+    path = "/tmp/prime8-test-shm-" + std::to_string(::getpid()) + ".sock";
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    ::unlink(path.c_str());
+    lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (lfd < 0 || ::bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(lfd, 8) != 0) {
+      return false;
+    }
+    served.assign(clients, -2);
+    fds.assign(clients, -1);
+    for (unsigned c = 0; c < clients; ++c) {
+      threads.emplace_back([this, c] {
+        while (accepted.load() != c) std::this_thread::yield();
+        fds[c] = ::accept(lfd, nullptr, nullptr);
+        accepted.fetch_add(1);
+        served[c] = neon_shm::serve_ring(fds[c], stop);
+      });
+    }
+    return true;
+  }
+
+  void join() {
+    for (auto& t : threads) {
+      if (t.joinable()) t.join();
+    }
+    for (int fd : fds) ::close(fd);
+    ::close(lfd);
+    ::unlink(path.c_str());
+  }
+};
+
+#if defined(__linux__)
+// A hand-rolled client that hands the server a valid 1024-number, 8-slot
+// ring in a memfd of its own, sealed or not, so it keeps the power to
+// resize it and to write any counter. Returns the acked header, or nullptr
+// if the server refused the ring.
+struct RawRing {
+  int sock = -1;
+  int mem = -1;
+  size_t bytes = 0;
+  neon_shm::RingHeader* hdr = nullptr;
+
+  neon_shm::RingHeader* connect(const std::string& path, bool seal) {
+    auto up = [](size_t n, size_t a) { return (n + a - 1) / a * a; };
+    const size_t slots_off = up(sizeof(neon_shm::RingHeader), 64);
+    const size_t numbers_off = up(slots_off + 8 * sizeof(neon_shm::Slot), 4096);
+    const size_t bitmap_off = numbers_off + 1024 * sizeof(uint64_t);
+    bytes = up(bitmap_off + 1024 / 8, 4096);
+    mem = ::memfd_create("prime8-test-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (mem < 0 || ::ftruncate(mem, static_cast<off_t>(bytes)) != 0) return nullptr;
+    if (seal && ::fcntl(mem, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW) != 0) return nullptr;
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, mem, 0);
+    if (base == MAP_FAILED) return nullptr;
+    hdr = new (base) neon_shm::RingHeader();
+    hdr->magic = neon_shm::kRingMagic;
+    hdr->version = neon_shm::kRingVersion;
+    hdr->slots = 8;
+    hdr->capacity = 1024;
+    hdr->slots_offset = slots_off;
+    hdr->numbers_offset = numbers_off;
+    hdr->bitmap_offset = bitmap_off;
+    hdr->total_bytes = bytes;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || ::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+      return nullptr;
+    }
+    char byte = 0;
+    iovec iov{&byte, 1};
+    alignas(cmsghdr) char ctrl[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl;
+    msg.msg_controllen = sizeof(ctrl);
+    cmsghdr* c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(c), &mem, sizeof(int));
+    char ack = 1;
+    if (::sendmsg(sock, &msg, 0) != 1 || ::recv(sock, &ack, 1, MSG_WAITALL) != 1 || ack != 0) {
+      return nullptr;
+    }
+    return hdr;
+  }
+
+  ~RawRing() {
+    if (hdr) ::munmap(hdr, bytes);
+    if (sock >= 0) ::close(sock);
+    if (mem >= 0) ::close(mem);
+  }
+};
+#endif
+
+} // namespace
+
+int main() {
+  Server server;
+#if defined(__linux__)
+  constexpr unsigned kLate = 3;  // after the two raw rings
+#else
+  constexpr unsigned kLate = 1;
+#endif
+  if (!server.start(kLate + 1)) {
+    std::printf("cannot listen\n");
+    return 1;
+  }
+
+  std::mt19937_64 rng(36);
+  auto fill = [&](uint64_t* dst, std::vector<uint64_t>& copy, size_t n) {
+    copy.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      copy[i] = i % 5 ? rng() & 0xffffffffu : rng() >> 26;
+      dst[i] = copy[i];
+    }
+  };
+
+  {
+    neon_shm::RingClient ring;
+    if (!ring.connect(server.path, 1 << 18, 8)) {
+      std::printf("connect: %s\n", ring.error().c_str());
+      return 1;
+    }
+
+    // One request at a time, including empty, ragged and parallel-sized ones.
+    std::vector<uint64_t> values;
+    for (size_t n : {size_t(0), size_t(1), size_t(63), size_t(64), size_t(1000),
+                     size_t(1) << 18}) {
+      uint64_t* p = ring.reserve(n);
+      if (!p) {
+        std::printf("reserve(%zu) failed\n", n);
+        return 1;
+      }
+      fill(p, values, n);
+      if (!check("single", values, ring.wait(ring.submit(PRIME8_WHEEL30, n)))) return 1;
+    }
+    if (ring.reserve((size_t(1) << 18) + 1) != nullptr) {
+      std::printf("oversized reserve succeeded\n");
+      return 1;
+    }
+
+    // Pipelined requests of random sizes: wrap the region many times, keep
+    // several in flight and only wait when the ring is full.
+    std::deque<std::pair<uint32_t, std::vector<uint64_t>>> inflight;
+    for (int r = 0; r < 400; ++r) {
+      const size_t n = rng() % 70000;
+      uint64_t* p;
+      while (!(p = ring.reserve(n))) {
+        auto& [t, v] = inflight.front();
+        if (!check("pipelined", v, ring.wait(t))) return 1;
+        inflight.pop_front();
+      }
+      std::vector<uint64_t> copy;
+      fill(p, copy, n);
+      inflight.emplace_back(ring.submit(r % 2 ? PRIME8_BARRETT16 : PRIME8_SIEVE, n),
+                            std::move(copy));
+    }
+    while (!inflight.empty()) {
+      auto& [t, v] = inflight.front();
+      if (!check("drain", v, ring.wait(t))) return 1;
+      inflight.pop_front();
+    }
+
+    ring.reserve(8);
+    const auto bad = ring.wait(ring.submit(99, 8));
+    if (!bad.bitmap || bad.status != PRIME8_STATUS_BAD_MODE) {
+      std::printf("unknown kernel not rejected\n");
+      return 1;
+    }
+  }
+
+#if defined(__linux__)
+  {
+    // A ring whose size the client could still change is refused: shrinking
+    // it under the server's mapping would kill the server with SIGBUS.
+    RawRing unsealed;
+    if (unsealed.connect(server.path, false)) {
+      std::printf("unsealed ring accepted\n");
+      return 1;
+    }
+
+    // A sealed one is served, and the client can no longer truncate it.
+    RawRing sealed;
+    neon_shm::RingHeader* hdr = sealed.connect(server.path, true);
+    if (!hdr) {
+      std::printf("sealed ring refused\n");
+      return 1;
+    }
+    if (::ftruncate(sealed.mem, 0) == 0) {
+      std::printf("sealed ring truncated\n");
+      return 1;
+    }
+    uint8_t* base = reinterpret_cast<uint8_t*>(hdr);
+    auto* slot = reinterpret_cast<neon_shm::Slot*>(base + hdr->slots_offset);
+    auto* nums = reinterpret_cast<uint64_t*>(base + hdr->numbers_offset);
+    for (int i = 0; i < 64; ++i) nums[i] = 1000 + i;
+    slot[0] = {0, 64, 0, PRIME8_WHEEL30, PRIME8_STATUS_OK};
+    hdr->submitted.store(1);
+    while (hdr->completed.load() != 1) std::this_thread::yield();
+    if (slot[0].status != PRIME8_STATUS_OK || slot[0].survivors == 0) {
+      std::printf("sealed ring: status %u\n", slot[0].status);
+      return 1;
+    }
+
+    // A submitted counter behind the completed one claims 2^32 - 1 requests
+    // in flight; the server drops the ring instead of running them.
+    hdr->submitted.store(0);
+    server.threads[2].join();
+    if (server.served[1] != -1 || server.served[2] != 1) {
+      std::printf("raw rings served %lld / %lld\n", static_cast<long long>(server.served[1]),
+                  static_cast<long long>(server.served[2]));
+      return 1;
+    }
+  }
+#endif
+
+  // A client that is still connected when the server stops sees its
+  // wait() fail instead of hanging.
+  neon_shm::RingClient late;
+  if (!late.connect(server.path, 1024)) {
+    std::printf("second connect: %s\n", late.error().c_str());
+    return 1;
+  }
+  server.stop.store(true);
+  server.threads[kLate].join();
+  ::shutdown(server.fds[kLate], SHUT_RDWR);
+  server.join();
+  late.reserve(10);
+  if (late.wait(late.submit(PRIME8_WHEEL30, 10)).bitmap != nullptr) {
+    std::printf("wait succeeded on a stopped server\n");
+    return 1;
+  }
+  if (server.served[0] < 400) {
+    std::printf("first ring served %lld requests\n", static_cast<long long>(server.served[0]));
+    return 1;
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "datasets.hpp"
+#include "prime8.h"
+#include "simd_fast.hpp"
+
+namespace {
+
+constexpr uint8_t kGuard = 0xA5;
+
+// Small-batch kernels against neon_wheel at the same offset and count: same
+// bits / bytes, and nothing written past the output's end.
+bool check(const char* label, const uint64_t* values, size_t n) {
+  const size_t bytes = (n + 7) / 8;
+  std::vector<uint8_t> want_bits(bytes + 8, 0), got_bits(bytes + 8, kGuard);
+  std::vector<uint8_t> want_flags(n + 16, 0), got_flags(n + 16, kGuard);
+  neon_wheel::filter_stream_u64_wheel_bitmap(values, want_bits.data(), n);
+  neon_wheel::filter_stream_u64_wheel(values, want_flags.data(), n);
+  neon_small::filter_small_u64_wheel_bitmap(values, got_bits.data(), n);
+  neon_small::filter_small_u64_wheel(values, got_flags.data(), n);
+
+  if (std::memcmp(want_bits.data(), got_bits.data(), bytes) != 0 ||
+      std::memcmp(want_flags.data(), got_flags.data(), n) != 0) {
+    std::printf("%s: n=%zu differs from neon_wheel\n", label, n);
+    return false;
+  }
+  for (size_t i = bytes; i < got_bits.size(); ++i) {
+    if (got_bits[i] != kGuard) {
+      std::printf("%s: n=%zu bitmap written past byte %zu\n", label, n, bytes);
+      return false;
+    }
+  }
+  for (size_t i = n; i < got_flags.size(); ++i) {
+    if (got_flags[i] != kGuard) {
+      std::printf("%s: n=%zu flags written past %zu\n", label, n, n);
+      return false;
+    }
+  }
+
+  // The C API routes batches this small to the same kernel.
+  std::vector<uint8_t> api_bits(bytes + 8, 0);
+  if (prime8_filter_bitmap(PRIME8_WHEEL30, values, n, api_bits.data(), 0) != PRIME8_OK ||
+      std::memcmp(want_bits.data(), api_bits.data(), bytes) != 0) {
+    std::printf("%s: n=%zu prime8_filter_bitmap differs\n", label, n);
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  constexpr size_t kMax = 300;
+  const char* sets[] = {"mixed", "dense", "primes32", "uniform64"};
+  for (const char* name : sets) {
+    std::vector<uint64_t> values(kMax + 64);
+    neon_data::generate(*neon_data::find(name), values.data(), values.size(), 7);
+    // Every count up to kMax, from an aligned and an odd start.
+    for (size_t n = 0; n <= kMax; ++n) {
+      if (!check(name, values.data(), n) || !check(name, values.data() + 3, n)) return 1;
+    }
+  }
+
+  // The values the tail handling is most likely to get wrong.
+  const std::vector<uint64_t> edges = {0, 1, 2, 3, 5, 7, 53, 59, 0xffffffffull,
+                                       0x100000000ull, 4294967291ull, ~0ull, 2809, 49};
+  for (size_t n = 0; n <= edges.size(); ++n) {
+    if (!check("edges", edges.data(), n)) return 1;
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "datasets.hpp"
+#include "prime8.h"
+#include "simd_fast.hpp"
+
+namespace {
+
+uint64_t accounted(const prime8_stats& s) {
+  uint64_t sum = s.wide + s.wheel + s.survivors;
+  for (uint64_t g : s.group) sum += g;
+  return sum;
+}
+
+// After one wheel-30 count over n values (all in vector steps): every lane
+// counted once, and the survivors are exactly the ones the call reported.
+bool check(const char* label, size_t n, int64_t count) {
+  prime8_stats s;
+  if (prime8_stats_get(&s) != PRIME8_OK) {
+    std::printf("%s: prime8_stats_get failed\n", label);
+    return false;
+  }
+  if (s.lanes != n || accounted(s) != s.lanes || s.survivors != static_cast<uint64_t>(count)) {
+    std::printf("%s: lanes=%llu accounted=%llu survivors=%llu, want %zu / %zu / %lld\n", label,
+                static_cast<unsigned long long>(s.lanes),
+                static_cast<unsigned long long>(accounted(s)),
+                static_cast<unsigned long long>(s.survivors), n, n,
+                static_cast<long long>(count));
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+int main() {
+  if (prime8_stats_get(nullptr) != PRIME8_ENULL) {
+    std::printf("prime8_stats_get(NULL) accepted\n");
+    return 1;
+  }
+
+  constexpr size_t kN = size_t(1) << 18;  // whole serial blocks: no scalar tail
+  std::vector<uint64_t> values(kN);
+  neon_data::generate(*neon_data::find("mixed"), values.data(), kN, 3);
+
+  if (!prime8_stats_enabled()) {
+    // Hooks compiled out: the counters stay zero.
+    prime8_stats_reset();
+    prime8_count(PRIME8_WHEEL30, values.data(), kN, 0);
+    prime8_stats s;
+    prime8_stats_get(&s);
+    if (s.lanes || accounted(s)) {
+      std::printf("counters moved in a build without PRIME8_STATS\n");
+      return 1;
+    }
+    std::printf("OK (stats compiled out)\n");
+    return 0;
+  }
+
+  prime8_stats_reset();
+  if (!check("serial", kN, prime8_count(PRIME8_WHEEL30, values.data(), kN, 0))) return 1;
+
+  // Pool workers count into their own blocks; the snapshot sums them.
+  prime8_stats_reset();
+  if (!check("parallel", kN, prime8_count(PRIME8_WHEEL30, values.data(), kN, PRIME8_PARALLEL)))
+    return 1;
+
+  // Small batches count only the real lanes of the padded last step.
+  prime8_stats_reset();
+  if (!check("small", 37, prime8_count(PRIME8_WHEEL30, values.data(), 37, 0))) return 1;
+
+  // A thread's counts outlive it.
+  prime8_stats_reset();
+  int64_t count = 0;
+  std::thread t([&] { count = prime8_count(PRIME8_WHEEL30, values.data(), kN, 0); });
+  t.join();
+  if (!check("exited thread", kN, count)) return 1;
+
+  // barrett16_final: each 8-lane step is skipped by the wheel or runs the
+  // early-out sieve, which leaves after at most one checkpoint.
+  prime8_stats_reset();
+  std::vector<uint8_t> flags(kN);
+  neon_final::filter_stream_u64_barrett16_final(values.data(), flags.data(), kN);
+  prime8_stats s;
+  prime8_stats_get(&s);
+  uint64_t early = 0;
+  for (uint64_t e : s.early_out) early += e;
+  if (s.lanes != kN || s.steps + s.wheel_skips != kN / 8 || early > s.steps) {
+    std::printf("barrett16_final: lanes=%llu steps=%llu skips=%llu early=%llu\n",
+                static_cast<unsigned long long>(s.lanes),
+                static_cast<unsigned long long>(s.steps),
+                static_cast<unsigned long long>(s.wheel_skips),
+                static_cast<unsigned long long>(early));
+    return 1;
+  }
+
+  prime8_stats_reset();
+  prime8_stats_get(&s);
+  if (s.lanes || accounted(s) || s.steps) {
+    std::printf("prime8_stats_reset left counts behind\n");
+    return 1;
+  }
+
+  std::printf("OK\n");
+  return 0;
+}
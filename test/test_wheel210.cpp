@@ -1,4 +1,5 @@
 #include "simd_fast.hpp"
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <random>
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-autotune: times every setting of the wheel-30 kernel's main loop
+// (neon_wheel::WheelTuning: 16-lane steps per iteration, prefetch distance,
+// early-out after 7..19) on this machine and input distribution, and writes
+// the fastest to the profile libprime8 loads (src/autotune.hpp).
+//
+//   prime8-autotune [-d dataset] [-n size] [-r reps] [-s seed] [-t pct]
+//                   [-o profile] [--dry-run]
+//
+//   -d   input distribution, as for prime8_bench -d (default mixed); tune on
+//        the one closest to production traffic
+//   -n   numbers per call (default 1M); sizes as for prime8_bench -n
+//   -r   timed samples per setting (default 9)
+//   -s   dataset seed (default 42)
+//   -t   minimum gain over the default, percent (default 3): below it the
+//        difference is noise and the profile keeps the default
+//   -o   profile to write (default: where libprime8 reads it, see below)
+//   --dry-run  print the table, write nothing
+//
+// Every setting's output is first checked against the default kernel. The
+// table lists each setting's median time per call relative to the default;
+// the profile gets the fastest if it clears -t. libprime8 reads
+// $PRIME8_PROFILE, else $XDG_CONFIG_HOME/prime8/profile, else
+// ~/.config/prime8/profile.
+//
+// Exit status 0 on success, 1 if a setting's output differs, 2 on usage or
+// I/O errors.
+#include "autotune.hpp"
+#include "harness.hpp"
+#include "topology.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace prime8_bench;
+
+namespace {
+
+constexpr unsigned kSteps[] = {1, 2, 4};
+constexpr unsigned kPrefetch[] = {0, 32, 64, 128, 256, 512};
+
+// measure() takes a plain kernel pointer, so the setting under test is a global.
+neon_wheel::WheelTuning g_trial;
+
+void trial_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap,
+                  size_t count) {
+  neon_wheel::filter_stream_u64_wheel_bitmap_tuned(g_trial, numbers, bitmap, count);
+}
+
+struct Result {
+  neon_wheel::WheelTuning tuning;
+  Stats ns;
+};
+
+std::string utc_now() {
+  const std::time_t t = std::time(nullptr);
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &tm);
+  return buf;
+}
+
+bool is_default(const neon_wheel::WheelTuning& t) {
+  const neon_wheel::WheelTuning d;
+  return t.steps == d.steps && t.prefetch == d.prefetch && t.early_out == d.early_out;
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [-d dataset] [-n size] [-r reps] [-s seed] [-t pct] [-o profile] "
+               "[--dry-run]\n",
+               argv0);
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string dataset = "mixed";
+  size_t n = size_t(1) << 20;
+  uint64_t seed = 42;
+  std::string out_path = neon_tune::default_profile_path();
+  bool dry_run = false;
+  double threshold = 3.0;
+  RunOptions run;
+  run.reps = 9;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "-d" && has_value) {
+      dataset = argv[++i];
+    } else if (arg == "-n" && has_value) {
+      n = parse_size(argv[++i]);
+      if (!n) return usage(argv[0]);
+    } else if (arg == "-r" && has_value) {
+      run.reps = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "-s" && has_value) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-t" && has_value) {
+      threshold = std::strtod(argv[++i], nullptr);
+    } else if (arg == "-o" && has_value) {
+      out_path = argv[++i];
+    } else if (arg == "--dry-run") {
+      dry_run = true;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  const Dataset* d = neon_data::find(dataset);
+  if (!d) {
+    std::fprintf(stderr, "%s: unknown dataset %s (prime8_bench -l lists them)\n", argv[0],
+                 dataset.c_str());
+    return 2;
+  }
+  if (!dry_run && out_path.empty()) {
+    std::fprintf(stderr, "%s: no profile path; pass -o\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<uint64_t> input(n);
+  neon_data::generate(*d, input.data(), n, seed);
+  const size_t bytes = (n + 7) / 8;
+  std::vector<uint8_t> want(bytes), got(bytes);
+  neon_wheel::filter_stream_u64_wheel_bitmap(input.data(), want.data(), n);
+
+  std::printf("prime8-autotune: %s, %zu numbers per call, %d reps per setting\n", d->name, n,
+              run.reps);
+  std::printf("cpu: %s\n", neon_parallel::cpu_model().c_str());
+  std::printf("%6s %9s %10s %12s %9s\n", "steps", "prefetch", "early_out", "median us",
+              "vs dflt");
+
+  const Kernel trial{"wheel_trial", "wheel", Output::Bitmap, trial_kernel, nullptr, 16};
+  std::vector<Result> results;
+  double base_ns = 0;
+  for (const unsigned steps : kSteps) {
+    for (const unsigned prefetch : kPrefetch) {
+      for (const bool early_out : {false, true}) {
+        g_trial = {steps, prefetch, early_out};
+        std::fill(got.begin(), got.end(), 0);
+        trial_kernel(input.data(), got.data(), n);
+        if (got != want) {
+          std::fprintf(stderr, "%s: steps=%u prefetch=%u early_out=%d differs from the default\n",
+                       argv[0], steps, prefetch, early_out ? 1 : 0);
+          return 1;
+        }
+        const Samples s = measure(trial, input.data(), got.data(), n, run);
+        results.push_back({g_trial, summarize(s.ns)});
+        if (is_default(g_trial)) base_ns = results.back().ns.median;
+      }
+    }
+  }
+
+  for (const Result& r : results) {
+    std::printf("%6u %9u %10s %12.2f %8.3fx%s\n", r.tuning.steps, r.tuning.prefetch,
+                r.tuning.early_out ? "yes" : "no", r.ns.median / 1e3, base_ns / r.ns.median,
+                is_default(r.tuning) ? "  (default)" : "");
+  }
+  const Result& fastest = *std::min_element(results.begin(), results.end(),
+                                            [](const Result& a, const Result& b) {
+                                              return a.ns.median < b.ns.median;
+                                            });
+  const double gain = base_ns / fastest.ns.median;
+  const neon_wheel::WheelTuning best =
+      gain > 1 + threshold / 100 ? fastest.tuning : neon_wheel::WheelTuning{};
+  const bool kept = is_default(best) && !is_default(fastest.tuning);
+  std::printf("fastest: steps=%u prefetch=%u early_out=%s, %.3fx the default%s\n",
+              fastest.tuning.steps, fastest.tuning.prefetch,
+              fastest.tuning.early_out ? "yes" : "no", gain,
+              kept ? " (within -t: keeping the default)" : "");
+  if (dry_run) return 0;
+
+  neon_tune::Profile p;
+  p.cpu = neon_parallel::cpu_model();
+  p.dataset = d->name;
+  p.n = n;
+  p.date = utc_now();
+  p.wheel = best;
+  std::error_code ec;
+  const std::filesystem::path parent = std::filesystem::path(out_path).parent_path();
+  if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+  if (!neon_tune::write_profile(out_path, p)) {
+    std::fprintf(stderr, "%s: cannot write %s\n", argv[0], out_path.c_str());
+    return 2;
+  }
+  std::printf("wrote %s\n", out_path.c_str());
+  return 0;
+}
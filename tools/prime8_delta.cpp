@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-delta: convert between sorted little-endian u64s and the neon_delta
+// block encoding, and filter encoded input without decoding it.
+//
+//   prime8-delta [-d | -i | -f] [-p] [input|-] [output|-]
+//
+//   (default)  encode raw u64s (must be ascending)
+//   -d         decode to raw u64s
+//   -i         print count, size, ratio and the block width histogram
+//   -f         fused wheel-30 filter of an encoding; writes the survivor bitmap
+//              (same layout as prime8-filter -k wheel) and the count to stderr
+//   -p         with -f, filter on the shared pool
+//
+// Input is read whole; the encoding is a single buffer either way.
+#include "delta.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+enum class Mode { Encode, Decode, Info, Filter };
+
+bool read_all(int fd, std::vector<uint8_t>& out) {
+  size_t n = 0;
+  out.resize(size_t(1) << 20);
+  for (;;) {
+    if (n == out.size()) out.resize(out.size() * 2);
+    const ssize_t r = ::read(fd, out.data() + n, out.size() - n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r < 0) return false;
+    if (r == 0) break;
+    n += static_cast<size_t>(r);
+  }
+  out.resize(n);
+  return true;
+}
+
+bool write_all(int fd, const void* data, size_t n) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  while (n) {
+    const ssize_t w = ::write(fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w < 0) return false;
+    p += w;
+    n -= static_cast<size_t>(w);
+  }
+  return true;
+}
+
+void print_info(const neon_delta::View& view) {
+  size_t widths[neon_delta::kRawWidth + 1] = {};
+  const uint8_t* p = view.data;
+  for (uint64_t b = 0; b < view.blocks; ++b) {
+    neon_delta::BlockHeader h;
+    std::memcpy(&h, p, sizeof(h));
+    ++widths[h.width];
+    p += sizeof(h) + neon_delta::payload_bytes(h.width);
+  }
+  const double raw = view.count * 8.0;
+  std::printf("values   %llu\nblocks   %llu\nbytes    %zu (%.3f bits/value, %.2fx smaller than u64)\n",
+              static_cast<unsigned long long>(view.count),
+              static_cast<unsigned long long>(view.blocks), view.bytes,
+              view.count ? view.bytes * 8.0 / view.count : 0.0,
+              view.bytes ? raw / view.bytes : 0.0);
+  std::printf("width    blocks\n");
+  for (unsigned w = 0; w <= neon_delta::kRawWidth; ++w) {
+    if (!widths[w]) continue;
+    if (w == neon_delta::kRawWidth) std::printf("  raw    %zu\n", widths[w]);
+    else std::printf("%5u    %zu\n", w, widths[w]);
+  }
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr, "Usage: %s [-d | -i | -f] [-p] [input|-] [output|-]\n", argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Mode mode = Mode::Encode;
+  bool parallel = false;
+  const char* in_path = "-";
+  const char* out_path = "-";
+
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-d") {
+      mode = Mode::Decode;
+    } else if (arg == "-i") {
+      mode = Mode::Info;
+    } else if (arg == "-f") {
+      mode = Mode::Filter;
+    } else if (arg == "-p") {
+      parallel = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      return usage(argv[0]);
+    } else if (positional == 0) {
+      in_path = argv[i];
+      ++positional;
+    } else if (positional == 1) {
+      out_path = argv[i];
+      ++positional;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  const int in_fd = std::strcmp(in_path, "-") == 0 ? STDIN_FILENO : ::open(in_path, O_RDONLY);
+  if (in_fd < 0) {
+    std::fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], in_path, std::strerror(errno));
+    return 2;
+  }
+  std::vector<uint8_t> input;
+  if (!read_all(in_fd, input)) {
+    std::fprintf(stderr, "%s: read failed: %s\n", argv[0], std::strerror(errno));
+    return 2;
+  }
+
+  neon_delta::View view;
+  if (mode != Mode::Encode) {
+    if (const char* err = neon_delta::open(input.data(), input.size(), view)) {
+      std::fprintf(stderr, "%s: %s: %s\n", argv[0], in_path, err);
+      return 2;
+    }
+    if (mode == Mode::Info) {
+      print_info(view);
+      return 0;
+    }
+  }
+
+  std::vector<uint8_t> output;
+  if (mode == Mode::Encode) {
+    if (input.size() % sizeof(uint64_t)) {
+      std::fprintf(stderr, "%s: input size %zu is not a multiple of 8\n", argv[0], input.size());
+      return 2;
+    }
+    const size_t count = input.size() / sizeof(uint64_t);
+    std::vector<uint64_t> values(count);
+    if (count) std::memcpy(values.data(), input.data(), input.size());
+    output.resize(neon_delta::encoded_bound(count));
+    const size_t bytes = neon_delta::encode(values.data(), count, output.data());
+    if (!bytes) {
+      std::fprintf(stderr, "%s: input is not in ascending order\n", argv[0]);
+      return 2;
+    }
+    output.resize(bytes);
+  } else if (mode == Mode::Decode) {
+    output.resize(view.count * sizeof(uint64_t));
+    neon_delta::decode(view, reinterpret_cast<uint64_t*>(output.data()));
+  } else {
+    output.resize((view.count + 7) / 8);
+    const size_t survivors = parallel ? neon_delta::parallel_filter_wheel_bitmap(view, output.data())
+                                      : neon_delta::filter_wheel_bitmap(view, output.data());
+    std::fprintf(stderr, "%s: numbers=%llu survivors=%zu\n", argv[0],
+                 static_cast<unsigned long long>(view.count), survivors);
+  }
+
+  const int out_fd = std::strcmp(out_path, "-") == 0
+                         ? STDOUT_FILENO
+                         : ::open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0) {
+    std::fprintf(stderr, "%s: cannot create %s: %s\n", argv[0], out_path, std::strerror(errno));
+    return 2;
+  }
+  if (!write_all(out_fd, output.data(), output.size())) {
+    std::fprintf(stderr, "%s: write failed: %s\n", argv[0], std::strerror(errno));
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-filter: run a prefilter kernel over a file of little-endian u64s.
+//
+//   prime8-filter [-k kernel] [-o format] [-c chunk] [-P] [-a] [-Q depth] [-v]
+//                 [input|-] [output|-]
+//
+//   kernels: wheel (default), barrett16, wheel210, sieve, prime (exact, fused MR)
+//   formats: bitmap  - bit i of byte i/8 set for survivors (same as the kernels)
+//            u64     - survivors as raw u64s
+//            count   - survivor count as text
+//            text    - survivors as decimal lines
+//
+// Regular files are mmapped (MAP_POPULATE unless -P, MADV_SEQUENTIAL) and
+// filtered in place chunk by chunk; pipes are read chunk by chunk into one
+// reusable buffer. Output goes through a single large buffer and write(2).
+//
+// With -a, or automatically for inputs larger than half of physical memory,
+// regular files are streamed through neon_io::AsyncReader instead: -Q aligned
+// 8 MiB buffers in flight via io_uring (or an O_DIRECT pread thread), so the
+// kernel filters buffer k while k+1.. load. A regular output file is then
+// written the same way through neon_io::AsyncWriter.
+#include "async_io.hpp"
+#include "simd_fast.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+using BitmapKernel = void (*)(const uint64_t* __restrict, uint8_t* __restrict, size_t);
+
+void fused_prime_kernel(const uint64_t* __restrict numbers, uint8_t* __restrict bitmap,
+                        size_t count) {
+  neon_fused::fused_prime_bitmap(numbers, bitmap, count);
+}
+
+struct KernelEntry {
+  const char* name;
+  BitmapKernel fn;
+};
+
+const KernelEntry kKernels[] = {
+  {"wheel", neon_wheel::filter_stream_u64_wheel_bitmap},
+  {"barrett16", neon_fast::filter_stream_u64_barrett16_bitmap},
+  {"wheel210", neon_wheel210_efficient::filter_stream_u64_wheel210_efficient_bitmap},
+  {"sieve", neon_block_sieve::filter_stream_u64_sieve_bitmap},
+  {"prime", fused_prime_kernel},
+};
+
+enum class Format { Bitmap, U64, Count, Text };
+
+// === Output ===
+
+class Writer {
+public:
+  // Buffered write(2) to fd, or straight into the async writer's buffers.
+  explicit Writer(int fd, neon_io::AsyncWriter* aw = nullptr)
+      : fd_(fd), aw_(aw), own_(aw ? 0 : size_t(1) << 20),
+        buf_(aw ? aw->buffer() : own_.data()), cap_(aw ? aw->capacity() : own_.size()) {}
+  ~Writer() { flush(); }
+
+  // Fills the buffer to capacity before flushing, so every flush but the last
+  // is a whole buffer (the async writer's O_DIRECT path relies on this).
+  void put(const void* data, size_t n) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    while (n) {
+      if (used_ == cap_) flush();
+      const size_t k = std::min(n, cap_ - used_);
+      std::memcpy(buf_ + used_, p, k);
+      used_ += k;
+      p += k;
+      n -= k;
+    }
+  }
+
+  void flush() {
+    if (!used_) return;
+    if (aw_) {
+      aw_->submit(used_);
+      buf_ = aw_->buffer();
+    } else {
+      write_all(buf_, used_);
+    }
+    used_ = 0;
+  }
+
+  bool ok() const { return aw_ ? aw_->error() == 0 : ok_; }
+
+private:
+  void write_all(const uint8_t* p, size_t n) {
+    while (n && ok_) {
+      const ssize_t w = ::write(fd_, p, n);
+      if (w < 0) {
+        if (errno == EINTR) continue;
+        ok_ = false;
+        break;
+      }
+      p += w;
+      n -= static_cast<size_t>(w);
+    }
+  }
+
+  int fd_;
+  neon_io::AsyncWriter* aw_;
+  std::vector<uint8_t> own_;
+  uint8_t* buf_;
+  size_t cap_;
+  size_t used_ = 0;
+  bool ok_ = true;
+};
+
+// Two digits per table lookup, written back to front.
+const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes n and a trailing newline at out; returns the length (<= 21).
+size_t format_u64_line(uint64_t n, char* out) {
+  char tmp[24];
+  char* p = tmp + sizeof(tmp);
+  *--p = '\n';
+  while (n >= 100) {
+    const unsigned r = static_cast<unsigned>(n % 100);
+    n /= 100;
+    p -= 2;
+    std::memcpy(p, kDigitPairs + 2 * r, 2);
+  }
+  if (n >= 10) {
+    p -= 2;
+    std::memcpy(p, kDigitPairs + 2 * n, 2);
+  } else {
+    *--p = static_cast<char>('0' + n);
+  }
+  const size_t len = static_cast<size_t>(tmp + sizeof(tmp) - p);
+  std::memcpy(out, p, len);
+  return len;
+}
+
+// === Per-chunk output ===
+
+struct Sink {
+  Format format;
+  Writer& out;
+  uint64_t survivors = 0;
+
+  // bitmap covers `count` numbers; count is a multiple of 8 except at EOF.
+  // The bitmap buffer is reused, so bits past count are masked off: they
+  // are not this chunk's.
+  void chunk(const uint64_t* numbers, const uint8_t* bitmap, size_t count) {
+    const size_t bytes = (count + 7) / 8;
+    if (format == Format::Bitmap) {
+      if (!bytes) return;
+      const uint8_t last = bitmap[bytes - 1] & uint8_t(0xFFu >> ((8 - count % 8) % 8));
+      out.put(bitmap, bytes - 1);
+      out.put(&last, 1);
+      for (size_t i = 0; i + 1 < bytes; ++i) survivors += __builtin_popcount(bitmap[i]);
+      survivors += __builtin_popcount(last);
+      return;
+    }
+    for (size_t w = 0; w * 8 < bytes; ++w) {
+      uint64_t word = 0;
+      std::memcpy(&word, bitmap + w * 8, std::min<size_t>(8, bytes - w * 8));
+      if (count - w * 64 < 64) word &= (uint64_t(1) << (count - w * 64)) - 1;
+      survivors += __builtin_popcountll(word);
+      if (format == Format::Count) continue;
+      while (word) {
+        const uint64_t v = numbers[w * 64 + __builtin_ctzll(word)];
+        word &= word - 1;
+        if (format == Format::U64) {
+          out.put(&v, sizeof(v));
+        } else {
+          char line[24];
+          out.put(line, format_u64_line(v, line));
+        }
+      }
+    }
+  }
+};
+
+// === Input ===
+
+bool read_full(int fd, uint8_t* p, size_t n, size_t& got) {
+  got = 0;
+  while (got < n) {
+    const ssize_t r = ::read(fd, p + got, n - got);
+    if (r < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    if (r == 0) break;
+    got += static_cast<size_t>(r);
+  }
+  return true;
+}
+
+uint64_t physical_memory() {
+  const long pages = ::sysconf(_SC_PHYS_PAGES);
+  const long page = ::sysconf(_SC_PAGE_SIZE);
+  return pages > 0 && page > 0 ? uint64_t(pages) * uint64_t(page) : 0;
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [-k wheel|barrett16|wheel210|sieve|prime] "
+               "[-o bitmap|u64|count|text] [-c chunk] [-P] [-a] [-Q depth] [-v] "
+               "[input|-] [output|-]\n",
+               argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const KernelEntry* kernel = &kKernels[0];
+  Format format = Format::Bitmap;
+  size_t chunk = size_t(1) << 20;
+  bool populate = true;
+  bool async = false;
+  unsigned depth = 4;
+  bool verbose = false;
+  const char* in_path = "-";
+  const char* out_path = "-";
+
+  int positional = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-k" && i + 1 < argc) {
+      const std::string name = argv[++i];
+      kernel = nullptr;
+      for (const auto& k : kKernels) {
+        if (name == k.name) kernel = &k;
+      }
+      if (!kernel) return usage(argv[0]);
+    } else if (arg == "-o" && i + 1 < argc) {
+      const std::string f = argv[++i];
+      if (f == "bitmap") format = Format::Bitmap;
+      else if (f == "u64") format = Format::U64;
+      else if (f == "count") format = Format::Count;
+      else if (f == "text") format = Format::Text;
+      else return usage(argv[0]);
+    } else if (arg == "-c" && i + 1 < argc) {
+      chunk = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-P") {
+      populate = false;
+    } else if (arg == "-a") {
+      async = true;
+    } else if (arg == "-Q" && i + 1 < argc) {
+      depth = std::max(2ul, std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "-v") {
+      verbose = true;
+    } else if (arg.size() > 1 && arg[0] == '-') {
+      return usage(argv[0]);
+    } else if (positional == 0) {
+      in_path = argv[i];
+      ++positional;
+    } else if (positional == 1) {
+      out_path = argv[i];
+      ++positional;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  // Whole bitmap words per chunk keep every chunk's output byte-aligned.
+  chunk = std::max<size_t>(64, chunk & ~size_t(63));
+
+  const int in_fd = std::strcmp(in_path, "-") == 0 ? STDIN_FILENO : ::open(in_path, O_RDONLY);
+  if (in_fd < 0) {
+    std::fprintf(stderr, "%s: cannot open %s: %s\n", argv[0], in_path, std::strerror(errno));
+    return 2;
+  }
+  const int out_fd = std::strcmp(out_path, "-") == 0
+                         ? STDOUT_FILENO
+                         : ::open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out_fd < 0) {
+    std::fprintf(stderr, "%s: cannot create %s: %s\n", argv[0], out_path, std::strerror(errno));
+    return 2;
+  }
+
+  struct stat st;
+  const bool mappable = ::fstat(in_fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0;
+  const uint64_t in_size = mappable ? static_cast<uint64_t>(st.st_size) : 0;
+  if (mappable && in_size % sizeof(uint64_t)) {
+    std::fprintf(stderr, "%s: input size %llu is not a multiple of 8\n", argv[0],
+                 static_cast<unsigned long long>(in_size));
+    return 2;
+  }
+  // Mapping (and populating) more than fits in RAM only thrashes the page cache.
+  if (mappable && in_size > physical_memory() / 2) async = true;
+
+  neon_io::AsyncOptions io;
+  io.depth = depth;
+  std::optional<neon_io::AsyncWriter> async_out;
+  struct stat ost;
+  if (async && ::fstat(out_fd, &ost) == 0 && S_ISREG(ost.st_mode)) async_out.emplace(out_fd, io);
+
+  Writer out(out_fd, async_out ? &*async_out : nullptr);
+  Sink sink{format, out};
+  std::vector<uint8_t> bitmap(chunk / 8);
+  uint64_t total = 0;
+  const char* input_mode = "read";
+  const auto t0 = std::chrono::steady_clock::now();
+
+  if (mappable && async) {
+    neon_io::AsyncReader reader(in_fd, in_size, io);
+    input_mode = reader.direct() ? "async-direct" : "async";
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    while (reader.next(data, bytes)) {
+      // Buffers are whole pages, so every chunk but the file's last is whole words.
+      const uint64_t* numbers = reinterpret_cast<const uint64_t*>(data);
+      const size_t count = bytes / sizeof(uint64_t);
+      for (size_t base = 0; base < count; base += chunk) {
+        const size_t len = std::min(chunk, count - base);
+        kernel->fn(numbers + base, bitmap.data(), len);
+        sink.chunk(numbers + base, bitmap.data(), len);
+      }
+      total += count;
+    }
+    if (reader.error()) {
+      std::fprintf(stderr, "%s: read failed: %s\n", argv[0], std::strerror(reader.error()));
+      return 2;
+    }
+    if (verbose) {
+      std::fprintf(stderr, "%s: input %s via %s, %u x %zu KiB buffers\n", argv[0], input_mode,
+                   reader.backend_name(), depth, reader.buffer_bytes() >> 10);
+    }
+  } else if (mappable) {
+    const size_t size = static_cast<size_t>(in_size);
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (populate) flags |= MAP_POPULATE;
+#endif
+    void* map = ::mmap(nullptr, size, PROT_READ, flags, in_fd, 0);
+    if (map == MAP_FAILED) {
+      std::fprintf(stderr, "%s: mmap failed: %s\n", argv[0], std::strerror(errno));
+      return 2;
+    }
+    ::madvise(map, size, MADV_SEQUENTIAL);
+    input_mode = "mmap";
+
+    const uint64_t* numbers = static_cast<const uint64_t*>(map);
+    const size_t count = size / sizeof(uint64_t);
+    for (size_t base = 0; base < count; base += chunk) {
+      const size_t len = std::min(chunk, count - base);
+      kernel->fn(numbers + base, bitmap.data(), len);
+      sink.chunk(numbers + base, bitmap.data(), len);
+    }
+    total = count;
+    ::munmap(map, size);
+  } else {
+    std::vector<uint64_t> buf(chunk);
+    for (;;) {
+      size_t got = 0;
+      if (!read_full(in_fd, reinterpret_cast<uint8_t*>(buf.data()), chunk * sizeof(uint64_t), got)) {
+        std::fprintf(stderr, "%s: read failed: %s\n", argv[0], std::strerror(errno));
+        return 2;
+      }
+      if (got % sizeof(uint64_t)) {
+        std::fprintf(stderr, "%s: input ends mid-value\n", argv[0]);
+        return 2;
+      }
+      const size_t len = got / sizeof(uint64_t);
+      if (len == 0) break;
+      kernel->fn(buf.data(), bitmap.data(), len);
+      sink.chunk(buf.data(), bitmap.data(), len);
+      total += len;
+      if (len < chunk) break;
+    }
+  }
+
+  if (format == Format::Count) {
+    char line[24];
+    out.put(line, format_u64_line(sink.survivors, line));
+  }
+  out.flush();
+  if (async_out) async_out->finish();
+  if (!out.ok()) {
+    const int err = async_out && async_out->error() ? async_out->error() : errno;
+    std::fprintf(stderr, "%s: write failed: %s\n", argv[0], std::strerror(err));
+    return 2;
+  }
+
+  if (verbose) {
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::fprintf(stderr, "%s: kernel=%s input=%s output=%s numbers=%llu survivors=%llu "
+                 "%.3f s (%.1f M/s)\n",
+                 argv[0], kernel->name, input_mode,
+                 async_out ? (async_out->direct() ? "async-direct" : "async") : "write",
+                 static_cast<unsigned long long>(total),
+                 static_cast<unsigned long long>(sink.survivors), s, total / s / 1e6);
+  }
+  if (out_fd != STDOUT_FILENO) ::close(out_fd);
+  if (in_fd != STDIN_FILENO) ::close(in_fd);
+  return 0;
+}
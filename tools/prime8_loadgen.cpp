@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-loadgen: closed-loop load generator for prime8d.
+//
+//   prime8-loadgen [-s socket] [-c connections] [-n requests] [-z numbers]
+//                  [-k kernel] [-o bitmap|survivors|count] [-V]
+//
+// Each connection sends -n requests of -z random 32-bit numbers back to back
+// (the next request goes out when the previous response is in) and records
+// the round-trip time of each. Reports p50/p90/p99/p99.9/max latency and the
+// aggregate request and number throughput across all connections. -V checks
+// every survivor count against the local kernels.
+#include "prime8.h"
+#include "prime8_wire.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string path;
+  unsigned connections = 4;
+  size_t requests = 1000;
+  size_t numbers = 1024;
+  int kernel = PRIME8_WHEEL30;
+  uint8_t output = PRIME8_OUT_BITMAP;
+  bool verify = false;
+};
+
+struct Result {
+  std::vector<double> latency_us;
+  bool ok = true;
+  std::string error;
+};
+
+bool read_full(int fd, void* dst, size_t n) {
+  uint8_t* p = static_cast<uint8_t*>(dst);
+  while (n) {
+    const ssize_t r = ::read(fd, p, n);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return false;
+    p += r;
+    n -= static_cast<size_t>(r);
+  }
+  return true;
+}
+
+bool write_full(int fd, const void* src, size_t n) {
+  const uint8_t* p = static_cast<const uint8_t*>(src);
+  while (n) {
+    const ssize_t w = ::write(fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return false;
+    p += w;
+    n -= static_cast<size_t>(w);
+  }
+  return true;
+}
+
+int connect_to(const std::string& path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) return -1;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void client(unsigned id, const Options& o, std::atomic<unsigned>& ready, Result& res) {
+  std::mt19937_64 rng(0x9e3779b97f4a7c15ull * (id + 1));
+  // Header and payload go out in one write so small requests are one packet.
+  std::vector<uint64_t> msg(2 + o.numbers);
+  const prime8_request req{PRIME8_REQUEST_MAGIC, static_cast<uint8_t>(o.kernel), o.output, 0,
+                           o.numbers};
+  std::memcpy(msg.data(), &req, sizeof(req));
+  for (size_t i = 0; i < o.numbers; ++i) msg[2 + i] = rng() & 0xffffffffu;
+  const int64_t expected = o.verify ? prime8_count(o.kernel, msg.data() + 2, o.numbers, 0) : -1;
+  std::vector<uint8_t> payload(o.numbers * sizeof(uint64_t));
+  res.latency_us.reserve(o.requests);
+
+  const int fd = connect_to(o.path);
+  ready.fetch_add(1);
+  while (ready.load() < o.connections) std::this_thread::yield();
+  if (fd < 0) {
+    res.ok = false;
+    res.error = std::string("connect: ") + std::strerror(errno);
+    return;
+  }
+
+  for (size_t r = 0; r < o.requests; ++r) {
+    const auto t0 = Clock::now();
+    prime8_response h;
+    if (!write_full(fd, msg.data(), msg.size() * sizeof(uint64_t)) ||
+        !read_full(fd, &h, sizeof(h)) || h.payload_bytes > payload.size() ||
+        !read_full(fd, payload.data(), h.payload_bytes)) {
+      res.ok = false;
+      res.error = "connection lost";
+      break;
+    }
+    const auto t1 = Clock::now();
+    if (h.magic != PRIME8_RESPONSE_MAGIC || h.status != PRIME8_STATUS_OK) {
+      res.ok = false;
+      res.error = "error status " + std::to_string(h.status);
+      break;
+    }
+    if (expected >= 0 && h.survivors != static_cast<uint64_t>(expected)) {
+      res.ok = false;
+      res.error = "survivor count " + std::to_string(h.survivors) + ", expected " +
+                  std::to_string(expected);
+      break;
+    }
+    res.latency_us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+  ::close(fd);
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  const size_t i = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+  return sorted[i];
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [-s socket] [-c connections] [-n requests] [-z numbers] "
+               "[-k wheel30|wheel210|barrett16|sieve|prime] [-o bitmap|survivors|count] [-V]\n",
+               argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  const char* env = std::getenv("PRIME8_SOCKET");
+  o.path = env ? env : "/tmp/prime8.sock";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-s" && i + 1 < argc) {
+      o.path = argv[++i];
+    } else if (arg == "-c" && i + 1 < argc) {
+      o.connections = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "-n" && i + 1 < argc) {
+      o.requests = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-z" && i + 1 < argc) {
+      o.numbers = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-k" && i + 1 < argc) {
+      const std::string name = argv[++i];
+      o.kernel = -1;
+      for (int k = 0; prime8_kernel_name(k); ++k) {
+        if (name == prime8_kernel_name(k)) o.kernel = k;
+      }
+      if (o.kernel < 0) return usage(argv[0]);
+    } else if (arg == "-o" && i + 1 < argc) {
+      const std::string f = argv[++i];
+      if (f == "bitmap") o.output = PRIME8_OUT_BITMAP;
+      else if (f == "survivors") o.output = PRIME8_OUT_SURVIVORS;
+      else if (f == "count") o.output = PRIME8_OUT_COUNT;
+      else return usage(argv[0]);
+    } else if (arg == "-V") {
+      o.verify = true;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  std::vector<Result> results(o.connections);
+  std::vector<std::thread> threads;
+  std::atomic<unsigned> ready{0};
+  const auto t0 = Clock::now();
+  for (unsigned c = 0; c < o.connections; ++c) {
+    threads.emplace_back(client, c, std::cref(o), std::ref(ready), std::ref(results[c]));
+  }
+  for (auto& t : threads) t.join();
+  const double wall = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  std::vector<double> all;
+  bool ok = true;
+  for (unsigned c = 0; c < o.connections; ++c) {
+    if (!results[c].ok) {
+      std::fprintf(stderr, "connection %u: %s\n", c, results[c].error.c_str());
+      ok = false;
+    }
+    all.insert(all.end(), results[c].latency_us.begin(), results[c].latency_us.end());
+  }
+  std::sort(all.begin(), all.end());
+
+  const double reqs = static_cast<double>(all.size());
+  std::printf("%u connections x %zu requests x %zu numbers (%s)\n", o.connections, o.requests,
+              o.numbers, prime8_kernel_name(o.kernel));
+  std::printf("latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+              percentile(all, 0.50), percentile(all, 0.90), percentile(all, 0.99),
+              percentile(all, 0.999), all.empty() ? 0.0 : all.back());
+  std::printf("throughput: %.0f req/s  %.1f Mnum/s  (%.3f s wall)\n", reqs / wall,
+              reqs * o.numbers / wall / 1e6, wall);
+  return ok ? 0 : 2;
+}
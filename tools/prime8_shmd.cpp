@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-shmd: zero-copy prime-prefilter server for same-host clients.
+//
+//   prime8-shmd [-s socket] [-v]
+//
+// A client (neon_shm::RingClient, src/shm_ring.hpp) connects to the Unix
+// socket once and passes the descriptor of its own shared-memory ring. From
+// then on candidates and result bitmaps stay in that mapping: the client
+// writes numbers straight into the ring, this server filters them in place
+// into the companion bitmap region, and the only traffic is a pair of
+// futex-signalled sequence counters. One server thread per client ring; each
+// request runs on the shared kernel thread pool once it is large.
+//
+// The socket path defaults to $PRIME8_SHM_SOCKET, then /tmp/prime8-shm.sock.
+// SIGINT / SIGTERM stop every ring within ~100 ms and remove the socket.
+#include "shm_ring.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void on_signal(int) { g_stop.store(true); }
+
+struct Conn {
+  int fd;
+  std::thread thread;
+  std::atomic<bool> finished{false};
+};
+
+int usage(const char* argv0) {
+  std::fprintf(stderr, "Usage: %s [-s socket] [-v]\n", argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* env = std::getenv("PRIME8_SHM_SOCKET");
+  std::string path = env ? env : "/tmp/prime8-shm.sock";
+  bool verbose = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-s" && i + 1 < argc) {
+      path = argv[++i];
+    } else if (arg == "-v") {
+      verbose = true;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::fprintf(stderr, "%s: socket path too long\n", argv[0]);
+    return 2;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  const int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::unlink(path.c_str());  // stale socket from a previous run
+  if (lfd < 0 || ::bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(lfd, 128) != 0) {
+    std::fprintf(stderr, "%s: cannot listen on %s: %s\n", argv[0], path.c_str(),
+                 std::strerror(errno));
+    return 2;
+  }
+
+  struct sigaction sa {};
+  sa.sa_handler = on_signal;  // no SA_RESTART: poll() returns EINTR
+  ::sigaction(SIGINT, &sa, nullptr);
+  ::sigaction(SIGTERM, &sa, nullptr);
+  std::signal(SIGPIPE, SIG_IGN);
+
+  if (verbose) std::fprintf(stderr, "%s: listening on %s\n", argv[0], path.c_str());
+
+  std::atomic<uint64_t> requests{0}, rings{0};
+  std::list<Conn> conns;
+  while (!g_stop.load()) {
+    pollfd p{lfd, POLLIN, 0};
+    if (::poll(&p, 1, 250) <= 0) continue;
+    const int fd = ::accept(lfd, nullptr, nullptr);
+    if (fd < 0) continue;
+    conns.remove_if([](Conn& c) {
+      if (!c.finished.load()) return false;
+      c.thread.join();
+      ::close(c.fd);
+      return true;
+    });
+    Conn& c = conns.emplace_back();
+    c.fd = fd;
+    c.thread = std::thread([&c, &requests, &rings, verbose, argv] {
+      const int64_t n = neon_shm::serve_ring(c.fd, g_stop);
+      if (n >= 0) {
+        requests.fetch_add(static_cast<uint64_t>(n));
+        rings.fetch_add(1);
+      }
+      if (verbose) {
+        if (n < 0) std::fprintf(stderr, "%s: rejected a client ring\n", argv[0]);
+        else std::fprintf(stderr, "%s: ring closed after %lld requests\n", argv[0],
+                          static_cast<long long>(n));
+      }
+      c.finished.store(true);
+    });
+  }
+  // Rings notice g_stop on their next wake; shutdown() also frees any thread
+  // still waiting for a client's descriptor.
+  for (Conn& c : conns) ::shutdown(c.fd, SHUT_RDWR);
+  for (Conn& c : conns) {
+    c.thread.join();
+    ::close(c.fd);
+  }
+  std::fprintf(stderr, "%s: %llu requests over %llu rings\n", argv[0],
+               static_cast<unsigned long long>(requests.load()),
+               static_cast<unsigned long long>(rings.load()));
+  ::close(lfd);
+  ::unlink(path.c_str());
+  return 0;
+}
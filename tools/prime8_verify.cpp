@@ -0,0 +1,371 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8-verify: exhaustive differential check of every registered kernel
+// (bench/harness.cpp) over all 2^32 u32 inputs, plus a 64-bit edge set.
+//
+//   prime8-verify [-k kernels] [-r lo:hi] [-t threads] [-m max_reported]
+//                 [--no-reference] [--no-edges]
+//
+//   -k   kernel or group names, as for prime8_bench (default: all)
+//   -r   u32 range to sweep (default 0:2^32); sizes as for prime8_bench -n
+//   -t   pool threads (default: $PRIME8_THREADS or all hardware threads)
+//   -m   mismatches listed per kernel (default 8)
+//   --no-reference  skip the check of the scalar references against the sieve
+//   --no-edges      skip the 64-bit edge set
+//
+// The range is cut into 2^20-number chunks run on the shared pool. For each
+// chunk a segmented sieve gives the truth: the smallest of 2..53 dividing
+// each n other than n itself (a filter kernel keeps n iff none of its first
+// `depth` primes does) and exact primality (for fused kernels). Each kernel's
+// scalar reference is checked against the same table, so a bug in either
+// shows up. The edge set (values around 2^32 and powers of two, prime
+// squares, pseudoprimes, large primes) has no sieve; it is checked against
+// the scalar references from every start offset 0..15, so each value lands
+// in every lane and every tail position.
+//
+// Outputs start out all ones, so a kernel must write every byte it owns:
+// byte kernels each flag, bitmap kernels every bit up to the count and zero
+// padding bits in the last byte.
+//
+// Prints the smallest mismatching values per kernel. Exit status 0 if
+// everything matches, 1 on any mismatch, 2 on usage errors.
+#include "harness.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace prime8_bench;
+
+namespace {
+
+constexpr size_t kChunk = size_t(1) << 20;
+constexpr uint64_t kU32End = uint64_t(1) << 32;
+constexpr uint32_t kFilterPrimes[16] = {2,  3,  5,  7,  11, 13, 17, 19,
+                                        23, 29, 31, 37, 41, 43, 47, 53};
+constexpr uint8_t kNoFactor = 16;
+
+struct Mismatch {
+  uint64_t value;
+  const char* what;  // "kept", "dropped", or "padding": bits set past the count
+};
+
+// Mismatch count plus the smallest `keep` values, merged from every chunk.
+class Report {
+public:
+  void merge(uint64_t count, std::vector<Mismatch>& local, size_t keep) {
+    if (!count) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ += count;
+    first_.insert(first_.end(), local.begin(), local.end());
+    trim(keep);
+  }
+  void trim(size_t keep) {
+    std::sort(first_.begin(), first_.end(),
+              [](const Mismatch& a, const Mismatch& b) { return a.value < b.value; });
+    if (first_.size() > keep) first_.resize(keep);
+  }
+  uint64_t count() const { return count_; }
+  const std::vector<Mismatch>& first() const { return first_; }
+
+private:
+  std::mutex mutex_;
+  uint64_t count_ = 0;
+  std::vector<Mismatch> first_;
+};
+
+// === Truth tables ===
+
+const std::vector<uint32_t>& base_primes() {  // every prime below 2^16
+  static const std::vector<uint32_t> primes = [] {
+    std::vector<uint8_t> composite(1 << 16, 0);
+    std::vector<uint32_t> out;
+    for (uint32_t i = 2; i < (1u << 16); ++i) {
+      if (composite[i]) continue;
+      out.push_back(i);
+      for (uint32_t j = i * i; j < (1u << 16); j += i) composite[j] = 1;
+    }
+    return out;
+  }();
+  return primes;
+}
+
+uint64_t first_multiple(uint64_t lo, uint64_t p) { return (lo + p - 1) / p * p; }
+
+// smallest[i]: index into kFilterPrimes of the smallest prime dividing lo + i
+// other than lo + i itself, kNoFactor if none. prime[i]: lo + i is prime.
+void sieve_chunk(uint64_t lo, size_t n, uint8_t* smallest, uint8_t* prime) {
+  const uint64_t hi = lo + n;
+  std::memset(smallest, kNoFactor, n);
+  for (int idx = 15; idx >= 0; --idx) {  // descending, so the smallest index wins
+    const uint64_t p = kFilterPrimes[idx];
+    for (uint64_t m = first_multiple(lo, p); m < hi; m += p) {
+      if (m != p) smallest[m - lo] = static_cast<uint8_t>(idx);
+    }
+  }
+  std::memset(prime, 1, n);
+  for (uint64_t v = lo; v < 2 && v < hi; ++v) prime[v - lo] = 0;
+  for (uint32_t p : base_primes()) {
+    const uint64_t p2 = uint64_t(p) * p;
+    if (p2 >= hi) break;
+    for (uint64_t m = std::max(p2, first_multiple(lo, p)); m < hi; m += p) prime[m - lo] = 0;
+  }
+}
+
+bool truth(int depth, const uint8_t* smallest, const uint8_t* prime, size_t i) {
+  return depth ? smallest[i] >= depth : prime[i] != 0;
+}
+
+// === Edge set ===
+
+std::vector<uint64_t> edge_values() {
+  std::vector<uint64_t> v;
+  for (uint64_t x = 0; x <= 64; ++x) v.push_back(x);
+  for (uint64_t x = kU32End - 64; x <= kU32End + 64; ++x) v.push_back(x);
+  for (int k = 33; k < 64; ++k) {
+    const uint64_t p2 = uint64_t(1) << k;
+    v.insert(v.end(), {p2 - 1, p2, p2 + 1});
+  }
+  for (uint32_t p : kFilterPrimes) {
+    v.push_back(kU32End | p);                 // low word prime, high word set
+    v.push_back(uint64_t(p) * p);             // squares of the filter primes
+  }
+  const uint64_t extra[] = {
+    ~0ull, 0xffffffffffffffc5ull,             // 2^64 - 1, largest 64-bit prime
+    (uint64_t(1) << 61) - 1,                  // Mersenne prime
+    59ull * 59, 61ull * 67, 53ull * 59,       // smallest composites past the filter
+    65521ull * 65521, 65521ull * 65519,       // no factor below 2^16, below 2^32
+    4294967291ull, 4294967279ull,             // largest u32 primes
+    4294967291ull * 4294967291ull,            // their square, above 2^32
+    561, 1105, 1729, 2465, 2821, 6601, 8911, 41041, 825265, 321197185,  // Carmichael
+    2047, 1373653, 25326001, 3215031751ull,   // strong pseudoprimes to small bases
+    2152302898747ull, 3474749660383ull, 341550071728321ull, 3825123056546413051ull,
+  };
+  v.insert(v.end(), std::begin(extra), std::end(extra));
+  return v;
+}
+
+// === Sweep ===
+
+struct Config {
+  std::string kernels = "all";
+  uint64_t lo = 0;
+  uint64_t hi = kU32End;
+  unsigned threads = 0;
+  size_t keep = 8;
+  bool reference = true;
+  bool edges = true;
+};
+
+// One scalar reference to cross-check against the sieve: the first kernel
+// that uses it names it in the report.
+struct Reference {
+  bool (*expect)(uint64_t);
+  int depth;
+  const Kernel* owner;
+  Report report;
+};
+
+// A bitmap's last byte belongs to the kernel: bits past n must come out zero.
+bool padding_set(const Kernel& k, const uint8_t* out, size_t n) {
+  return k.output == Output::Bitmap && (n & 7) && (out[n / 8] >> (n & 7));
+}
+
+void check_kernel(const Kernel& k, const uint64_t* numbers, uint8_t* out, size_t n,
+                  const uint8_t* smallest, const uint8_t* prime, size_t keep, Report& report) {
+  std::memset(out, 0xFF, k.output == Output::Bitmap ? (n + 7) / 8 : n);
+  k.fn(numbers, out, n);
+  uint64_t bad = 0;
+  std::vector<Mismatch> local;
+  for (size_t i = 0; i < n; ++i) {
+    const bool got = survives(k, out, i);
+    if (got == truth(k.depth, smallest, prime, i)) continue;
+    if (bad++ < keep) local.push_back({numbers[i], got ? "kept" : "dropped"});
+  }
+  if (padding_set(k, out, n) && bad++ < keep) local.push_back({numbers[n - 1], "padding"});
+  report.merge(bad, local, keep);
+}
+
+void check_reference(Reference& r, uint64_t lo, size_t n, const uint8_t* smallest,
+                     const uint8_t* prime, size_t keep) {
+  uint64_t bad = 0;
+  std::vector<Mismatch> local;
+  for (size_t i = 0; i < n; ++i) {
+    const bool got = r.expect(lo + i);
+    if (got == truth(r.depth, smallest, prime, i)) continue;
+    if (bad++ < keep) local.push_back({lo + i, got ? "kept" : "dropped"});
+  }
+  r.report.merge(bad, local, keep);
+}
+
+// Returns the number of values checked.
+uint64_t check_edges(const Kernel& k, const std::vector<uint64_t>& edges, size_t keep,
+                     Report& report) {
+  std::vector<uint8_t> out(edges.size() + 64);
+  uint64_t bad = 0, checked = 0;
+  std::vector<Mismatch> local;
+  for (size_t off = 0; off < 16 && off < edges.size(); ++off) {
+    const size_t n = edges.size() - off;
+    checked += n;
+    std::fill(out.begin(), out.end(), 0xFF);
+    k.fn(edges.data() + off, out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const bool got = survives(k, out.data(), i);
+      if (got == k.expect(edges[off + i])) continue;
+      if (bad++ < keep) local.push_back({edges[off + i], got ? "kept" : "dropped"});
+    }
+    if (padding_set(k, out.data(), n) && bad++ < keep) {
+      local.push_back({edges.back(), "padding"});
+    }
+  }
+  report.merge(bad, local, keep);
+  return checked;
+}
+
+void print_report(const char* label, const char* what, uint64_t checked, Report& r,
+                  size_t keep) {
+  r.trim(keep);
+  std::printf("%-20s %-12s %12llu %12llu", label, what, static_cast<unsigned long long>(checked),
+              static_cast<unsigned long long>(r.count()));
+  for (const Mismatch& m : r.first()) {
+    std::printf(" %llu(%s)", static_cast<unsigned long long>(m.value), m.what);
+  }
+  std::printf("\n");
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr,
+               "Usage: %s [-k kernels] [-r lo:hi] [-t threads] [-m max_reported] "
+               "[--no-reference] [--no-edges]\n",
+               argv0);
+  return 2;
+}
+
+bool parse_bound(const std::string& s, uint64_t& out) {
+  if (s == "0") {
+    out = 0;
+    return true;
+  }
+  out = parse_size(s);
+  return out != 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = i + 1 < argc;
+    if (arg == "-k" && has_value) {
+      cfg.kernels = argv[++i];
+    } else if (arg == "-r" && has_value) {
+      const std::string r = argv[++i];
+      const size_t colon = r.find(':');
+      if (colon == std::string::npos || !parse_bound(r.substr(0, colon), cfg.lo) ||
+          !parse_bound(r.substr(colon + 1), cfg.hi) || cfg.hi > kU32End || cfg.lo > cfg.hi) {
+        return usage(argv[0]);
+      }
+    } else if (arg == "-t" && has_value) {
+      cfg.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (arg == "-m" && has_value) {
+      cfg.keep = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--no-reference") {
+      cfg.reference = false;
+    } else if (arg == "--no-edges") {
+      cfg.edges = false;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+  if (cfg.threads) neon_parallel::set_thread_count(cfg.threads);
+
+  std::string unknown;
+  const std::vector<const Kernel*> ks = select_kernels(cfg.kernels, unknown);
+  if (!unknown.empty()) {
+    std::fprintf(stderr, "%s: unknown kernel %s\n", argv[0], unknown.c_str());
+    return 2;
+  }
+  std::vector<Report> reports(ks.size()), edge_reports(ks.size());
+  std::deque<Reference> refs;  // Report holds a mutex; a deque never moves it
+  if (cfg.reference) {
+    for (const Kernel* k : ks) {
+      const bool seen = std::any_of(refs.begin(), refs.end(),
+                                    [&](const Reference& r) { return r.expect == k->expect; });
+      if (seen) continue;
+      Reference& r = refs.emplace_back();
+      r.expect = k->expect;
+      r.depth = k->depth;
+      r.owner = k;
+    }
+  }
+
+  const uint64_t span = cfg.hi - cfg.lo;
+  const size_t chunks = static_cast<size_t>((span + kChunk - 1) / kChunk);
+  neon_parallel::WorkStealingPool& pool = neon_parallel::default_pool();
+  std::fprintf(stderr, "prime8-verify: %zu kernels over [%llu, %llu) in %zu chunks on %u threads\n",
+               ks.size(), static_cast<unsigned long long>(cfg.lo),
+               static_cast<unsigned long long>(cfg.hi), chunks, pool.size());
+  base_primes();  // built once, before the workers need it
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::atomic<size_t> done{0};
+  pool.parallel_for(chunks, [&](size_t c) {
+    thread_local std::vector<uint64_t> numbers(kChunk);
+    thread_local std::vector<uint8_t> out(kChunk + 64), smallest(kChunk), prime(kChunk);
+    const uint64_t lo = cfg.lo + uint64_t(c) * kChunk;
+    const size_t n = static_cast<size_t>(std::min<uint64_t>(kChunk, cfg.hi - lo));
+    for (size_t i = 0; i < n; ++i) numbers[i] = lo + i;
+    sieve_chunk(lo, n, smallest.data(), prime.data());
+    for (size_t j = 0; j < ks.size(); ++j) {
+      check_kernel(*ks[j], numbers.data(), out.data(), n, smallest.data(), prime.data(),
+                   cfg.keep, reports[j]);
+    }
+    for (Reference& r : refs) check_reference(r, lo, n, smallest.data(), prime.data(), cfg.keep);
+
+    const size_t d = ++done;
+    if (d * 20 / chunks != (d - 1) * 20 / chunks) {
+      std::fprintf(stderr, "\r%3zu%%", d * 100 / chunks);
+      if (d == chunks) std::fprintf(stderr, "\n");
+    }
+  });
+  const double secs =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::vector<uint64_t> edge_checked(ks.size(), 0);
+  if (cfg.edges) {
+    const std::vector<uint64_t> edges = edge_values();
+    for (size_t j = 0; j < ks.size(); ++j) {
+      edge_checked[j] = check_edges(*ks[j], edges, cfg.keep, edge_reports[j]);
+    }
+  }
+
+  std::printf("%-20s %-12s %12s %12s  first mismatches (value, kernel verdict)\n", "kernel",
+              "against", "checked", "mismatches");
+  bool ok = true;
+  for (size_t j = 0; j < ks.size(); ++j) {
+    print_report(ks[j]->name, ks[j]->depth ? "sieve" : "prime sieve", span, reports[j], cfg.keep);
+    if (cfg.edges) {
+      print_report(ks[j]->name, "edges", edge_checked[j], edge_reports[j], cfg.keep);
+    }
+    ok = ok && reports[j].count() == 0 && edge_reports[j].count() == 0;
+  }
+  for (Reference& r : refs) {
+    const std::string label = std::string("ref(") + r.owner->name + ")";
+    print_report(label.c_str(), r.depth ? "sieve" : "prime sieve", span, r.report, cfg.keep);
+    ok = ok && r.report.count() == 0;
+  }
+  std::printf("%s: %.1f s, %.0f M numbers/s per kernel\n", ok ? "OK" : "MISMATCH", secs,
+              secs > 0 ? span * double(ks.size()) / secs / 1e6 : 0.0);
+  return ok ? 0 : 1;
+}
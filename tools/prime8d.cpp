@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (c) 2025 Justin Guida
+//
+// prime8d: shared prime-prefilter service on a Unix-domain socket.
+//
+//   prime8d [-s socket] [-w window_us] [-b batch_numbers] [-v]
+//
+// Clients speak the prime8_wire.h framing (the same as bench/hybrid_driver)
+// over a stream socket, any number of requests per connection. One thread per
+// connection reads requests; a single batcher thread coalesces whatever is
+// queued into one large buffer per kernel, waiting at most `window_us` after
+// the oldest queued request, until `batch_numbers` have arrived, or until
+// every connected client has a request queued, whichever is first. It runs
+// one kernel call (on the shared thread pool once the batch is large) and
+// hands every request its slice of the bitmap. Processes therefore share one
+// set of kernel threads instead of each spinning up their own.
+//
+// The socket path defaults to $PRIME8_SOCKET, then /tmp/prime8.sock. SIGINT /
+// SIGTERM drain in-flight requests, print batching stats and remove the socket.
+#include "prime8.h"
+#include "prime8_wire.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<bool> g_stop{false};
+
+void on_signal(int) { g_stop.store(true); }
+
+// Batches at least this large use the pool (several kParallelChunks each).
+constexpr size_t kParallelMin = size_t(1) << 17;
+
+// Scratch buffers are reused across requests but released once a request has
+// grown them past this, so one maximum-size request (2^26 numbers, 512 MiB)
+// does not pin its buffers for the rest of the connection.
+constexpr size_t kKeepBytes = size_t(16) << 20;
+
+template <class T>
+void trim(std::vector<T>& v) {
+  if (v.capacity() * sizeof(T) > kKeepBytes) std::vector<T>().swap(v);
+}
+
+// === Batcher ===
+
+struct Job {
+  uint8_t mode;
+  const uint64_t* numbers;
+  size_t count;
+  uint8_t* bitmap;  // (count + 7) / 8 bytes, written by the batcher
+  Clock::time_point arrival;
+  bool done = false;
+  int rc = PRIME8_OK;  // prime8_filter_bitmap result; bitmap is undefined otherwise
+};
+
+class Batcher {
+public:
+  Batcher(size_t target, std::chrono::microseconds window)
+      : target_(target), window_(window), thread_([this] { loop(); }) {}
+
+  ~Batcher() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  // Queues job and blocks until its bitmap is filled.
+  void run(Job& job) {
+    std::unique_lock<std::mutex> lk(mu_);
+    job.arrival = Clock::now();
+    queue_.push_back(&job);
+    queued_ += job.count;
+    cv_.notify_all();
+    done_cv_.wait(lk, [&] { return job.done; });
+  }
+
+  // Connected clients. Each has at most one request in flight, so once all of
+  // them are queued nothing else can join the batch and waiting is pointless.
+  void attach() {
+    std::lock_guard<std::mutex> lk(mu_);
+    ++clients_;
+  }
+  void detach() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      --clients_;
+    }
+    cv_.notify_all();
+  }
+
+  uint64_t batches() const { return batches_; }
+  uint64_t jobs() const { return jobs_; }
+  uint64_t numbers() const { return numbers_; }
+
+private:
+  void loop() {
+    std::unique_lock<std::mutex> lk(mu_);
+    for (;;) {
+      cv_.wait(lk, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      // Bounded latency: the oldest request waits at most window_.
+      const auto deadline = queue_.front()->arrival + window_;
+      while (!stop_ && queued_ < target_ && queue_.size() < clients_) {
+        if (cv_.wait_until(lk, deadline) == std::cv_status::timeout) break;
+      }
+      std::vector<Job*> jobs(queue_.begin(), queue_.end());
+      queue_.clear();
+      queued_ = 0;
+      lk.unlock();
+
+      process(jobs);
+
+      lk.lock();
+      for (Job* j : jobs) j->done = true;
+      done_cv_.notify_all();
+    }
+  }
+
+  // One kernel call per mode. Each job starts on a 64-number boundary of the
+  // batch, so its bitmap slice is whole bytes; the gap is zero-filled (0
+  // never survives) so slices carry no stray bits. A failed call fails every
+  // job in its group.
+  void process(std::vector<Job*>& jobs) {
+    std::stable_sort(jobs.begin(), jobs.end(),
+                     [](const Job* a, const Job* b) { return a->mode < b->mode; });
+    for (size_t g = 0; g < jobs.size();) {
+      size_t end = g;
+      size_t total = 0;
+      while (end < jobs.size() && jobs[end]->mode == jobs[g]->mode) {
+        total += (jobs[end]->count + 63) & ~size_t(63);
+        ++end;
+      }
+      const uint8_t mode = jobs[g]->mode;
+      const unsigned flags = total >= kParallelMin ? PRIME8_PARALLEL : 0;
+
+      if (end - g == 1) {
+        Job* j = jobs[g];
+        j->rc = prime8_filter_bitmap(mode, j->numbers, j->count, j->bitmap, flags);
+      } else {
+        int rc = PRIME8_OK;
+        try {
+          if (batch_.size() < total) batch_.resize(total);
+          if (bitmap_.size() < total / 8) bitmap_.resize(total / 8);
+        } catch (const std::bad_alloc&) {
+          rc = PRIME8_ENOMEM;  // fail this group, keep the daemon up
+        }
+        size_t off = 0;
+        if (rc == PRIME8_OK) {
+          for (size_t k = g; k < end; ++k) {
+            const Job* j = jobs[k];
+            const size_t padded = (j->count + 63) & ~size_t(63);
+            std::memcpy(batch_.data() + off, j->numbers, j->count * sizeof(uint64_t));
+            std::fill(batch_.data() + off + j->count, batch_.data() + off + padded, 0);
+            off += padded;
+          }
+          rc = prime8_filter_bitmap(mode, batch_.data(), total, bitmap_.data(), flags);
+        }
+        off = 0;
+        for (size_t k = g; k < end; ++k) {
+          Job* j = jobs[k];
+          j->rc = rc;
+          if (rc == PRIME8_OK) {
+            std::memcpy(j->bitmap, bitmap_.data() + off / 8, (j->count + 7) / 8);
+          }
+          off += (j->count + 63) & ~size_t(63);
+        }
+      }
+      batches_ += 1;
+      jobs_ += end - g;
+      numbers_ += total;
+      g = end;
+    }
+    trim(batch_);
+    trim(bitmap_);
+  }
+
+  const size_t target_;
+  const std::chrono::microseconds window_;
+  std::mutex mu_;
+  std::condition_variable cv_;       // new jobs / stop
+  std::condition_variable done_cv_;  // batch finished
+  std::deque<Job*> queue_;
+  size_t queued_ = 0;
+  size_t clients_ = 0;
+  bool stop_ = false;
+  std::vector<uint64_t> batch_;
+  std::vector<uint8_t> bitmap_;
+  uint64_t batches_ = 0, jobs_ = 0, numbers_ = 0;  // batcher thread only
+  std::thread thread_;
+};
+
+// === Connections ===
+
+size_t read_full(int fd, void* dst, size_t n) {
+  uint8_t* p = static_cast<uint8_t*>(dst);
+  size_t got = 0;
+  while (got < n) {
+    const ssize_t r = ::read(fd, p + got, n - got);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) break;
+    got += static_cast<size_t>(r);
+  }
+  return got;
+}
+
+bool write_full(int fd, const void* src, size_t n) {
+  const uint8_t* p = static_cast<const uint8_t*>(src);
+  while (n) {
+    const ssize_t w = ::write(fd, p, n);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return false;
+    p += w;
+    n -= static_cast<size_t>(w);
+  }
+  return true;
+}
+
+bool respond(int fd, uint32_t status, uint64_t survivors, const void* payload, uint64_t bytes) {
+  const prime8_response h{PRIME8_RESPONSE_MAGIC, status, survivors, bytes};
+  return write_full(fd, &h, sizeof(h)) && write_full(fd, payload, bytes);
+}
+
+struct Conn {
+  int fd;
+  std::thread thread;
+  std::atomic<bool> finished{false};
+};
+
+void serve(Conn& c, Batcher& batcher, std::atomic<uint64_t>& requests) {
+  batcher.attach();
+  std::vector<uint64_t> numbers;
+  std::vector<uint8_t> bitmap;
+  std::vector<uint64_t> survivors;
+  for (;;) {
+    prime8_request req;
+    if (read_full(c.fd, &req, sizeof(req)) != sizeof(req)) break;
+    if (req.magic != PRIME8_REQUEST_MAGIC) {
+      respond(c.fd, PRIME8_STATUS_BAD_MAGIC, 0, nullptr, 0);
+      break;
+    }
+    if (req.count > PRIME8_MAX_COUNT) {
+      // Unread payload: the stream cannot be resynchronized.
+      respond(c.fd, PRIME8_STATUS_TOO_LARGE, 0, nullptr, 0);
+      break;
+    }
+    const size_t count = static_cast<size_t>(req.count);
+    if (numbers.size() < count) numbers.resize(count);
+    if (read_full(c.fd, numbers.data(), count * sizeof(uint64_t)) != count * sizeof(uint64_t)) {
+      break;
+    }
+    const bool known = prime8_kernel_name(req.mode) != nullptr;
+    if (!known || req.output > PRIME8_OUT_COUNT) {
+      const uint32_t status = known ? PRIME8_STATUS_BAD_OUTPUT : PRIME8_STATUS_BAD_MODE;
+      if (!respond(c.fd, status, 0, nullptr, 0)) break;
+      continue;
+    }
+
+    const size_t bytes = (count + 7) / 8;
+    if (bitmap.size() < bytes) bitmap.resize(bytes);
+    int rc = PRIME8_OK;
+    if (count) {
+      // The bitmap is reused across requests; a fresh last byte keeps the
+      // padding bits past count from leaking into nsurv and the survivors.
+      bitmap[bytes - 1] = 0;
+      Job job{req.mode, numbers.data(), count, bitmap.data(), {}};
+      batcher.run(job);
+      rc = job.rc;
+    }
+    requests.fetch_add(1, std::memory_order_relaxed);
+    if (rc != PRIME8_OK) {
+      if (!respond(c.fd, PRIME8_STATUS_FAILED, 0, nullptr, 0)) break;
+      continue;
+    }
+
+    uint64_t nsurv = 0;
+    for (size_t i = 0; i < bytes; ++i) nsurv += __builtin_popcount(bitmap[i]);
+    bool ok;
+    if (req.output == PRIME8_OUT_BITMAP) {
+      ok = respond(c.fd, PRIME8_STATUS_OK, nsurv, bitmap.data(), bytes);
+    } else if (req.output == PRIME8_OUT_COUNT) {
+      ok = respond(c.fd, PRIME8_STATUS_OK, nsurv, nullptr, 0);
+    } else {
+      if (survivors.size() < nsurv) survivors.resize(nsurv);
+      size_t k = 0;
+      for (size_t w = 0; w * 8 < bytes; ++w) {
+        uint64_t word = 0;
+        std::memcpy(&word, bitmap.data() + w * 8, std::min<size_t>(8, bytes - w * 8));
+        while (word) {
+          survivors[k++] = numbers[w * 64 + __builtin_ctzll(word)];
+          word &= word - 1;
+        }
+      }
+      ok = respond(c.fd, PRIME8_STATUS_OK, nsurv, survivors.data(), nsurv * sizeof(uint64_t));
+    }
+    if (!ok) break;
+    trim(numbers);
+    trim(bitmap);
+    trim(survivors);
+  }
+  batcher.detach();
+  c.finished.store(true);
+}
+
+int usage(const char* argv0) {
+  std::fprintf(stderr, "Usage: %s [-s socket] [-w window_us] [-b batch_numbers] [-v]\n", argv0);
+  return 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* env = std::getenv("PRIME8_SOCKET");
+  std::string path = env ? env : "/tmp/prime8.sock";
+  long window_us = 200;
+  size_t target = size_t(1) << 16;
+  bool verbose = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-s" && i + 1 < argc) {
+      path = argv[++i];
+    } else if (arg == "-w" && i + 1 < argc) {
+      window_us = std::strtol(argv[++i], nullptr, 10);
+    } else if (arg == "-b" && i + 1 < argc) {
+      target = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "-v") {
+      verbose = true;
+    } else {
+      return usage(argv[0]);
+    }
+  }
+
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::fprintf(stderr, "%s: socket path too long\n", argv[0]);
+    return 2;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  const int lfd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  ::unlink(path.c_str());  // stale socket from a previous run
+  if (lfd < 0 || ::bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      ::listen(lfd, 128) != 0) {
+    std::fprintf(stderr, "%s: cannot listen on %s: %s\n", argv[0], path.c_str(),
+                 std::strerror(errno));
+    return 2;
+  }
+
+  struct sigaction sa {};
+  sa.sa_handler = on_signal;  // no SA_RESTART: poll() returns EINTR
+  ::sigaction(SIGINT, &sa, nullptr);
+  ::sigaction(SIGTERM, &sa, nullptr);
+  std::signal(SIGPIPE, SIG_IGN);  // a vanished client fails its write instead
+
+  if (verbose) {
+    std::fprintf(stderr, "%s: listening on %s (window %ld us, batch %zu)\n", argv[0],
+                 path.c_str(), window_us, target);
+  }
+
+  std::atomic<uint64_t> requests{0};
+  std::list<Conn> conns;
+  {
+    Batcher batcher(target, std::chrono::microseconds(window_us));
+    while (!g_stop.load()) {
+      pollfd p{lfd, POLLIN, 0};
+      if (::poll(&p, 1, 250) <= 0) continue;
+      const int fd = ::accept(lfd, nullptr, nullptr);
+      if (fd < 0) continue;
+      conns.remove_if([](Conn& c) {
+        if (!c.finished.load()) return false;
+        c.thread.join();
+        ::close(c.fd);
+        return true;
+      });
+      Conn& c = conns.emplace_back();
+      c.fd = fd;
+      c.thread = std::thread([&c, &batcher, &requests] { serve(c, batcher, requests); });
+    }
+    // Wake every connection blocked in read() but leave the write side open:
+    // requests already queued in the batcher complete and their replies go out
+    // before the connection threads finish and the sockets are closed.
+    for (Conn& c : conns) ::shutdown(c.fd, SHUT_RD);
+    for (Conn& c : conns) {
+      c.thread.join();
+      ::close(c.fd);
+    }
+
+    std::fprintf(stderr,
+                 "%s: %llu requests in %llu batches (%.1f requests, %.0f numbers per batch)\n",
+                 argv[0], static_cast<unsigned long long>(requests.load()),
+                 static_cast<unsigned long long>(batcher.batches()),
+                 batcher.batches() ? double(batcher.jobs()) / batcher.batches() : 0.0,
+                 batcher.batches() ? double(batcher.numbers()) / batcher.batches() : 0.0);
+  }
+  ::close(lfd);
+  ::unlink(path.c_str());
+  return 0;
+}